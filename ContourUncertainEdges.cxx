@@ -0,0 +1,127 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "ContourUncertainEdges.h"
+
+#include <vtkm/CellShape.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleGroupVec.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+
+#include "ucvworklet/EdgeCrossing.hpp"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+ContourUncertainEdges::ContourUncertainEdges()
+{
+  this->SetCrossingProbabilityName("crossing_probability");
+}
+
+vtkm::cont::DataSet ContourUncertainEdges::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field field0 = this->GetFieldFromDataSet(0, input);
+  vtkm::cont::Field field1 = this->GetFieldFromDataSet(1, input);
+
+  vtkm::Id3 pointDims;
+  if (input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    vtkm::cont::CellSetStructured<3> cellSet;
+    input.GetCellSet().AsCellSet(cellSet);
+    pointDims = cellSet.GetPointDimensions();
+  }
+  else if (input.GetCellSet().IsType<vtkm::cont::CellSetStructured<2>>())
+  {
+    vtkm::cont::CellSetStructured<2> cellSet;
+    input.GetCellSet().AsCellSet(cellSet);
+    vtkm::Id2 dims = cellSet.GetPointDimensions();
+    pointDims = vtkm::Id3(dims[0], dims[1], 1);
+  }
+  else
+  {
+    throw vtkm::cont::ErrorBadType(
+      "Uncertain edge crossing only works for CellSetStructured<2> and CellSetStructured<3>.");
+  }
+
+  StructuredEdgeIndexing indexing(pointDims);
+  vtkm::Id numEdges = indexing.GetNumberOfEdges();
+  auto coords = input.GetCoordinateSystem().GetDataAsMultiplexer();
+
+  vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+  vtkm::cont::UnknownArrayHandle crossProbability;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> crossPosition;
+
+  auto resolveType = [&](auto concreteField0) {
+    using ArrayType = std::decay_t<decltype(concreteField0)>;
+    using ValueType = typename ArrayType::ValueType;
+    ArrayType concreteField1;
+    vtkm::cont::ArrayCopyShallowIfPossible(field1.GetData(), concreteField1);
+
+    vtkm::cont::ArrayHandle<ValueType> concreteCrossProb;
+    if (this->Distribution == DistributionType::Uniform)
+    {
+      this->Invoke(EdgeCrossingStructured<UniformEdgeModel>{ pointDims, this->IsoValue },
+                   vtkm::cont::ArrayHandleIndex(numEdges),
+                   concreteField0,
+                   concreteField1,
+                   coords,
+                   vtkm::cont::make_ArrayHandleGroupVec<2>(connectivity),
+                   concreteCrossProb,
+                   crossPosition);
+    }
+    else
+    {
+      this->Invoke(
+        EdgeCrossingStructured<IndependentGaussianEdgeModel>{ pointDims, this->IsoValue },
+        vtkm::cont::ArrayHandleIndex(numEdges),
+        concreteField0,
+        concreteField1,
+        coords,
+        vtkm::cont::make_ArrayHandleGroupVec<2>(connectivity),
+        concreteCrossProb,
+        crossPosition);
+    }
+
+    this->Instrumentation.AddBytes(
+      "output", numEdges * (sizeof(ValueType) + sizeof(vtkm::Vec3f) + 2 * sizeof(vtkm::Id)));
+    crossProbability = concreteCrossProb;
+  };
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "edges");
+    this->CastAndCallScalarField(field0, resolveType);
+  }
+  this->Instrumentation.AddCount("edges_processed", numEdges);
+
+  vtkm::cont::CellSetSingleType<> edgeCellSet;
+  edgeCellSet.Fill(input.GetNumberOfPoints(), vtkm::CELL_SHAPE_LINE, 2, connectivity);
+
+  // The point fields are still valid on the edges, the cell fields are not.
+  auto mapper = [](auto& outDataSet, const auto& field) {
+    if (!field.IsCellField())
+    {
+      outDataSet.AddField(field);
+    }
+  };
+  vtkm::cont::DataSet result = this->CreateResult(input, edgeCellSet, mapper);
+  result.AddCellField(this->GetCrossingProbabilityName(), crossProbability);
+  result.AddCellField(this->CrossingPositionName, crossPosition);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
@@ -0,0 +1,142 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_ContourUncertainEdges_h
+#define vtk_m_filter_uncertainty_ContourUncertainEdges_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Computes the probability of a contour crossing each edge of a structured grid.
+///
+/// The cross probability of a cell (see `ContourUncertainUniform`) tells whether the
+/// contour is in the cell, but the geometry of the contour is driven by the edges it
+/// crosses. This filter computes, for each unique edge of the grid, the probability that
+/// the contour crosses it and the expected position of the crossing. Each interior edge
+/// is shared by 4 hexahedra, it is computed only once here. The edges are enumerated
+/// implicitly from the point dimensions, so no sorting or keys are needed.
+///
+/// The output has one line cell per edge with the two cell fields `crossing_probability`
+/// and `crossing_position` (the expected crossing point, on the edge). The edge of id `e`
+/// is described by `StructuredEdgeIndexing` in `ucvworklet/EdgeCrossing.hpp`: the edges
+/// along x come first, then y and then z.
+///
+/// The points are assumed to be independent and the field of each point is modeled with
+/// either a uniform distribution (min and max fields) or a gaussian distribution (mean and
+/// stdev fields). The input must use a structured cell set (2D or 3D).
+///
+class ContourUncertainEdges : public vtkm::filter::FilterField
+{
+public:
+  enum struct DistributionType
+  {
+    Uniform,
+    IndependentGaussian
+  };
+
+private:
+  std::string CrossingPositionName = "crossing_position";
+  vtkm::Float64 IsoValue = 0.0;
+  DistributionType Distribution = DistributionType::Uniform;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT ContourUncertainEdges();
+
+  ///@{
+  /// Specifies the contour value.
+  VTKM_CONT void SetIsoValue(vtkm::Float64 value) { this->IsoValue = value; }
+  VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
+  ///@}
+
+  ///@{
+  /// Specifies the model used for the uncertainty of each point.
+  VTKM_CONT void SetDistribution(DistributionType distribution)
+  {
+    this->Distribution = distribution;
+  }
+  VTKM_CONT DistributionType GetDistribution() const { return this->Distribution; }
+  ///@}
+
+  ///@{
+  /// Specifies the fields with the minimum and maximum values of the uniform model.
+  VTKM_CONT void SetMinField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetMaxField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the fields with the mean and standard deviation of the gaussian model.
+  VTKM_CONT void SetMeanField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetStdevField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field with the probability of the contour crossing
+  /// each edge.
+  VTKM_CONT void SetCrossingProbabilityName(const std::string& name)
+  {
+    this->SetOutputFieldName(name);
+  }
+  VTKM_CONT const std::string& GetCrossingProbabilityName() const
+  {
+    return this->GetOutputFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field with the expected crossing point of each edge.
+  VTKM_CONT void SetCrossingPositionName(const std::string& name)
+  {
+    this->CrossingPositionName = name;
+  }
+  VTKM_CONT const std::string& GetCrossingPositionName() const
+  {
+    return this->CrossingPositionName;
+  }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_ContourUncertainEdges_h
@@ -13,8 +13,34 @@
 #include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/Timer.h>
 
+#include <algorithm>
+#include <vector>
+
 // #include "ucvworklet/MVGaussianWithEnsemble3D.hpp"
 #include "ucvworklet/MVGaussianWithEnsemble3DTryLialg.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DFactorize.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DSampling.hpp"
+
+namespace
+{
+
+// True if the two arrays share their buffers, which is the case when a field is passed
+// through from one execution to the next, but not for a new time step.
+bool IsSameArray(const vtkm::cont::UnknownArrayHandle& array1,
+                 const vtkm::cont::UnknownArrayHandle& array2)
+{
+  if (!array1.IsValid() || !array2.IsValid() ||
+      (array1.GetNumberOfValues() != array2.GetNumberOfValues()))
+  {
+    return false;
+  }
+  std::vector<vtkm::cont::internal::Buffer> buffers1 = array1.GetBuffers();
+  std::vector<vtkm::cont::internal::Buffer> buffers2 = array2.GetBuffers();
+  return (buffers1.size() == buffers2.size()) &&
+    std::equal(buffers1.begin(), buffers1.end(), buffers2.begin());
+}
+
+} // anonymous namespace
 
 namespace vtkm
 {
@@ -36,6 +62,8 @@ vtkm::cont::DataSet ContourUncertainEnsemble::DoExecute(const vtkm::cont::DataSe
   vtkm::cont::UnknownArrayHandle crossProbability;
   vtkm::cont::UnknownArrayHandle numNonZeroProbability;
   vtkm::cont::UnknownArrayHandle entropy;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> caseNumbers;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> caseProbs;
 
   if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
   {
@@ -44,22 +72,99 @@ vtkm::cont::DataSet ContourUncertainEnsemble::DoExecute(const vtkm::cont::DataSe
   vtkm::cont::CellSetStructured<3> cellSet;
   input.GetCellSet().AsCellSet(cellSet);
 
+  // The cached factorization is only valid for the same grid and the same input arrays.
+  if (this->HasCachedFactorization() &&
+      ((this->CachedCellFactor.GetNumberOfValues() != cellSet.GetNumberOfCells()) ||
+       !IsSameArray(this->CachedEnsembleArray, ensembleField.GetData()) ||
+       !IsSameArray(this->CachedMeanArray, meanField.GetData())))
+  {
+    this->InvalidateFactorization();
+  }
+
   auto resolveType = [&](auto concreteMeanField) {
     using ValueType = typename std::decay_t<decltype(concreteMeanField)>::ValueType;
-    vtkm::cont::ArrayHandle<vtkm::Vec<ValueType, 4 * 4 * 4>> concreteEnsembleField;
-    vtkm::cont::ArrayCopyShallowIfPossible(ensembleField.GetData(), concreteEnsembleField);
 
     vtkm::cont::ArrayHandle<ValueType> concreteCrossProb;
     vtkm::cont::ArrayHandle<vtkm::Id> concreteNumNonZeroProb;
     vtkm::cont::ArrayHandle<ValueType> concreteEntropy;
 
-    this->Invoke(MVGaussianWithEnsemble3DTryLialg{ this->IsoValue, 1000 },
-                 cellSet,
-                 concreteEnsembleField,
-                 concreteMeanField,
-                 concreteCrossProb,
-                 concreteNumNonZeroProb,
-                 concreteEntropy);
+    // The most probable case needs the histogram of the samples, which the fused worklet
+    // does not keep, so it always goes through the factorization.
+    if (!this->CacheFactorization && !this->ComputeMostProbableCase)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Vec<ValueType, 4 * 4 * 4>> concreteEnsembleField;
+      vtkm::cont::ArrayCopyShallowIfPossible(ensembleField.GetData(), concreteEnsembleField);
+
+      // The factorization and the sampling are fused in this worklet, so they are reported
+      // as a single stage.
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "factorize_and_sample");
+      this->Invoke(MVGaussianWithEnsemble3DTryLialg{ this->IsoValue, this->NumberOfSamples },
+                   cellSet,
+                   concreteEnsembleField,
+                   concreteMeanField,
+                   concreteCrossProb,
+                   concreteNumNonZeroProb,
+                   concreteEntropy);
+    }
+    else
+    {
+      if (!this->HasCachedFactorization())
+      {
+        vtkm::cont::ArrayHandle<vtkm::Vec<ValueType, 4 * 4 * 4>> concreteEnsembleField;
+        vtkm::cont::ArrayCopyShallowIfPossible(ensembleField.GetData(), concreteEnsembleField);
+
+        FilterInstrumentation::ScopedStage stage(this->Instrumentation, "factorization");
+        this->Invoke(MVGaussianWithEnsemble3DFactorize{},
+                     cellSet,
+                     concreteEnsembleField,
+                     concreteMeanField,
+                     this->CachedCellMean,
+                     this->CachedCellFactor);
+        this->CachedEnsembleArray = ensembleField.GetData();
+        this->CachedMeanArray = meanField.GetData();
+
+        this->Instrumentation.AddCount("factorizations_computed", cellSet.GetNumberOfCells());
+        this->Instrumentation.AddBytes(
+          "factorization_cache",
+          cellSet.GetNumberOfCells() * (sizeof(vtkm::Vec<vtkm::Float64, 8>) +
+                                        sizeof(vtkm::Vec<vtkm::Float64, 64>)));
+      }
+      else
+      {
+        this->Instrumentation.AddCount("factorizations_reused", cellSet.GetNumberOfCells());
+      }
+
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "sampling");
+      if (this->ComputeMostProbableCase)
+      {
+        this->Invoke(
+          MVGaussianWithEnsemble3DSamplingWithCase{ this->IsoValue, this->NumberOfSamples },
+          this->CachedCellMean,
+          this->CachedCellFactor,
+          concreteCrossProb,
+          concreteNumNonZeroProb,
+          concreteEntropy,
+          caseNumbers,
+          caseProbs);
+      }
+      else
+      {
+        this->Invoke(MVGaussianWithEnsemble3DSampling{ this->IsoValue, this->NumberOfSamples },
+                     this->CachedCellMean,
+                     this->CachedCellFactor,
+                     concreteCrossProb,
+                     concreteNumNonZeroProb,
+                     concreteEntropy);
+      }
+      // Without caching, the factorization only lives for this execution.
+      if (!this->CacheFactorization)
+      {
+        this->InvalidateFactorization();
+      }
+    }
+
+    this->Instrumentation.AddBytes(
+      "output", cellSet.GetNumberOfCells() * (2 * sizeof(ValueType) + sizeof(vtkm::Id)));
 
     crossProbability = concreteCrossProb;
     numNonZeroProbability = concreteNumNonZeroProb;
@@ -67,10 +172,19 @@ vtkm::cont::DataSet ContourUncertainEnsemble::DoExecute(const vtkm::cont::DataSe
   };
   this->CastAndCallScalarField(meanField, resolveType);
 
+  this->Instrumentation.AddCount("cells_processed", cellSet.GetNumberOfCells());
+  this->Instrumentation.AddCount("samples_drawn",
+                                 cellSet.GetNumberOfCells() * this->NumberOfSamples);
+
   vtkm::cont::DataSet result = this->CreateResult(input);
   result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
   result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
   result.AddCellField(this->GetEntropyName(), entropy);
+  if (this->ComputeMostProbableCase)
+  {
+    result.AddCellField(this->GetMostProbableCaseName(), caseNumbers);
+    result.AddCellField(this->GetMostProbableCaseProbabilityName(), caseProbs);
+  }
   return result;
 }
 
@@ -10,8 +10,11 @@
 #ifndef vtk_m_filter_uncertainty_ContourUncertainEnsemble_h
 #define vtk_m_filter_uncertainty_ContourUncertainEnsemble_h
 
+#include <vtkm/cont/UnknownArrayHandle.h>
 #include <vtkm/filter/FilterField.h>
 
+#include "FilterInstrumentation.h"
+
 namespace vtkm
 {
 namespace filter
@@ -35,7 +38,20 @@ class ContourUncertainEnsemble : public vtkm::filter::FilterField
 {
   std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
   std::string EntropyName = "entropy";
+  std::string MostProbableCaseName = "most_probable_case";
+  std::string MostProbableCaseProbabilityName = "most_probable_case_probability";
+  bool ComputeMostProbableCase = false;
   vtkm::Float64 IsoValue = 0.0;
+  vtkm::IdComponent NumberOfSamples = 1000;
+
+  bool CacheFactorization = false;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 8>> CachedCellMean;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 64>> CachedCellFactor;
+  // The arrays the cached factorization was computed from.
+  vtkm::cont::UnknownArrayHandle CachedEnsembleArray;
+  vtkm::cont::UnknownArrayHandle CachedMeanArray;
+
+  FilterInstrumentation Instrumentation;
 
 public:
   VTKM_CONT ContourUncertainEnsemble();
@@ -45,10 +61,12 @@ public:
   VTKM_CONT void SetEnsembleField(const std::string& fieldName)
   {
     this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+    this->InvalidateFactorization();
   }
   VTKM_CONT void SetMeanField(const std::string& fieldName)
   {
     this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+    this->InvalidateFactorization();
   }
   ///@}
 
@@ -58,6 +76,59 @@ public:
   VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
   ///@}
 
+  ///@{
+  /// Specifies the number of samples drawn from the multivariate Gaussian of each cell.
+  VTKM_CONT void SetNumberOfSamples(vtkm::IdComponent value) { this->NumberOfSamples = value; }
+  VTKM_CONT vtkm::IdComponent GetNumberOfSamples() const { return this->NumberOfSamples; }
+  ///@}
+
+  ///@{
+  /// \brief Keeps the per-cell covariance factorization between executions.
+  ///
+  /// Computing the covariance and its eigendecomposition for every cell is the expensive
+  /// part of this filter, and it does not depend on the isovalue. When caching is on, the
+  /// mean vector and the factor A (where A A^T is the covariance) of each cell are kept
+  /// after an execution and the following executions only sample and classify the cells
+  /// for the current isovalue.
+  ///
+  /// The cache is only reused when the ensemble and mean fields are the same arrays (the
+  /// same buffers) as in the execution that computed it, on a grid with the same number of
+  /// cells. A new time step or new fields therefore recompute the factorization. Changing
+  /// the values of the same arrays in place can not be detected, the caller must then call
+  /// `InvalidateFactorization`.
+  ///
+  VTKM_CONT void SetCacheFactorization(bool flag)
+  {
+    this->CacheFactorization = flag;
+    if (!flag)
+    {
+      this->InvalidateFactorization();
+    }
+  }
+  VTKM_CONT bool GetCacheFactorization() const { return this->CacheFactorization; }
+  VTKM_CONT void InvalidateFactorization()
+  {
+    this->CachedCellMean.ReleaseResources();
+    this->CachedCellFactor.ReleaseResources();
+    this->CachedEnsembleArray = vtkm::cont::UnknownArrayHandle{};
+    this->CachedMeanArray = vtkm::cont::UnknownArrayHandle{};
+  }
+  VTKM_CONT bool HasCachedFactorization() const
+  {
+    return this->CachedCellFactor.GetNumberOfValues() > 0;
+  }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
   ///@{
   /// Specifies the name of the output field that captures the probability of the contour existing
   /// in each cell.
@@ -103,6 +174,36 @@ public:
   VTKM_CONT const std::string& GetEntropyName() const { return this->EntropyName; }
   ///@}
 
+  ///@{
+  /// \brief Also writes the most probable marching cubes case of each cell.
+  ///
+  /// The case with the most samples is written as a `vtkm::UInt8` cell field (the bit i is
+  /// set when the point i is above the isovalue, like the marching cells tables of VTK-m)
+  /// and the fraction of the samples that fall in it as another cell field. They are taken
+  /// from the same samples as the other outputs and can be given to
+  /// `ContourUncertainGeometry::SetMostProbableCaseFields` to extract the most probable
+  /// surface without sampling the cells again. This is off by default.
+  ///
+  VTKM_CONT void SetComputeMostProbableCase(bool flag) { this->ComputeMostProbableCase = flag; }
+  VTKM_CONT bool GetComputeMostProbableCase() const { return this->ComputeMostProbableCase; }
+  VTKM_CONT void SetMostProbableCaseName(const std::string& name)
+  {
+    this->MostProbableCaseName = name;
+  }
+  VTKM_CONT const std::string& GetMostProbableCaseName() const
+  {
+    return this->MostProbableCaseName;
+  }
+  VTKM_CONT void SetMostProbableCaseProbabilityName(const std::string& name)
+  {
+    this->MostProbableCaseProbabilityName = name;
+  }
+  VTKM_CONT const std::string& GetMostProbableCaseProbabilityName() const
+  {
+    return this->MostProbableCaseProbabilityName;
+  }
+  ///@}
+
 protected:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
 };
@@ -35,7 +35,12 @@ vtkm::cont::DataSet ContourUncertainEnsemble2D::DoExecute(const vtkm::cont::Data
 {
   
   vtkm::cont::Field ensembleField = this->GetFieldFromDataSet(0, input);
-  //vtkm::cont::Field meanField = this->GetFieldFromDataSet(1, input);
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> meanArray;
+  if (this->UseMeanField)
+  {
+    vtkm::cont::ArrayCopyShallowIfPossible(this->GetFieldFromDataSet(1, input).GetData(),
+                                           meanArray);
+  }
   
   vtkm::cont::UnknownArrayHandle crossProbability;
   vtkm::cont::UnknownArrayHandle numNonZeroProbability;
@@ -53,19 +58,40 @@ vtkm::cont::DataSet ContourUncertainEnsemble2D::DoExecute(const vtkm::cont::Data
   vtkm::cont::ArrayHandle<vtkm::Id> concreteNumNonZeroProb;
   vtkm::cont::ArrayHandle<vtkm::FloatDefault> concreteEntropy;
 
-  this->Invoke(MVGaussianWithEnsemble2DTryLialgEntropy{ this->IsoValue, 1000 },
+  if (this->UseMeanField)
+  {
+    this->Invoke(MVGaussianWithEnsemble2DTryLialgEntropyWithMean{ this->IsoValue, 1000 },
                  input.GetCellSet(),
                  concrete,
+                 meanArray,
                  concreteCrossProb,
                  concreteNumNonZeroProb,
                  concreteEntropy);
+  }
+  else
+  {
+    this->Invoke(MVGaussianWithEnsemble2DTryLialgEntropy{ this->IsoValue, 1000 },
+                 input.GetCellSet(),
+                 concrete,
+                 concreteCrossProb,
+                 concreteNumNonZeroProb,
+                 concreteEntropy);
+  }
 
     crossProbability = concreteCrossProb;
     numNonZeroProbability = concreteNumNonZeroProb;
     entropy = concreteEntropy;
   };
   //this->CastAndCallScalarField(ensembleField, resolveType);
-  ensembleField.GetData().CastAndCallForTypes<SupportedTypesVec, VTKM_DEFAULT_STORAGE_LIST>(resolveType);
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "factorize_and_sample");
+    ensembleField.GetData().CastAndCallForTypes<SupportedTypesVec, VTKM_DEFAULT_STORAGE_LIST>(resolveType);
+  }
+  vtkm::Id numCells = input.GetCellSet().GetNumberOfCells();
+  this->Instrumentation.AddCount("cells_processed", numCells);
+  this->Instrumentation.AddCount("samples_drawn", numCells * 1000);
+  this->Instrumentation.AddBytes(
+    "output", numCells * (2 * sizeof(vtkm::FloatDefault) + sizeof(vtkm::Id)));
   vtkm::cont::DataSet result = this->CreateResult(input);
   result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
   result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
@@ -12,6 +12,8 @@
 
 #include <vtkm/filter/FilterField.h>
 
+#include "FilterInstrumentation.h"
+
 namespace vtkm
 {
 namespace filter
@@ -29,12 +31,17 @@ namespace uncertainty
 /// This filter takes as input a field with a `Vec` containing the ensemble members
 /// it use the mulivariate gaussian to compute the uncertainty isocountour
 /// this filter is supposed to be merged together with ContourUncertainEnsemble in future
-/// it compute the mean in the worklet instead of using a explicit mean array as input parameter
+/// it compute the mean in the worklet instead of using a explicit mean array as input parameter,
+/// unless a mean field is given with `SetMeanField` (for example the `_mean` field of
+/// `EnsembleStatistics`), then the mean of each point is read instead of being recomputed
+/// by each of its cells
 class ContourUncertainEnsemble2D : public vtkm::filter::FilterField
 {
   std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
   std::string EntropyName = "entropy";
   vtkm::Float64 IsoValue = 0.1;
+  bool UseMeanField = false;
+  FilterInstrumentation Instrumentation;
 
 public:
   VTKM_CONT ContourUncertainEnsemble2D();
@@ -45,6 +52,11 @@ public:
   {
     this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
   }
+  VTKM_CONT void SetMeanField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+    this->UseMeanField = true;
+  }
   ///@}
 
   ///@{
@@ -98,6 +110,16 @@ public:
   VTKM_CONT const std::string& GetEntropyName() const { return this->EntropyName; }
   ///@}
 
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
 protected:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
 };
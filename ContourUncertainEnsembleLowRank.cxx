@@ -0,0 +1,97 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "ContourUncertainEnsembleLowRank.h"
+
+#include <vtkm/VecTraits.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+
+#include "ucvworklet/MVGaussianLowRankSampling.hpp"
+
+namespace
+{
+
+using SupportedCoefficientsTypes = vtkm::List<vtkm::Vec<vtkm::FloatDefault, 2>,
+                                              vtkm::Vec<vtkm::FloatDefault, 4>,
+                                              vtkm::Vec<vtkm::FloatDefault, 8>>;
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+ContourUncertainEnsembleLowRank::ContourUncertainEnsembleLowRank()
+{
+  this->SetCrossProbabilityName("cross_probability");
+}
+
+vtkm::cont::DataSet ContourUncertainEnsembleLowRank::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field meanField = this->GetFieldFromDataSet(0, input);
+  vtkm::cont::Field coefficientsField = this->GetFieldFromDataSet(1, input);
+  vtkm::cont::Field residualField = this->GetFieldFromDataSet(2, input);
+
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>() &&
+      !input.GetCellSet().IsType<vtkm::cont::CellSetStructured<2>>())
+  {
+    throw vtkm::cont::ErrorBadType(
+      "Uncertain contour only works for CellSetStructured<2> and CellSetStructured<3>.");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> mean;
+  vtkm::cont::ArrayCopyShallowIfPossible(meanField.GetData(), mean);
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> residual;
+  vtkm::cont::ArrayCopyShallowIfPossible(residualField.GetData(), residual);
+
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> crossProbability;
+  vtkm::cont::ArrayHandle<vtkm::Id> numNonZeroProbability;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> entropy;
+
+  auto resolveType = [&](const auto& concreteCoefficients) {
+    using CoefficientsType = typename std::decay_t<decltype(concreteCoefficients)>::ValueType;
+    constexpr vtkm::IdComponent Rank = vtkm::VecTraits<CoefficientsType>::NUM_COMPONENTS;
+    this->Invoke(
+      MVGaussianLowRankSampling<Rank>{ this->IsoValue, static_cast<int>(this->NumberOfSamples) },
+      input.GetCellSet(),
+      mean,
+      concreteCoefficients,
+      residual,
+      crossProbability,
+      numNonZeroProbability,
+      entropy);
+  };
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "sampling");
+    coefficientsField.GetData()
+      .CastAndCallForTypes<SupportedCoefficientsTypes, VTKM_DEFAULT_STORAGE_LIST>(resolveType);
+  }
+
+  vtkm::Id numCells = input.GetCellSet().GetNumberOfCells();
+  this->Instrumentation.AddCount("cells_processed", numCells);
+  this->Instrumentation.AddCount("samples_drawn", numCells * this->NumberOfSamples);
+  this->Instrumentation.AddBytes(
+    "output", numCells * (2 * sizeof(vtkm::FloatDefault) + sizeof(vtkm::Id)));
+
+  vtkm::cont::DataSet result = this->CreateResult(input);
+  result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
+  result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
+  result.AddCellField(this->GetEntropyName(), entropy);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
@@ -0,0 +1,129 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_ContourUncertainEnsembleLowRank_h
+#define vtk_m_filter_uncertainty_ContourUncertainEnsembleLowRank_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Computes the probability of the location of a contour.
+///
+/// Like `ContourUncertainEnsemble`, this filter writes a cell field giving the probability
+/// of a contour being in each cell, the number of possible contour cases and their entropy,
+/// with a multivariant gaussian model of the points of each cell.
+///
+/// Instead of the members of the ensemble, this filter takes the output of `EnsemblePCA`:
+/// the mean of each point, its coefficients in the principal directions of the ensemble
+/// (a `Vec` of 2, 4 or 8 values) and its residual variance. The covariance of a cell is
+/// `U U^T + D`, where the rows of U are the coefficients of the points and D holds the
+/// residuals. The samples are drawn as `mean + U z + sqrt(D) e`, so no covariance matrix
+/// is built and no matrix is factorized. Both `CellSetStructured<2>` and
+/// `CellSetStructured<3>` are supported.
+///
+class ContourUncertainEnsembleLowRank : public vtkm::filter::FilterField
+{
+  std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
+  std::string EntropyName = "entropy";
+  vtkm::Float64 IsoValue = 0.0;
+  vtkm::Id NumberOfSamples = 1000;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT ContourUncertainEnsembleLowRank();
+
+  ///@{
+  /// Specifies the fields with the mean, the principal component coefficients and the
+  /// residual variance of each point.
+  VTKM_CONT void SetMeanField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetCoefficientsField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetResidualField(const std::string& fieldName)
+  {
+    this->SetActiveField(2, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the contour value.
+  VTKM_CONT void SetIsoValue(vtkm::Float64 value) { this->IsoValue = value; }
+  VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
+  ///@}
+
+  ///@{
+  /// The number of samples drawn per cell.
+  VTKM_CONT void SetNumberOfSamples(vtkm::Id numSamples) { this->NumberOfSamples = numSamples; }
+  VTKM_CONT vtkm::Id GetNumberOfSamples() const { return this->NumberOfSamples; }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the probability of the contour existing
+  /// in each cell.
+  VTKM_CONT void SetCrossProbabilityName(const std::string& name)
+  {
+    this->SetOutputFieldName(name);
+  }
+  VTKM_CONT const std::string& GetCrossProbabilityName() const
+  {
+    return this->GetOutputFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the number of possible marching
+  /// contour cases for each cell.
+  VTKM_CONT void SetNumberNonzeroProbabilityName(const std::string& name)
+  {
+    this->NumberNonzeroProbabilityName = name;
+  }
+  VTKM_CONT const std::string& GetNumberNonzeroProbabilityName() const
+  {
+    return this->NumberNonzeroProbabilityName;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the entropy of the possible
+  /// marching contour cases for each cell.
+  VTKM_CONT void SetEntropyName(const std::string& name) { this->EntropyName = name; }
+  VTKM_CONT const std::string& GetEntropyName() const { return this->EntropyName; }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_ContourUncertainEnsembleLowRank_h
@@ -0,0 +1,196 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "ContourUncertainGeometry.h"
+
+#include <vtkm/CellShape.h>
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleDiscard.h>
+#include <vtkm/cont/ArrayHandleGroupVec.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/worklet/ScatterCounting.h>
+
+#include "ucvworklet/EdgeCrossing.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DFactorize.hpp"
+#include "ucvworklet/MostProbableCase.hpp"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+ContourUncertainGeometry::ContourUncertainGeometry()
+{
+  this->SetTriangleProbabilityName("triangle_probability");
+}
+
+vtkm::cont::DataSet ContourUncertainGeometry::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field field0 = this->GetFieldFromDataSet(0, input);
+  // The precomputed cases replace the ensemble field of the multivariant gaussian model.
+  bool useCaseFields = (this->Distribution == DistributionType::MultivariateGaussian) &&
+    !this->MostProbableCaseName.empty();
+  vtkm::cont::Field field1 = useCaseFields ? field0 : this->GetFieldFromDataSet(1, input);
+
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorBadType("Uncertain contour geometry only works for CellSetStructured<3>.");
+  }
+  vtkm::cont::CellSetStructured<3> cellSet;
+  input.GetCellSet().AsCellSet(cellSet);
+  vtkm::Id3 pointDims = cellSet.GetPointDimensions();
+
+  StructuredEdgeIndexing indexing(pointDims);
+  vtkm::Id numEdges = indexing.GetNumberOfEdges();
+  auto coords = input.GetCoordinateSystem().GetDataAsMultiplexer();
+
+  // First pass: the most probable case of each cell and its number of triangles, and the
+  // expected crossing point of each unique edge.
+  vtkm::cont::ArrayHandle<vtkm::UInt8> caseNumbers;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> caseProbs;
+  vtkm::cont::ArrayHandle<vtkm::IdComponent> numTriangles;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> edgePoints;
+
+  auto computeEdgePoints = [&](auto model, const auto& concreteField0, const auto& concreteField1) {
+    using ModelType = decltype(model);
+    this->Invoke(EdgeCrossingStructured<ModelType>{ pointDims, this->IsoValue },
+                 vtkm::cont::ArrayHandleIndex(numEdges),
+                 concreteField0,
+                 concreteField1,
+                 coords,
+                 vtkm::cont::ArrayHandleDiscard<vtkm::Id2>{},
+                 vtkm::cont::ArrayHandleDiscard<vtkm::FloatDefault>{},
+                 edgePoints);
+  };
+
+  auto resolveType = [&](auto concreteField0) {
+    using ArrayType = std::decay_t<decltype(concreteField0)>;
+    using ValueType = typename ArrayType::ValueType;
+
+    if (useCaseFields)
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "classify");
+      vtkm::cont::ArrayCopyShallowIfPossible(
+        input.GetCellField(this->MostProbableCaseName).GetData(), caseNumbers);
+      vtkm::cont::ArrayCopyShallowIfPossible(
+        input.GetCellField(this->MostProbableCaseProbabilityName).GetData(), caseProbs);
+      this->Invoke(NumTrianglesOfCase{}, caseNumbers, numTriangles);
+      computeEdgePoints(EnsembleMeanEdgeModel{}, concreteField0, concreteField0);
+      return;
+    }
+
+    if (this->Distribution == DistributionType::MultivariateGaussian)
+    {
+      vtkm::cont::ArrayHandle<vtkm::Vec<ValueType, 4 * 4 * 4>> concreteEnsembleField;
+      vtkm::cont::ArrayCopyShallowIfPossible(field1.GetData(), concreteEnsembleField);
+
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "classify");
+      vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 8>> cellMean;
+      vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 64>> cellFactor;
+      this->Invoke(MVGaussianWithEnsemble3DFactorize{},
+                   cellSet,
+                   concreteEnsembleField,
+                   concreteField0,
+                   cellMean,
+                   cellFactor);
+      this->Invoke(MVGaussianWithEnsemble3DMostProbableCase{ this->IsoValue,
+                                                             static_cast<int>(this->NumberOfSamples) },
+                   cellMean,
+                   cellFactor,
+                   caseNumbers,
+                   caseProbs,
+                   numTriangles);
+      computeEdgePoints(EnsembleMeanEdgeModel{}, concreteField0, concreteField0);
+      return;
+    }
+
+    ArrayType concreteField1;
+    vtkm::cont::ArrayCopyShallowIfPossible(field1.GetData(), concreteField1);
+
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "classify");
+    if (this->Distribution == DistributionType::Uniform)
+    {
+      this->Invoke(MostProbableCaseIndependent<UniformEdgeModel>{ this->IsoValue },
+                   cellSet,
+                   concreteField0,
+                   concreteField1,
+                   caseNumbers,
+                   caseProbs,
+                   numTriangles);
+      computeEdgePoints(UniformEdgeModel{}, concreteField0, concreteField1);
+    }
+    else
+    {
+      this->Invoke(MostProbableCaseIndependent<IndependentGaussianEdgeModel>{ this->IsoValue },
+                   cellSet,
+                   concreteField0,
+                   concreteField1,
+                   caseNumbers,
+                   caseProbs,
+                   numTriangles);
+      computeEdgePoints(IndependentGaussianEdgeModel{}, concreteField0, concreteField1);
+    }
+  };
+  this->CastAndCallScalarField(field0, resolveType);
+
+  // Second pass: the triangles of each cell, as ids of the edges of their vertices.
+  vtkm::cont::ArrayHandle<vtkm::Id> triangleEdges;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> triangleProbs;
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "generate");
+    vtkm::worklet::ScatterCounting scatter(numTriangles);
+    this->Invoke(GenerateProbableTriangles{ pointDims },
+                 scatter,
+                 cellSet,
+                 caseNumbers,
+                 caseProbs,
+                 vtkm::cont::make_ArrayHandleGroupVec<3>(triangleEdges),
+                 triangleProbs);
+  }
+
+  // Only keep the crossing points of the edges that are used by a triangle.
+  vtkm::cont::ArrayHandle<vtkm::Id> usedEdges;
+  vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points;
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "compact");
+    vtkm::cont::Algorithm::Copy(triangleEdges, usedEdges);
+    vtkm::cont::Algorithm::Sort(usedEdges);
+    vtkm::cont::Algorithm::Unique(usedEdges);
+    vtkm::cont::Algorithm::LowerBounds(usedEdges, triangleEdges, connectivity);
+    vtkm::cont::Algorithm::Copy(vtkm::cont::make_ArrayHandlePermutation(usedEdges, edgePoints),
+                                points);
+  }
+
+  this->Instrumentation.AddCount("cells_processed", cellSet.GetNumberOfCells());
+  this->Instrumentation.AddCount("edges_processed", numEdges);
+  this->Instrumentation.AddCount("triangles", triangleProbs.GetNumberOfValues());
+
+  vtkm::cont::CellSetSingleType<> triangles;
+  triangles.Fill(points.GetNumberOfValues(), vtkm::CELL_SHAPE_TRIANGLE, 3, connectivity);
+
+  // The fields of the grid can not be mapped to the triangles.
+  auto mapper = [](auto&, const auto&) {};
+  vtkm::cont::DataSet result = this->CreateResultCoordinateSystem(
+    input, triangles, input.GetCoordinateSystem().GetName(), points, mapper);
+  result.AddCellField(this->GetTriangleProbabilityName(), triangleProbs);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
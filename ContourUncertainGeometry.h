@@ -0,0 +1,176 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_ContourUncertainGeometry_h
+#define vtk_m_filter_uncertainty_ContourUncertainGeometry_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Extracts the most probable contour surface of a field with uncertainty.
+///
+/// The other `ContourUncertain*` filters only write cell fields. Running a regular contour
+/// on the cross probability to render them is slow and does not give the contour of the
+/// data. This filter selects, for each cell, the marching cubes case with the highest
+/// probability and writes its triangles, so the result can be rendered directly.
+///
+/// The vertices are placed at the expected crossing point of each edge (the interpolation
+/// of the means of its points, see `ContourUncertainEdges`). They are computed once per
+/// unique edge and shared by the triangles of the neighboring cells. Like the contour
+/// filter of VTK-m, the triangles are generated in two passes: the first pass computes the
+/// case and the number of triangles of each cell, and the second pass writes the triangles
+/// at the offsets given by a scan of these numbers. Each triangle has the probability of
+/// the case of its cell as a cell field (`triangle_probability` by default).
+///
+/// For the uniform and the independent gaussian models, the points are independent and
+/// the most probable case takes the most probable side of each point. For the multivariant
+/// gaussian model, the case is the most frequent case of the samples. Sampling the cells is
+/// as expensive as `ContourUncertainEnsemble`, so when that filter already ran with
+/// `SetComputeMostProbableCase`, its case fields can be given with `SetMostProbableCaseFields`
+/// and the cells are not sampled again. The crossing points of this model are the
+/// interpolation of the means, which can be on the same side of the isovalue for an edge of
+/// the sampled case; the point is then put inside the edge, closer to the mean nearest to the
+/// isovalue, instead of on a grid point. The input must use a `CellSetStructured<3>`.
+///
+class ContourUncertainGeometry : public vtkm::filter::FilterField
+{
+public:
+  enum struct DistributionType
+  {
+    Uniform,
+    IndependentGaussian,
+    MultivariateGaussian
+  };
+
+private:
+  vtkm::Float64 IsoValue = 0.0;
+  DistributionType Distribution = DistributionType::Uniform;
+  vtkm::Id NumberOfSamples = 1000;
+  std::string MostProbableCaseName;
+  std::string MostProbableCaseProbabilityName;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT ContourUncertainGeometry();
+
+  ///@{
+  /// Specifies the contour value.
+  VTKM_CONT void SetIsoValue(vtkm::Float64 value) { this->IsoValue = value; }
+  VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
+  ///@}
+
+  ///@{
+  /// Specifies the model used for the uncertainty of the field.
+  VTKM_CONT void SetDistribution(DistributionType distribution)
+  {
+    this->Distribution = distribution;
+  }
+  VTKM_CONT DistributionType GetDistribution() const { return this->Distribution; }
+  ///@}
+
+  ///@{
+  /// Specifies the fields with the minimum and maximum values of the uniform model.
+  VTKM_CONT void SetMinField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetMaxField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// \brief Specifies the fields of the gaussian models.
+  ///
+  /// The independent gaussian model uses the mean and the standard deviation fields, the
+  /// multivariant gaussian model uses the mean and the ensemble fields.
+  ///
+  VTKM_CONT void SetMeanField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetStdevField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetEnsembleField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// The number of samples drawn per cell by the multivariant gaussian model.
+  VTKM_CONT void SetNumberOfSamples(vtkm::Id numSamples) { this->NumberOfSamples = numSamples; }
+  VTKM_CONT vtkm::Id GetNumberOfSamples() const { return this->NumberOfSamples; }
+  ///@}
+
+  ///@{
+  /// \brief Uses the most probable cases computed by `ContourUncertainEnsemble`.
+  ///
+  /// The multivariant gaussian model then reads the case and its probability from these
+  /// cell fields instead of sampling the cells, and only needs the mean field. They are not
+  /// set by default (empty names).
+  ///
+  VTKM_CONT void SetMostProbableCaseFields(const std::string& caseName,
+                                           const std::string& probabilityName)
+  {
+    this->MostProbableCaseName = caseName;
+    this->MostProbableCaseProbabilityName = probabilityName;
+  }
+  VTKM_CONT const std::string& GetMostProbableCaseName() const
+  {
+    return this->MostProbableCaseName;
+  }
+  VTKM_CONT const std::string& GetMostProbableCaseProbabilityName() const
+  {
+    return this->MostProbableCaseProbabilityName;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field with the probability of each triangle.
+  VTKM_CONT void SetTriangleProbabilityName(const std::string& name)
+  {
+    this->SetOutputFieldName(name);
+  }
+  VTKM_CONT const std::string& GetTriangleProbabilityName() const
+  {
+    return this->GetOutputFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_ContourUncertainGeometry_h
@@ -0,0 +1,113 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "ContourUncertainHistogram.h"
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+
+#include "ucvworklet/EntropyFromPointProbability.hpp"
+#include "ucvworklet/HistogramPointProbability.hpp"
+
+namespace
+{
+
+using SupportedHistogramTypes = vtkm::List<vtkm::Vec<vtkm::UInt8, 8>,
+                                           vtkm::Vec<vtkm::UInt8, 16>,
+                                           vtkm::Vec<vtkm::UInt8, 32>,
+                                           vtkm::Vec<vtkm::UInt16, 8>,
+                                           vtkm::Vec<vtkm::UInt16, 16>,
+                                           vtkm::Vec<vtkm::UInt16, 32>>;
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+ContourUncertainHistogram::ContourUncertainHistogram()
+{
+  this->SetCrossProbabilityName("cross_probability");
+}
+
+vtkm::cont::DataSet ContourUncertainHistogram::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field minField = this->GetFieldFromDataSet(0, input);
+  vtkm::cont::Field maxField = this->GetFieldFromDataSet(1, input);
+  vtkm::cont::Field histogramField = this->GetFieldFromDataSet(2, input);
+
+  vtkm::cont::UnknownArrayHandle crossProbability;
+  vtkm::cont::UnknownArrayHandle numNonZeroProbability;
+  vtkm::cont::UnknownArrayHandle entropy;
+
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorBadType("Uncertain contour only works for CellSetStructured<3>.");
+  }
+  vtkm::cont::CellSetStructured<3> cellSet;
+  input.GetCellSet().AsCellSet(cellSet);
+
+  auto resolveType = [&](auto concreteMinField) {
+    using ArrayType = std::decay_t<decltype(concreteMinField)>;
+    using ValueType = typename ArrayType::ValueType;
+    ArrayType concreteMaxField;
+    vtkm::cont::ArrayCopyShallowIfPossible(maxField.GetData(), concreteMaxField);
+
+    vtkm::cont::ArrayHandle<ValueType> concreteCrossProb;
+    vtkm::cont::ArrayHandle<vtkm::Id> concreteNumNonZeroProb;
+    vtkm::cont::ArrayHandle<ValueType> concreteEntropy;
+
+    // Pr[X <= isovalue] of each point
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> pointNegativeProb;
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "point_probability");
+      histogramField.GetData().CastAndCallForTypes<SupportedHistogramTypes, VTKM_DEFAULT_STORAGE_LIST>(
+        [&](const auto& concreteHistogram) {
+          this->Invoke(HistogramPointProbability{ this->IsoValue },
+                       concreteMinField,
+                       concreteMaxField,
+                       concreteHistogram,
+                       pointNegativeProb);
+        });
+    }
+
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "entropy");
+    this->Invoke(EntropyFromPointProbability{},
+                 cellSet,
+                 pointNegativeProb,
+                 concreteCrossProb,
+                 concreteNumNonZeroProb,
+                 concreteEntropy);
+
+    this->Instrumentation.AddBytes(
+      "output", cellSet.GetNumberOfCells() * (2 * sizeof(ValueType) + sizeof(vtkm::Id)));
+
+    crossProbability = concreteCrossProb;
+    numNonZeroProbability = concreteNumNonZeroProb;
+    entropy = concreteEntropy;
+  };
+  this->CastAndCallScalarField(minField, resolveType);
+
+  this->Instrumentation.AddCount("cells_processed", cellSet.GetNumberOfCells());
+
+  vtkm::cont::DataSet result = this->CreateResult(input);
+  result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
+  result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
+  result.AddCellField(this->GetEntropyName(), entropy);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
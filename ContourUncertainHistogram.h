@@ -0,0 +1,121 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_ContourUncertainHistogram_h
+#define vtk_m_filter_uncertainty_ContourUncertainHistogram_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Computes the probability of the location of a contour.
+///
+/// Like `ContourUncertainUniform`, this filter writes a cell field giving the probability
+/// of a contour being in each cell, the number of possible contour cases and their entropy.
+///
+/// This filter uses a nonparametric model: the distribution of each point is a histogram
+/// of its values (see `SubsampleUncertaintyHistogram`), with the values assumed uniform in
+/// each bin. It follows distributions with several modes, which a gaussian does not. The
+/// probability of each point being below the isovalue is computed once per point from the
+/// prefix sum of the counts, and the cells combine the probabilities of their points.
+/// The points are assumed to be independent.
+///
+class ContourUncertainHistogram : public vtkm::filter::FilterField
+{
+  std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
+  std::string EntropyName = "entropy";
+  vtkm::Float64 IsoValue = 0.0;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT ContourUncertainHistogram();
+
+  ///@{
+  /// Specifies the fields capturing the minimum and maximum values of the data and the
+  /// histogram of the values between them. The histogram is a `Vec` of 8, 16 or 32 counts
+  /// stored as `UInt8` or `UInt16`.
+  VTKM_CONT void SetMinField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetMaxField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetHistogramField(const std::string& fieldName)
+  {
+    this->SetActiveField(2, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the contour value.
+  VTKM_CONT void SetIsoValue(vtkm::Float64 value) { this->IsoValue = value; }
+  VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the probability of the contour existing
+  /// in each cell.
+  VTKM_CONT void SetCrossProbabilityName(const std::string& name)
+  {
+    this->SetOutputFieldName(name);
+  }
+  VTKM_CONT const std::string& GetCrossProbabilityName() const
+  {
+    return this->GetOutputFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the number of possible marching
+  /// contour cases for each cell.
+  VTKM_CONT void SetNumberNonzeroProbabilityName(const std::string& name)
+  {
+    this->NumberNonzeroProbabilityName = name;
+  }
+  VTKM_CONT const std::string& GetNumberNonzeroProbabilityName() const
+  {
+    return this->NumberNonzeroProbabilityName;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the entropy of the possible
+  /// marching contour cases for each cell.
+  VTKM_CONT void SetEntropyName(const std::string& name) { this->EntropyName = name; }
+  VTKM_CONT const std::string& GetEntropyName() const { return this->EntropyName; }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_ContourUncertainHistogram_h
@@ -10,10 +10,16 @@
 
 #include "ContourUncertainIndependentGaussian.h"
 
+#include <vtkm/cont/Algorithm.h>
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleCast.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/Timer.h>
 
+#include "ucvworklet/EntropyFromPointProbability.hpp"
 #include "ucvworklet/EntropyIndependentGaussian.hpp"
+#include "ucvworklet/GaussianPointProbability.hpp"
 
 namespace vtkm
 {
@@ -43,6 +49,12 @@ vtkm::cont::DataSet ContourUncertainIndependentGaussian::DoExecute(const vtkm::c
   vtkm::cont::CellSetStructured<3> cellSet;
   input.GetCellSet().AsCellSet(cellSet);
 
+  if ((this->ActiveCellMask.GetNumberOfValues() > 0) &&
+      (this->ActiveCellMask.GetNumberOfValues() != cellSet.GetNumberOfCells()))
+  {
+    throw vtkm::cont::ErrorBadValue("The active cell mask does not match the number of cells.");
+  }
+
   auto resolveType = [&](auto concreteMeanField) {
     using ArrayType = std::decay_t<decltype(concreteMeanField)>;
     using ValueType = typename ArrayType::ValueType;
@@ -53,13 +65,73 @@ vtkm::cont::DataSet ContourUncertainIndependentGaussian::DoExecute(const vtkm::c
     vtkm::cont::ArrayHandle<vtkm::Id> concreteNumNonZeroProb;
     vtkm::cont::ArrayHandle<ValueType> concreteEntropy;
 
-    this->Invoke(EntropyIndependentGaussian{ this->IsoValue },
-                 cellSet,
-                 concreteMeanField,
-                 concreteStdevField,
-                 concreteCrossProb,
-                 concreteNumNonZeroProb,
-                 concreteEntropy);
+    // Pr[X <= isovalue] of each point
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> pointNegativeProb;
+    if (this->PointCentric)
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "point_probability");
+      this->Invoke(GaussianPointProbability{ this->IsoValue, this->FastErf },
+                   concreteMeanField,
+                   concreteStdevField,
+                   pointNegativeProb);
+    }
+
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "entropy");
+    if (this->ActiveCellMask.GetNumberOfValues() > 0)
+    {
+      // The cells that are not selected are known to not contain the contour.
+      vtkm::Id numCells = cellSet.GetNumberOfCells();
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(ValueType(0), numCells),
+                            concreteCrossProb);
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(vtkm::Id(1), numCells),
+                            concreteNumNonZeroProb);
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(ValueType(0), numCells),
+                            concreteEntropy);
+
+      if (this->PointCentric)
+      {
+        this->Invoke(EntropyFromPointProbabilityMasked{},
+                     vtkm::worklet::MaskSelect(this->ActiveCellMask),
+                     cellSet,
+                     pointNegativeProb,
+                     concreteCrossProb,
+                     concreteNumNonZeroProb,
+                     concreteEntropy);
+      }
+      else
+      {
+        this->Invoke(EntropyIndependentGaussianMasked{ this->IsoValue },
+                     vtkm::worklet::MaskSelect(this->ActiveCellMask),
+                     cellSet,
+                     concreteMeanField,
+                     concreteStdevField,
+                     concreteCrossProb,
+                     concreteNumNonZeroProb,
+                     concreteEntropy);
+      }
+    }
+    else if (this->PointCentric)
+    {
+      this->Invoke(EntropyFromPointProbability{},
+                   cellSet,
+                   pointNegativeProb,
+                   concreteCrossProb,
+                   concreteNumNonZeroProb,
+                   concreteEntropy);
+    }
+    else
+    {
+      this->Invoke(EntropyIndependentGaussian{ this->IsoValue },
+                   cellSet,
+                   concreteMeanField,
+                   concreteStdevField,
+                   concreteCrossProb,
+                   concreteNumNonZeroProb,
+                   concreteEntropy);
+    }
+
+    this->Instrumentation.AddBytes(
+      "output", cellSet.GetNumberOfCells() * (2 * sizeof(ValueType) + sizeof(vtkm::Id)));
 
     crossProbability = concreteCrossProb;
     numNonZeroProbability = concreteNumNonZeroProb;
@@ -67,6 +139,19 @@ vtkm::cont::DataSet ContourUncertainIndependentGaussian::DoExecute(const vtkm::c
   };
   this->CastAndCallScalarField(meanField, resolveType);
 
+  if (this->Instrumentation.GetEnabled())
+  {
+    vtkm::Id numCells = cellSet.GetNumberOfCells();
+    vtkm::Id numProcessed = numCells;
+    if (this->ActiveCellMask.GetNumberOfValues() > 0)
+    {
+      numProcessed = vtkm::cont::Algorithm::Reduce(
+        vtkm::cont::make_ArrayHandleCast<vtkm::Id>(this->ActiveCellMask), vtkm::Id(0));
+    }
+    this->Instrumentation.AddCount("cells_processed", numProcessed);
+    this->Instrumentation.AddCount("cells_culled", numCells - numProcessed);
+  }
+
   vtkm::cont::DataSet result = this->CreateResult(input);
   result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
   result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
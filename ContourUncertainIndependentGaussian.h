@@ -10,8 +10,11 @@
 #ifndef vtk_m_filter_uncertainty_ContourUncertainIndependentGaussian_h
 #define vtk_m_filter_uncertainty_ContourUncertainIndependentGaussian_h
 
+#include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/filter/FilterField.h>
 
+#include "FilterInstrumentation.h"
+
 namespace vtkm
 {
 namespace filter
@@ -35,6 +38,10 @@ class ContourUncertainIndependentGaussian : public vtkm::filter::FilterField
   std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
   std::string EntropyName = "entropy";
   vtkm::Float64 IsoValue = 0.0;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> ActiveCellMask;
+  bool PointCentric = true;
+  bool FastErf = false;
+  FilterInstrumentation Instrumentation;
 
 public:
   VTKM_CONT ContourUncertainIndependentGaussian();
@@ -58,6 +65,61 @@ public:
   VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
   ///@}
 
+  ///@{
+  /// \brief Restricts the computation to a subset of the cells.
+  ///
+  /// When a mask is given, it must have one value per cell of the input. Only the cells
+  /// with a nonzero mask value are computed. The other cells are reported as certain to
+  /// not contain the contour (a cross probability and entropy of 0 with a single possible
+  /// case). This is used to refine a coarse result, where most of the cells are already
+  /// known to be away from the contour. An empty mask (the default) computes all cells.
+  ///
+  VTKM_CONT void SetActiveCellMask(const vtkm::cont::ArrayHandle<vtkm::UInt8>& mask)
+  {
+    this->ActiveCellMask = mask;
+  }
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::UInt8>& GetActiveCellMask() const
+  {
+    return this->ActiveCellMask;
+  }
+  VTKM_CONT void ClearActiveCellMask()
+  {
+    this->ActiveCellMask = vtkm::cont::ArrayHandle<vtkm::UInt8>{};
+  }
+  ///@}
+
+  ///@{
+  /// \brief Computes the probability of each point once before the cells.
+  ///
+  /// Each point is shared by 8 cells. When on (the default), a first pass computes
+  /// Pr[X <= isovalue] once per point and the cells only gather the probabilities of their
+  /// points. When off, each cell evaluates the probabilities of its 8 points.
+  ///
+  VTKM_CONT void SetPointCentric(bool flag) { this->PointCentric = flag; }
+  VTKM_CONT bool GetPointCentric() const { return this->PointCentric; }
+  ///@}
+
+  ///@{
+  /// \brief Uses a polynomial approximation of erf in the point pass.
+  ///
+  /// The approximation 7.1.26 of Abramowitz and Stegun has an absolute error below 1.5e-7
+  /// and can be vectorized. The erf of the math library is used when off (the default).
+  /// This only applies when the probabilities are point centric.
+  ///
+  VTKM_CONT void SetFastErf(bool flag) { this->FastErf = flag; }
+  VTKM_CONT bool GetFastErf() const { return this->FastErf; }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
   ///@{
   /// Specifies the name of the output field that captures the probability of the contour existing
   /// in each cell.
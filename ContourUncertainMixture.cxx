@@ -0,0 +1,88 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "ContourUncertainMixture.h"
+
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+
+#include "ucvworklet/EntropyFromPointProbability.hpp"
+#include "ucvworklet/MixturePointProbability.hpp"
+
+namespace
+{
+
+using SupportedMixtureTypes = vtkm::List<vtkm::Vec<vtkm::FloatDefault, 6>,
+                                         vtkm::Vec<vtkm::FloatDefault, 9>,
+                                         vtkm::Vec<vtkm::FloatDefault, 12>>;
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+ContourUncertainMixture::ContourUncertainMixture()
+{
+  this->SetCrossProbabilityName("cross_probability");
+}
+
+vtkm::cont::DataSet ContourUncertainMixture::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field mixtureField = this->GetFieldFromDataSet(0, input);
+
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> crossProbability;
+  vtkm::cont::ArrayHandle<vtkm::Id> numNonZeroProbability;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> entropy;
+
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorBadType("Uncertain contour only works for CellSetStructured<3>.");
+  }
+  vtkm::cont::CellSetStructured<3> cellSet;
+  input.GetCellSet().AsCellSet(cellSet);
+
+  // Pr[X <= isovalue] of each point
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> pointNegativeProb;
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "point_probability");
+    mixtureField.GetData().CastAndCallForTypes<SupportedMixtureTypes, VTKM_DEFAULT_STORAGE_LIST>(
+      [&](const auto& concreteMixture) {
+        this->Invoke(MixturePointProbability{ this->IsoValue }, concreteMixture, pointNegativeProb);
+      });
+  }
+
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "entropy");
+    this->Invoke(EntropyFromPointProbability{},
+                 cellSet,
+                 pointNegativeProb,
+                 crossProbability,
+                 numNonZeroProbability,
+                 entropy);
+  }
+
+  this->Instrumentation.AddBytes(
+    "output", cellSet.GetNumberOfCells() * (2 * sizeof(vtkm::FloatDefault) + sizeof(vtkm::Id)));
+  this->Instrumentation.AddCount("cells_processed", cellSet.GetNumberOfCells());
+
+  vtkm::cont::DataSet result = this->CreateResult(input);
+  result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
+  result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
+  result.AddCellField(this->GetEntropyName(), entropy);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
@@ -0,0 +1,283 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "ContourUncertainProgressive.h"
+
+#include "ContourUncertainIndependentGaussian.h"
+#include "ContourUncertainUniform.h"
+
+#include <vtkm/TypeList.h>
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandleCast.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/StorageList.h>
+
+#include <string>
+#include <type_traits>
+
+#include "ucvworklet/CoarsenBlocks.hpp"
+#include "ucvworklet/RefineCellMask.hpp"
+
+namespace
+{
+
+VTKM_CONT vtkm::Id3 GetCellDimensions(const vtkm::cont::DataSet& data)
+{
+  vtkm::cont::CellSetStructured<3> cellSet;
+  data.GetCellSet().AsCellSet(cellSet);
+  return cellSet.GetPointDimensions() - vtkm::Id3(1);
+}
+
+// Merges the blocks of a subsampled level into blocks `ratio` times larger. The two fields are
+// the min and max (uniform) or the mean and stdev (independent Gaussian) of each block.
+VTKM_CONT vtkm::cont::DataSet CoarsenLevel(const vtkm::cont::DataSet& fine,
+                                           const std::string& firstName,
+                                           const std::string& secondName,
+                                           bool gaussian,
+                                           const vtkm::Id3& rawDims,
+                                           vtkm::Id fineBlockSize,
+                                           vtkm::Id ratio,
+                                           vtkm::filter::uncertainty::FilterInstrumentation& instrumentation)
+{
+  vtkm::cont::CellSetStructured<3> fineCellSet;
+  fine.GetCellSet().AsCellSet(fineCellSet);
+  vtkm::Id3 fineDims = fineCellSet.GetPointDimensions();
+  vtkm::Id3 coarseDims = (fineDims + vtkm::Id3(ratio - 1)) / vtkm::Id3(ratio);
+  vtkm::Id numCoarsePoints = coarseDims[0] * coarseDims[1] * coarseDims[2];
+
+  vtkm::cont::CellSetStructured<3> coarseCellSet;
+  coarseCellSet.SetPointDimensions(coarseDims);
+
+  // Same coordinates as subsampling the raw grid, which has the bounds of the fine grid.
+  vtkm::Bounds bounds = fine.GetCoordinateSystem().GetBounds();
+  vtkm::Vec3f origin{ bounds.MinCorner() };
+  vtkm::Vec3f spacing{ (bounds.MaxCorner() - bounds.MinCorner()) / (coarseDims - 1) };
+  vtkm::cont::ArrayHandleUniformPointCoordinates coarseCoordinates{ coarseDims, origin, spacing };
+
+  vtkm::cont::DataSet coarse;
+  coarse.SetCellSet(coarseCellSet);
+  coarse.AddCoordinateSystem(
+    vtkm::cont::CoordinateSystem(fine.GetCoordinateSystem().GetName(), coarseCoordinates));
+
+  vtkm::cont::UnknownArrayHandle fineFirst = fine.GetPointField(firstName).GetData();
+  vtkm::cont::UnknownArrayHandle fineSecond = fine.GetPointField(secondName).GetData();
+  vtkm::cont::Invoker invoke;
+  auto resolveType = [&](const auto& concreteFirst) {
+    using ArrayType = std::decay_t<decltype(concreteFirst)>;
+    ArrayType concreteSecond = fineSecond.AsArrayHandle<ArrayType>();
+    ArrayType coarseFirst;
+    ArrayType coarseSecond;
+    if (gaussian)
+    {
+      invoke(CoarsenMeanStdev{ rawDims, fineDims, coarseDims, ratio, fineBlockSize },
+             vtkm::cont::ArrayHandleIndex(numCoarsePoints),
+             concreteFirst,
+             concreteSecond,
+             coarseFirst,
+             coarseSecond);
+    }
+    else
+    {
+      invoke(CoarsenMinMax{ fineDims, coarseDims, ratio },
+             vtkm::cont::ArrayHandleIndex(numCoarsePoints),
+             concreteFirst,
+             concreteSecond,
+             coarseFirst,
+             coarseSecond);
+    }
+    instrumentation.AddBytes("output", 2 * numCoarsePoints * sizeof(typename ArrayType::ValueType));
+    coarse.AddPointField(firstName, coarseFirst);
+    coarse.AddPointField(secondName, coarseSecond);
+  };
+  fineFirst.CastAndCallForTypes<vtkm::TypeListScalarAll, vtkm::cont::StorageListBasic>(resolveType);
+  return coarse;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+ContourUncertainProgressive::ContourUncertainProgressive()
+{
+  this->SetCrossProbabilityName("cross_probability");
+}
+
+vtkm::cont::DataSet ContourUncertainProgressive::DoExecute(const vtkm::cont::DataSet& input)
+{
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorBadType("Uncertain contour only works for CellSetStructured<3>.");
+  }
+
+  if (this->BlockSizes.empty())
+  {
+    throw vtkm::cont::ErrorBadValue("Progressive uncertain contour needs at least one block size.");
+  }
+  for (std::size_t level = 0; level < this->BlockSizes.size(); ++level)
+  {
+    if (this->BlockSizes[level] < 1)
+    {
+      throw vtkm::cont::ErrorBadValue("Block sizes must be positive.");
+    }
+    if ((level > 0) &&
+        ((this->BlockSizes[level] >= this->BlockSizes[level - 1]) ||
+         ((this->BlockSizes[level - 1] % this->BlockSizes[level]) != 0)))
+    {
+      throw vtkm::cont::ErrorBadValue(
+        "Each block size must be smaller than and divide the previous block size.");
+    }
+  }
+
+  const vtkm::cont::Field& field = this->GetFieldFromDataSet(input);
+  if (!field.IsPointField())
+  {
+    throw vtkm::cont::ErrorBadType("Progressive uncertain contour only works for point fields.");
+  }
+
+  // Only the active field is subsampled.
+  vtkm::cont::DataSet fieldData;
+  fieldData.SetCellSet(input.GetCellSet());
+  fieldData.AddCoordinateSystem(input.GetCoordinateSystem());
+  fieldData.AddField(field);
+
+  std::size_t numLevels = this->BlockSizes.size();
+  this->NumberOfComputedCells.clear();
+
+  vtkm::cont::CellSetStructured<3> cellSet;
+  input.GetCellSet().AsCellSet(cellSet);
+  vtkm::Id3 rawDims = cellSet.GetPointDimensions();
+
+  bool gaussian = (this->Distribution == DistributionType::IndependentGaussian);
+  std::string firstName = field.GetName() +
+    (gaussian ? this->GaussianSubsampler.GetMeanSuffix() : this->UniformSubsampler.GetMinSuffix());
+  std::string secondName = field.GetName() +
+    (gaussian ? this->GaussianSubsampler.GetStdevSuffix() : this->UniformSubsampler.GetMaxSuffix());
+
+  // Only the finest level reads the raw points. Each coarser level merges the blocks of the
+  // level after it, which gives the same blocks for a fraction of the cost.
+  std::vector<vtkm::cont::DataSet> subsampledLevels(numLevels);
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "subsample");
+    if (gaussian)
+    {
+      this->GaussianSubsampler.SetBlockSize(this->BlockSizes.back());
+      subsampledLevels.back() = this->GaussianSubsampler.Execute(fieldData);
+    }
+    else
+    {
+      this->UniformSubsampler.SetBlockSize(this->BlockSizes.back());
+      subsampledLevels.back() = this->UniformSubsampler.Execute(fieldData);
+    }
+  }
+  for (std::size_t level = numLevels - 1; level > 0; --level)
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "coarsen");
+    subsampledLevels[level - 1] = CoarsenLevel(subsampledLevels[level],
+                                               firstName,
+                                               secondName,
+                                               gaussian,
+                                               rawDims,
+                                               this->BlockSizes[level],
+                                               this->BlockSizes[level - 1] / this->BlockSizes[level],
+                                               this->Instrumentation);
+  }
+
+  vtkm::cont::DataSet levelResult;
+  vtkm::Id3 coarseCellDims{ 0 };
+  vtkm::cont::UnknownArrayHandle coarseCrossProb;
+
+  for (std::size_t level = 0; level < numLevels; ++level)
+  {
+    vtkm::IdComponent blockSize = this->BlockSizes[level];
+    const vtkm::cont::DataSet& subsampled = subsampledLevels[level];
+
+    // Only refine the cells whose parent in the previous level may contain the contour.
+    vtkm::Id3 fineCellDims = GetCellDimensions(subsampled);
+    vtkm::Id numFineCells = fineCellDims[0] * fineCellDims[1] * fineCellDims[2];
+    vtkm::cont::ArrayHandle<vtkm::UInt8> activeCellMask;
+    if ((level > 0) && (numFineCells > 0) &&
+        (coarseCellDims[0] > 0) && (coarseCellDims[1] > 0) && (coarseCellDims[2] > 0))
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "refine_mask");
+      RefineCellMask refineWorklet{ fineCellDims,
+                                    coarseCellDims,
+                                    this->BlockSizes[level - 1] / blockSize,
+                                    this->CullThreshold };
+      auto resolveType = [&](const auto& concreteCoarseCrossProb) {
+        this->Invoke(refineWorklet,
+                     vtkm::cont::ArrayHandleIndex(numFineCells),
+                     concreteCoarseCrossProb,
+                     activeCellMask);
+      };
+      coarseCrossProb.CastAndCallForTypes<vtkm::TypeListFieldScalar, vtkm::cont::StorageListBasic>(
+        resolveType);
+      this->NumberOfComputedCells.push_back(vtkm::cont::Algorithm::Reduce(
+        vtkm::cont::make_ArrayHandleCast<vtkm::Id>(activeCellMask), vtkm::Id(0)));
+    }
+    else
+    {
+      this->NumberOfComputedCells.push_back(numFineCells);
+    }
+    this->Instrumentation.AddCount("cells_processed", this->NumberOfComputedCells.back());
+    this->Instrumentation.AddCount("cells_culled",
+                                   numFineCells - this->NumberOfComputedCells.back());
+
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "contour");
+      if (!gaussian)
+      {
+        ContourUncertainUniform contour;
+        contour.SetMinField(firstName);
+        contour.SetMaxField(secondName);
+        contour.SetIsoValue(this->IsoValue);
+        contour.SetActiveCellMask(activeCellMask);
+        contour.SetCrossProbabilityName(this->GetCrossProbabilityName());
+        contour.SetNumberNonzeroProbabilityName(this->GetNumberNonzeroProbabilityName());
+        contour.SetEntropyName(this->GetEntropyName());
+        levelResult = contour.Execute(subsampled);
+      }
+      else
+      {
+        ContourUncertainIndependentGaussian contour;
+        contour.SetMeanField(firstName);
+        contour.SetStdevField(secondName);
+        contour.SetIsoValue(this->IsoValue);
+        contour.SetActiveCellMask(activeCellMask);
+        contour.SetCrossProbabilityName(this->GetCrossProbabilityName());
+        contour.SetNumberNonzeroProbabilityName(this->GetNumberNonzeroProbabilityName());
+        contour.SetEntropyName(this->GetEntropyName());
+        levelResult = contour.Execute(subsampled);
+      }
+    }
+
+    coarseCrossProb = levelResult.GetField(this->GetCrossProbabilityName()).GetData();
+    coarseCellDims = fineCellDims;
+
+    if (this->LevelCallback)
+    {
+      this->LevelCallback(levelResult, static_cast<vtkm::IdComponent>(level));
+    }
+  }
+
+  return levelResult;
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
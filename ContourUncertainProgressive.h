@@ -0,0 +1,190 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_ContourUncertainProgressive_h
+#define vtk_m_filter_uncertainty_ContourUncertainProgressive_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+#include "SubsampleUncertaintyIndependentGaussian.h"
+#include "SubsampleUncertaintyUniform.h"
+
+#include <functional>
+#include <vector>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Computes the probability of the location of a contour with progressive refinement.
+///
+/// This filter subsamples a field into blocks, models the uncertainty of each block (see
+/// `SubsampleUncertaintyUniform` and `SubsampleUncertaintyIndependentGaussian`) and computes
+/// the probability of the contour in each cell of the subsampled grid (see
+/// `ContourUncertainUniform` and `ContourUncertainIndependentGaussian`).
+///
+/// This is done for a sequence of decreasing block sizes (16, 8 and 4 by default). Only the
+/// finest block size subsamples the field, the blocks of each coarser level are merged from
+/// the blocks of the level after it. The first level is computed on a heavily coarsened grid
+/// and is cheap, so it can be shown right away. Each of the following levels only computes the
+/// cells whose parent cell in the previous level has a cross probability above the cull
+/// threshold. Every level is reported through the level callback
+/// as soon as it is computed, and the result of the filter is the finest level.
+///
+class ContourUncertainProgressive : public vtkm::filter::FilterField
+{
+public:
+  enum struct DistributionType
+  {
+    Uniform,
+    IndependentGaussian
+  };
+
+  using LevelCallbackType =
+    std::function<void(const vtkm::cont::DataSet& levelResult, vtkm::IdComponent level)>;
+
+private:
+  std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
+  std::string EntropyName = "entropy";
+  vtkm::Float64 IsoValue = 0.0;
+  DistributionType Distribution = DistributionType::Uniform;
+  std::vector<vtkm::IdComponent> BlockSizes{ 16, 8, 4 };
+  vtkm::Float64 CullThreshold = 0.001;
+  LevelCallbackType LevelCallback;
+
+  // The subsampling of the finest level, which keeps its keys between executions.
+  SubsampleUncertaintyUniform UniformSubsampler;
+  SubsampleUncertaintyIndependentGaussian GaussianSubsampler;
+
+  std::vector<vtkm::Id> NumberOfComputedCells;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT ContourUncertainProgressive();
+
+  ///@{
+  /// Specifies the contour value.
+  VTKM_CONT void SetIsoValue(vtkm::Float64 value) { this->IsoValue = value; }
+  VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
+  ///@}
+
+  ///@{
+  /// Specifies the model used for the uncertainty of each block.
+  VTKM_CONT void SetDistribution(DistributionType distribution)
+  {
+    this->Distribution = distribution;
+  }
+  VTKM_CONT DistributionType GetDistribution() const { return this->Distribution; }
+  ///@}
+
+  ///@{
+  /// \brief Specifies the block sizes of the refinement levels.
+  ///
+  /// The block sizes must be decreasing and each block size must divide the previous one so
+  /// that each cell of a level is covered by a single cell of the previous level.
+  ///
+  VTKM_CONT void SetBlockSizes(const std::vector<vtkm::IdComponent>& blockSizes)
+  {
+    this->BlockSizes = blockSizes;
+  }
+  VTKM_CONT const std::vector<vtkm::IdComponent>& GetBlockSizes() const
+  {
+    return this->BlockSizes;
+  }
+  ///@}
+
+  ///@{
+  /// \brief Specifies the cross probability above which a cell is refined.
+  ///
+  /// A cell of the next level is only computed when its parent cell has a cross probability
+  /// larger than this value. The default of 0.001 skips the cells far from the contour for
+  /// both models. The independent Gaussian probability is never exactly 0, so it needs a
+  /// positive value to skip any cell. A value of 0 is exact for the uniform model.
+  ///
+  VTKM_CONT void SetCullThreshold(vtkm::Float64 value) { this->CullThreshold = value; }
+  VTKM_CONT vtkm::Float64 GetCullThreshold() const { return this->CullThreshold; }
+  ///@}
+
+  ///@{
+  /// \brief Specifies a function called with the result of each level.
+  ///
+  /// The callback is called within the execution of the filter as soon as a level is
+  /// finished. The level is 0 for the coarsest block size.
+  ///
+  VTKM_CONT void SetLevelCallback(const LevelCallbackType& callback)
+  {
+    this->LevelCallback = callback;
+  }
+  ///@}
+
+  /// \brief The number of cells computed in each level by the last execution.
+  VTKM_CONT const std::vector<vtkm::Id>& GetNumberOfComputedCells() const
+  {
+    return this->NumberOfComputedCells;
+  }
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  /// The stages of all the levels are added together. The records of the filters run
+  /// for each level are not included.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the probability of the contour existing
+  /// in each cell.
+  VTKM_CONT void SetCrossProbabilityName(const std::string& name)
+  {
+    this->SetOutputFieldName(name);
+  }
+  VTKM_CONT const std::string& GetCrossProbabilityName() const
+  {
+    return this->GetOutputFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the number of possible marching
+  /// contour cases for each cell.
+  VTKM_CONT void SetNumberNonzeroProbabilityName(const std::string& name)
+  {
+    this->NumberNonzeroProbabilityName = name;
+  }
+  VTKM_CONT const std::string& GetNumberNonzeroProbabilityName() const
+  {
+    return this->NumberNonzeroProbabilityName;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the entropy of the possible
+  /// marching contour cases for each cell.
+  VTKM_CONT void SetEntropyName(const std::string& name) { this->EntropyName = name; }
+  VTKM_CONT const std::string& GetEntropyName() const { return this->EntropyName; }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_ContourUncertainProgressive_h
@@ -0,0 +1,93 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "ContourUncertainSeparableGaussian.h"
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+
+#include "ucvworklet/SeparableGaussianSampling.hpp"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+ContourUncertainSeparableGaussian::ContourUncertainSeparableGaussian()
+{
+  this->SetCrossProbabilityName("cross_probability");
+}
+
+vtkm::cont::DataSet ContourUncertainSeparableGaussian::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field meanField = this->GetFieldFromDataSet(0, input);
+  vtkm::cont::Field stdevField = this->GetFieldFromDataSet(1, input);
+  vtkm::cont::Field correlationField = this->GetFieldFromDataSet(2, input);
+
+  vtkm::cont::UnknownArrayHandle crossProbability;
+  vtkm::cont::UnknownArrayHandle numNonZeroProbability;
+  vtkm::cont::UnknownArrayHandle entropy;
+
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorBadType("Uncertain contour only works for CellSetStructured<3>.");
+  }
+  vtkm::cont::CellSetStructured<3> cellSet;
+  input.GetCellSet().AsCellSet(cellSet);
+
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> correlation;
+  vtkm::cont::ArrayCopyShallowIfPossible(correlationField.GetData(), correlation);
+
+  auto resolveType = [&](auto concreteMeanField) {
+    using ArrayType = std::decay_t<decltype(concreteMeanField)>;
+    using ValueType = typename ArrayType::ValueType;
+    ArrayType concreteStdevField;
+    vtkm::cont::ArrayCopyShallowIfPossible(stdevField.GetData(), concreteStdevField);
+
+    vtkm::cont::ArrayHandle<ValueType> concreteCrossProb;
+    vtkm::cont::ArrayHandle<vtkm::Id> concreteNumNonZeroProb;
+    vtkm::cont::ArrayHandle<ValueType> concreteEntropy;
+
+    this->Invoke(SeparableGaussianSampling{ this->IsoValue, static_cast<int>(this->NumberOfSamples) },
+                 cellSet,
+                 concreteMeanField,
+                 concreteStdevField,
+                 correlation,
+                 concreteCrossProb,
+                 concreteNumNonZeroProb,
+                 concreteEntropy);
+
+    this->Instrumentation.AddBytes(
+      "output", cellSet.GetNumberOfCells() * (2 * sizeof(ValueType) + sizeof(vtkm::Id)));
+
+    crossProbability = concreteCrossProb;
+    numNonZeroProbability = concreteNumNonZeroProb;
+    entropy = concreteEntropy;
+  };
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "sampling");
+    this->CastAndCallScalarField(meanField, resolveType);
+  }
+
+  this->Instrumentation.AddCount("cells_processed", cellSet.GetNumberOfCells());
+
+  vtkm::cont::DataSet result = this->CreateResult(input);
+  result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
+  result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
+  result.AddCellField(this->GetEntropyName(), entropy);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
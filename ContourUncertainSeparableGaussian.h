@@ -0,0 +1,130 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_ContourUncertainSeparableGaussian_h
+#define vtk_m_filter_uncertainty_ContourUncertainSeparableGaussian_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Computes the probability of the location of a contour.
+///
+/// Like `ContourUncertainUniform`, this filter writes a cell field giving the probability
+/// of a contour being in each cell, the number of possible contour cases and their entropy.
+///
+/// This filter uses a correlated gaussian model that is much cheaper than the multivariant
+/// gaussian of `ContourUncertainEnsemble`. Instead of the 64 values of the ensemble of each
+/// point and the factorization of an 8 by 8 covariance matrix per cell, it uses the mean and
+/// the standard deviation of each point and the correlation with its next point along x, y
+/// and z (see `SubsampleUncertaintyIndependentGaussian::SetComputeCorrelation`). In each
+/// cell, the correlation along an axis is the mean of the 4 edges along this axis, and the
+/// correlation of two points is the product of the correlations along the axes they differ
+/// on. This matrix is a kronecker product of 2 by 2 matrices, so the samples are drawn by
+/// applying their 2 by 2 factors axis by axis.
+///
+class ContourUncertainSeparableGaussian : public vtkm::filter::FilterField
+{
+  std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
+  std::string EntropyName = "entropy";
+  vtkm::Float64 IsoValue = 0.0;
+  vtkm::Id NumberOfSamples = 1000;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT ContourUncertainSeparableGaussian();
+
+  ///@{
+  /// Specifies the fields with the mean, the standard deviation and the correlation with
+  /// the next point along x, y and z (a `Vec3f`).
+  VTKM_CONT void SetMeanField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetStdevField(const std::string& fieldName)
+  {
+    this->SetActiveField(1, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  VTKM_CONT void SetCorrelationField(const std::string& fieldName)
+  {
+    this->SetActiveField(2, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the contour value.
+  VTKM_CONT void SetIsoValue(vtkm::Float64 value) { this->IsoValue = value; }
+  VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
+  ///@}
+
+  ///@{
+  /// The number of samples drawn per cell.
+  VTKM_CONT void SetNumberOfSamples(vtkm::Id numSamples) { this->NumberOfSamples = numSamples; }
+  VTKM_CONT vtkm::Id GetNumberOfSamples() const { return this->NumberOfSamples; }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the probability of the contour existing
+  /// in each cell.
+  VTKM_CONT void SetCrossProbabilityName(const std::string& name)
+  {
+    this->SetOutputFieldName(name);
+  }
+  VTKM_CONT const std::string& GetCrossProbabilityName() const
+  {
+    return this->GetOutputFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the number of possible marching
+  /// contour cases for each cell.
+  VTKM_CONT void SetNumberNonzeroProbabilityName(const std::string& name)
+  {
+    this->NumberNonzeroProbabilityName = name;
+  }
+  VTKM_CONT const std::string& GetNumberNonzeroProbabilityName() const
+  {
+    return this->NumberNonzeroProbabilityName;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field that captures the entropy of the possible
+  /// marching contour cases for each cell.
+  VTKM_CONT void SetEntropyName(const std::string& name) { this->EntropyName = name; }
+  VTKM_CONT const std::string& GetEntropyName() const { return this->EntropyName; }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_ContourUncertainSeparableGaussian_h
@@ -10,10 +10,16 @@
 
 #include "ContourUncertainUniform.h"
 
+#include <vtkm/cont/Algorithm.h>
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleCast.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/Timer.h>
 
+#include "ucvworklet/EntropyFromPointProbability.hpp"
 #include "ucvworklet/EntropyUniform.hpp"
+#include "ucvworklet/UniformPointProbability.hpp"
 
 namespace vtkm
 {
@@ -35,6 +41,7 @@ vtkm::cont::DataSet ContourUncertainUniform::DoExecute(const vtkm::cont::DataSet
   vtkm::cont::UnknownArrayHandle crossProbability;
   vtkm::cont::UnknownArrayHandle numNonZeroProbability;
   vtkm::cont::UnknownArrayHandle entropy;
+  vtkm::cont::UnknownArrayHandle pointProbability;
 
   if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
   {
@@ -43,6 +50,12 @@ vtkm::cont::DataSet ContourUncertainUniform::DoExecute(const vtkm::cont::DataSet
   vtkm::cont::CellSetStructured<3> cellSet;
   input.GetCellSet().AsCellSet(cellSet);
 
+  if ((this->ActiveCellMask.GetNumberOfValues() > 0) &&
+      (this->ActiveCellMask.GetNumberOfValues() != cellSet.GetNumberOfCells()))
+  {
+    throw vtkm::cont::ErrorBadValue("The active cell mask does not match the number of cells.");
+  }
+
   auto resolveType = [&](auto concreteMinField) {
     using ArrayType = std::decay_t<decltype(concreteMinField)>;
     using ValueType = typename ArrayType::ValueType;
@@ -53,13 +66,99 @@ vtkm::cont::DataSet ContourUncertainUniform::DoExecute(const vtkm::cont::DataSet
     vtkm::cont::ArrayHandle<vtkm::Id> concreteNumNonZeroProb;
     vtkm::cont::ArrayHandle<ValueType> concreteEntropy;
 
-    this->Invoke(EntropyUniform{ this->IsoValue },
-                 cellSet,
-                 concreteMinField,
-                 concreteMaxField,
-                 concreteCrossProb,
-                 concreteNumNonZeroProb,
-                 concreteEntropy);
+    // Pr[X <= isovalue] of each point
+    if (this->PointCentric)
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "point_probability");
+      if (this->QuantizePointProbability)
+      {
+        vtkm::cont::ArrayHandle<vtkm::UInt8> pointNegativeProb;
+        this->Invoke(UniformPointProbability{ this->IsoValue },
+                     concreteMinField,
+                     concreteMaxField,
+                     pointNegativeProb);
+        pointProbability = pointNegativeProb;
+      }
+      else
+      {
+        vtkm::cont::ArrayHandle<vtkm::FloatDefault> pointNegativeProb;
+        this->Invoke(UniformPointProbability{ this->IsoValue },
+                     concreteMinField,
+                     concreteMaxField,
+                     pointNegativeProb);
+        pointProbability = pointNegativeProb;
+      }
+      this->Instrumentation.AddBytes("point_probability",
+                                     pointProbability.GetNumberOfValues() *
+                                       (this->QuantizePointProbability
+                                          ? sizeof(vtkm::UInt8)
+                                          : sizeof(vtkm::FloatDefault)));
+    }
+
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "entropy");
+    if (this->ActiveCellMask.GetNumberOfValues() > 0)
+    {
+      // The cells that are not selected are known to not contain the contour.
+      vtkm::Id numCells = cellSet.GetNumberOfCells();
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(ValueType(0), numCells),
+                            concreteCrossProb);
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(vtkm::Id(1), numCells),
+                            concreteNumNonZeroProb);
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(ValueType(0), numCells),
+                            concreteEntropy);
+
+      if (this->PointCentric)
+      {
+        pointProbability
+          .CastAndCallForTypes<vtkm::List<vtkm::UInt8, vtkm::FloatDefault>,
+                               VTKM_DEFAULT_STORAGE_LIST>([&](const auto& pointNegativeProb) {
+            this->Invoke(EntropyFromPointProbabilityMasked{},
+                         vtkm::worklet::MaskSelect(this->ActiveCellMask),
+                         cellSet,
+                         pointNegativeProb,
+                         concreteCrossProb,
+                         concreteNumNonZeroProb,
+                         concreteEntropy);
+          });
+      }
+      else
+      {
+        this->Invoke(EntropyUniformMasked{ this->IsoValue },
+                     vtkm::worklet::MaskSelect(this->ActiveCellMask),
+                     cellSet,
+                     concreteMinField,
+                     concreteMaxField,
+                     concreteCrossProb,
+                     concreteNumNonZeroProb,
+                     concreteEntropy);
+      }
+    }
+    else if (this->PointCentric)
+    {
+      pointProbability
+        .CastAndCallForTypes<vtkm::List<vtkm::UInt8, vtkm::FloatDefault>,
+                             VTKM_DEFAULT_STORAGE_LIST>([&](const auto& pointNegativeProb) {
+          this->Invoke(EntropyFromPointProbability{},
+                       cellSet,
+                       pointNegativeProb,
+                       concreteCrossProb,
+                       concreteNumNonZeroProb,
+                       concreteEntropy);
+        });
+    }
+    else
+    {
+      this->Invoke(EntropyUniform{ this->IsoValue },
+                   cellSet,
+                   concreteMinField,
+                   concreteMaxField,
+                   concreteCrossProb,
+                   concreteNumNonZeroProb,
+                   concreteEntropy);
+    }
+
+    this->Instrumentation.AddBytes(
+      "output", cellSet.GetNumberOfCells() * (2 * sizeof(ValueType) + sizeof(vtkm::Id)));
 
     crossProbability = concreteCrossProb;
     numNonZeroProbability = concreteNumNonZeroProb;
@@ -67,10 +166,27 @@ vtkm::cont::DataSet ContourUncertainUniform::DoExecute(const vtkm::cont::DataSet
   };
   this->CastAndCallScalarField(minField, resolveType);
 
+  if (this->Instrumentation.GetEnabled())
+  {
+    vtkm::Id numCells = cellSet.GetNumberOfCells();
+    vtkm::Id numProcessed = numCells;
+    if (this->ActiveCellMask.GetNumberOfValues() > 0)
+    {
+      numProcessed = vtkm::cont::Algorithm::Reduce(
+        vtkm::cont::make_ArrayHandleCast<vtkm::Id>(this->ActiveCellMask), vtkm::Id(0));
+    }
+    this->Instrumentation.AddCount("cells_processed", numProcessed);
+    this->Instrumentation.AddCount("cells_culled", numCells - numProcessed);
+  }
+
   vtkm::cont::DataSet result = this->CreateResult(input);
   result.AddCellField(this->GetCrossProbabilityName(), crossProbability);
   result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProbability);
   result.AddCellField(this->GetEntropyName(), entropy);
+  if (this->PointCentric && !this->PointProbabilityName.empty())
+  {
+    result.AddPointField(this->PointProbabilityName, pointProbability);
+  }
   return result;
 }
 
@@ -10,8 +10,11 @@
 #ifndef vtk_m_filter_uncertainty_ContourUncertainUniform_h
 #define vtk_m_filter_uncertainty_ContourUncertainUniform_h
 
+#include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/filter/FilterField.h>
 
+#include "FilterInstrumentation.h"
+
 namespace vtkm
 {
 namespace filter
@@ -35,6 +38,11 @@ class ContourUncertainUniform : public vtkm::filter::FilterField
   std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
   std::string EntropyName = "entropy";
   vtkm::Float64 IsoValue = 0.0;
+  std::string PointProbabilityName;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> ActiveCellMask;
+  bool PointCentric = true;
+  bool QuantizePointProbability = false;
+  FilterInstrumentation Instrumentation;
 
 public:
   VTKM_CONT ContourUncertainUniform();
@@ -58,6 +66,84 @@ public:
   VTKM_CONT vtkm::Float64 GetIsoValue() const { return this->IsoValue; }
   ///@}
 
+  ///@{
+  /// \brief Restricts the computation to a subset of the cells.
+  ///
+  /// When a mask is given, it must have one value per cell of the input. Only the cells
+  /// with a nonzero mask value are computed. The other cells are reported as certain to
+  /// not contain the contour (a cross probability and entropy of 0 with a single possible
+  /// case). This is used to refine a coarse result, where most of the cells are already
+  /// known to be away from the contour. An empty mask (the default) computes all cells.
+  ///
+  VTKM_CONT void SetActiveCellMask(const vtkm::cont::ArrayHandle<vtkm::UInt8>& mask)
+  {
+    this->ActiveCellMask = mask;
+  }
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::UInt8>& GetActiveCellMask() const
+  {
+    return this->ActiveCellMask;
+  }
+  VTKM_CONT void ClearActiveCellMask()
+  {
+    this->ActiveCellMask = vtkm::cont::ArrayHandle<vtkm::UInt8>{};
+  }
+  ///@}
+
+  ///@{
+  /// \brief Computes the probability of each point once before the cells.
+  ///
+  /// Each point is shared by 8 cells. When on (the default), a first pass computes
+  /// Pr[X <= isovalue] once per point and the cells only gather the probabilities of their
+  /// points. When off, each cell evaluates the probabilities of its 8 points.
+  ///
+  VTKM_CONT void SetPointCentric(bool flag) { this->PointCentric = flag; }
+  VTKM_CONT bool GetPointCentric() const { return this->PointCentric; }
+  ///@}
+
+  ///@{
+  /// \brief Stores the point probabilities with 8 bits.
+  ///
+  /// The probability of a point is rounded to a multiple of 1/255, which divides the memory
+  /// read by the cells by 4 (or 8 with 64 bit floats). The points that are certainly on one
+  /// side of the isovalue keep an exact probability of 0 or 1, the error of the other
+  /// points is below 1/510. Only used when the probabilities are point centric.
+  ///
+  VTKM_CONT void SetQuantizePointProbability(bool flag)
+  {
+    this->QuantizePointProbability = flag;
+  }
+  VTKM_CONT bool GetQuantizePointProbability() const { return this->QuantizePointProbability; }
+  ///@}
+
+  ///@{
+  /// \brief Adds the point probabilities to the output.
+  ///
+  /// When a name is given, the probability Pr[X <= isovalue] of each point is added as a
+  /// point field, so that other filters (for example on another cell type) can reuse it
+  /// with `EntropyFromPointProbability` without reading the min and max fields again. It
+  /// is a `UInt8` field when the probabilities are quantized. An empty name (the default)
+  /// does not add it. Only used when the probabilities are point centric.
+  ///
+  VTKM_CONT void SetPointProbabilityName(const std::string& name)
+  {
+    this->PointProbabilityName = name;
+  }
+  VTKM_CONT const std::string& GetPointProbabilityName() const
+  {
+    return this->PointProbabilityName;
+  }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
   ///@{
   /// Specifies the name of the output field that captures the probability of the contour existing
   /// in each cell.
@@ -0,0 +1,174 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "EnsembleAccumulator.h"
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/cont/ErrorBadValue.h>
+
+#include "ucvworklet/WelfordUpdate.hpp"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+VTKM_CONT void EnsembleAccumulator::SetComputeCorrelation(bool flag)
+{
+  if ((flag != this->ComputeCorrelation) && (this->NumberOfMembers > 0))
+  {
+    throw vtkm::cont::ErrorBadValue(
+      "The correlation must be enabled or disabled before the first member is added.");
+  }
+  this->ComputeCorrelation = flag;
+}
+
+VTKM_CONT void EnsembleAccumulator::AddMember(const vtkm::cont::DataSet& member,
+                                              const std::string& fieldName)
+{
+  vtkm::Id3 pointDims;
+  if (member.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    vtkm::cont::CellSetStructured<3> cellSet;
+    member.GetCellSet().AsCellSet(cellSet);
+    pointDims = cellSet.GetPointDimensions();
+  }
+  else if (member.GetCellSet().IsType<vtkm::cont::CellSetStructured<2>>())
+  {
+    vtkm::cont::CellSetStructured<2> cellSet;
+    member.GetCellSet().AsCellSet(cellSet);
+    vtkm::Id2 dims = cellSet.GetPointDimensions();
+    pointDims = vtkm::Id3(dims[0], dims[1], 1);
+  }
+  else
+  {
+    throw vtkm::cont::ErrorBadType(
+      "Ensemble accumulation only works for CellSetStructured<2> and CellSetStructured<3>.");
+  }
+  this->AddMember(member.GetPointField(fieldName).GetData(), pointDims);
+}
+
+VTKM_CONT void EnsembleAccumulator::AddMember(const vtkm::cont::UnknownArrayHandle& values,
+                                              const vtkm::Id3& pointDimensions)
+{
+  vtkm::Id numPoints = pointDimensions[0] * pointDimensions[1] * pointDimensions[2];
+  if (values.GetNumberOfValues() != numPoints)
+  {
+    throw vtkm::cont::ErrorBadValue("The member does not match the point dimensions.");
+  }
+
+  if (this->NumberOfMembers == 0)
+  {
+    this->PointDimensions = pointDimensions;
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(vtkm::FloatDefault(0), numPoints),
+                          this->Mean);
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(vtkm::FloatDefault(0), numPoints),
+                          this->M2);
+    if (this->ComputeCorrelation)
+    {
+      vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(vtkm::Vec3f(0), numPoints),
+                            this->CoMoment);
+    }
+    this->Instrumentation.AddBytes(
+      "accumulator",
+      numPoints * (2 * sizeof(vtkm::FloatDefault) + (this->ComputeCorrelation ? sizeof(vtkm::Vec3f) : 0)));
+  }
+  else if (this->PointDimensions != pointDimensions)
+  {
+    throw vtkm::cont::ErrorBadValue("The member does not match the previous members.");
+  }
+
+  this->NumberOfMembers++;
+  FilterInstrumentation::ScopedStage stage(this->Instrumentation, "accumulate");
+  auto resolveType = [&](const auto& concreteValues) {
+    // The co-moments use the means of the previous members.
+    if (this->ComputeCorrelation)
+    {
+      this->Invoke(WelfordCoMomentUpdate{ this->PointDimensions, this->NumberOfMembers },
+                   vtkm::cont::ArrayHandleIndex(numPoints),
+                   concreteValues,
+                   this->Mean,
+                   this->CoMoment);
+    }
+    this->Invoke(WelfordUpdate{ this->NumberOfMembers }, concreteValues, this->Mean, this->M2);
+  };
+  values.CastAndCallForTypesWithFloatFallback<vtkm::TypeListFieldScalar, VTKM_DEFAULT_STORAGE_LIST>(
+    resolveType);
+  this->Instrumentation.AddCount("members", 1);
+}
+
+VTKM_CONT vtkm::cont::ArrayHandle<vtkm::FloatDefault> EnsembleAccumulator::ComputeStdev()
+{
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> stdev;
+  if (this->NumberOfMembers > 0)
+  {
+    this->Invoke(WelfordStdev{ this->NumberOfMembers }, this->M2, stdev);
+  }
+  return stdev;
+}
+
+VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Vec3f> EnsembleAccumulator::ComputeNeighborCorrelation()
+{
+  if (!this->ComputeCorrelation)
+  {
+    throw vtkm::cont::ErrorBadValue("The co-moments of the neighboring points are not accumulated.");
+  }
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> correlation;
+  if (this->NumberOfMembers > 0)
+  {
+    this->Invoke(WelfordCorrelation{ this->PointDimensions },
+                 vtkm::cont::ArrayHandleIndex(this->CoMoment.GetNumberOfValues()),
+                 this->CoMoment,
+                 this->M2,
+                 correlation);
+  }
+  return correlation;
+}
+
+VTKM_CONT void EnsembleAccumulator::AddFields(vtkm::cont::DataSet& dataset,
+                                              const std::string& fieldName)
+{
+  if (this->NumberOfMembers == 0)
+  {
+    throw vtkm::cont::ErrorBadValue("No member was added to the ensemble.");
+  }
+  if (dataset.GetNumberOfPoints() != this->Mean.GetNumberOfValues())
+  {
+    throw vtkm::cont::ErrorBadValue("The data set does not match the members.");
+  }
+  // The mean is copied, the next members update this->Mean in place.
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> mean;
+  vtkm::cont::ArrayCopy(this->Mean, mean);
+  dataset.AddPointField(fieldName + this->MeanSuffix, mean);
+  dataset.AddPointField(fieldName + this->StdevSuffix, this->ComputeStdev());
+  if (this->ComputeCorrelation)
+  {
+    dataset.AddPointField(fieldName + this->CorrelationSuffix, this->ComputeNeighborCorrelation());
+  }
+}
+
+VTKM_CONT void EnsembleAccumulator::Reset()
+{
+  this->NumberOfMembers = 0;
+  this->PointDimensions = vtkm::Id3(0);
+  this->Mean.ReleaseResources();
+  this->M2.ReleaseResources();
+  this->CoMoment.ReleaseResources();
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
@@ -0,0 +1,137 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_EnsembleAccumulator_h
+#define vtk_m_filter_uncertainty_EnsembleAccumulator_h
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/UnknownArrayHandle.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Accumulates the statistics of an ensemble whose members arrive one at a time.
+///
+/// The subsampling filters need all the values at once. In situ, the members of an
+/// ensemble are produced one after the other by the simulation. This object keeps, for
+/// each point of the grid, the number of members, the mean and the sum of the squared
+/// offsets to the mean (M2), and updates them in place with the algorithm of Welford when
+/// a member is added. The members do not need to be stored and the statistics can be
+/// read at any time.
+///
+/// `AddFields` writes the mean and the standard deviation of each point with the same
+/// suffixes as `SubsampleUncertaintyIndependentGaussian`, so the result can be given to
+/// `ContourUncertainIndependentGaussian`. When `SetComputeCorrelation` is on, the
+/// co-moments of each point with its next point along x, y and z are also accumulated, and
+/// the correlation field can be given to `ContourUncertainSeparableGaussian`.
+///
+class EnsembleAccumulator
+{
+  std::string MeanSuffix = "_mean";
+  std::string StdevSuffix = "_stdev";
+  std::string CorrelationSuffix = "_correlation";
+  bool ComputeCorrelation = false;
+
+  vtkm::Id NumberOfMembers = 0;
+  vtkm::Id3 PointDimensions{ 0 };
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> Mean;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> M2;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> CoMoment;
+
+  vtkm::cont::Invoker Invoke;
+  FilterInstrumentation Instrumentation;
+
+public:
+  EnsembleAccumulator() = default;
+
+  ///@{
+  /// \brief The suffixes of the fields written by `AddFields`.
+  ///
+  VTKM_CONT void SetMeanSuffix(const std::string& suffix) { this->MeanSuffix = suffix; }
+  VTKM_CONT const std::string& GetMeanSuffix() const { return this->MeanSuffix; }
+  VTKM_CONT void SetStdevSuffix(const std::string& suffix) { this->StdevSuffix = suffix; }
+  VTKM_CONT const std::string& GetStdevSuffix() const { return this->StdevSuffix; }
+  VTKM_CONT void SetCorrelationSuffix(const std::string& suffix)
+  {
+    this->CorrelationSuffix = suffix;
+  }
+  VTKM_CONT const std::string& GetCorrelationSuffix() const { return this->CorrelationSuffix; }
+  ///@}
+
+  ///@{
+  /// \brief Also accumulates the co-moments of the neighboring points.
+  ///
+  /// This adds 3 values per point and must be set before the first member is added (or
+  /// after `Reset`), otherwise an `ErrorBadValue` is thrown. Off by default.
+  ///
+  VTKM_CONT void SetComputeCorrelation(bool flag);
+  VTKM_CONT bool GetComputeCorrelation() const { return this->ComputeCorrelation; }
+  ///@}
+
+  /// \brief Adds the values of a member.
+  ///
+  /// The field must be a scalar point field of a `CellSetStructured<3>` (or 2D) with the
+  /// same number of points as the previous members.
+  VTKM_CONT void AddMember(const vtkm::cont::DataSet& member, const std::string& fieldName);
+
+  /// \brief Adds the values of a member on a grid of the given point dimensions.
+  VTKM_CONT void AddMember(const vtkm::cont::UnknownArrayHandle& values,
+                           const vtkm::Id3& pointDimensions);
+
+  /// The number of members added since the creation or the last `Reset`.
+  VTKM_CONT vtkm::Id GetNumberOfMembers() const { return this->NumberOfMembers; }
+
+  ///@{
+  /// The accumulated mean and M2 of each point.
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::FloatDefault>& GetMean() const
+  {
+    return this->Mean;
+  }
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::FloatDefault>& GetM2() const { return this->M2; }
+  ///@}
+
+  /// The standard deviation of each point (M2 divided by the number of members).
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::FloatDefault> ComputeStdev();
+
+  /// The correlation of each point with its next point along x, y and z.
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Vec3f> ComputeNeighborCorrelation();
+
+  /// \brief Adds the mean, the standard deviation (and the correlation) as point fields.
+  ///
+  /// The fields are named `fieldName` followed by the suffixes. The data set must have the
+  /// same points as the members.
+  VTKM_CONT void AddFields(vtkm::cont::DataSet& dataset, const std::string& fieldName);
+
+  /// Forgets all the members.
+  VTKM_CONT void Reset();
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this object.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_EnsembleAccumulator_h
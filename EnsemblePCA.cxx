@@ -0,0 +1,201 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "EnsemblePCA.h"
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleDiscard.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleTransform.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Invoker.h>
+
+#include "ucvworklet/ExtractingEnsembleStatistics.hpp"
+#include "ucvworklet/ProjectingEnsemble.hpp"
+#include "ucvworklet/linalg/ucv_symmetric_eigen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+
+// The number of points summed by one work item of the gram matrix.
+constexpr vtkm::Id GramChunkSize = 4096;
+
+template <vtkm::IdComponent Rank, typename CenteredArrayType>
+VTKM_CONT vtkm::cont::UnknownArrayHandle ComputeCoefficients(
+  const CenteredArrayType& centered,
+  const vtkm::cont::ArrayHandle<vtkm::Float64>& basis,
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault>& residual)
+{
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, Rank>> coefficients;
+  invoke(ProjectingEnsemble<Rank>{}, centered, basis, coefficients, residual);
+  return coefficients;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+vtkm::cont::DataSet EnsemblePCA::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field ensembleField = this->GetFieldFromDataSet(0, input);
+  vtkm::cont::UnknownArrayHandle inArray = ensembleField.GetData();
+  vtkm::Id numPoints = inArray.GetNumberOfValues();
+  vtkm::IdComponent numMembers = inArray.GetNumberOfComponentsFlat();
+
+  if ((this->Rank != 2) && (this->Rank != 4) && (this->Rank != 8))
+  {
+    throw vtkm::cont::ErrorBadValue("The rank of the principal component analysis must be 2, 4 or 8.");
+  }
+  if (this->Rank >= numMembers)
+  {
+    throw vtkm::cont::ErrorBadValue("The rank must be smaller than the number of members.");
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> meanArray;
+  vtkm::cont::UnknownArrayHandle coefficientsArray;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> residualArray;
+
+  auto resolveType = [&](const auto& concreteEnsemble) {
+    // The centered members keep the floating point components of the input.
+    using ValueType = typename std::decay_t<decltype(concreteEnsemble)>::ValueType;
+    using ComponentType = typename vtkm::VecTraits<ValueType>::ComponentType;
+    using CenteredType = typename std::
+      conditional<std::is_floating_point<ComponentType>::value, ComponentType, vtkm::FloatDefault>::type;
+    vtkm::cont::UnknownArrayHandle centeredArray = inArray.NewInstanceFloatBasic();
+    // These allocations are not necessary in the most recent version of VTK-m.
+    centeredArray.Allocate(numPoints);
+    auto centered = centeredArray.ExtractArrayFromComponents<CenteredType>();
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "center");
+      this->Invoke(ExtractingEnsembleStatistics{},
+                   concreteEnsemble,
+                   vtkm::cont::ArrayHandleDiscard<vtkm::FloatDefault>{},
+                   vtkm::cont::ArrayHandleDiscard<vtkm::FloatDefault>{},
+                   meanArray,
+                   vtkm::cont::ArrayHandleDiscard<vtkm::FloatDefault>{});
+      this->Invoke(ExtractingEnsembleCentered{}, concreteEnsemble, meanArray, centered);
+    }
+    this->Instrumentation.AddBytes("centered", numPoints * numMembers * sizeof(CenteredType));
+
+    // The gram matrix of the members, each entry is a sum over all the points. The points
+    // are split in chunks and one work item sums one entry over one chunk, so all the entries
+    // are computed by one invoke and one reduction, without an array of the size of the grid.
+    std::vector<vtkm::Float64> gram(numMembers * numMembers);
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "gram");
+      vtkm::Id numPairs = numMembers * (numMembers + 1) / 2;
+      vtkm::Id numChunks = std::max<vtkm::Id>(1, (numPoints + GramChunkSize - 1) / GramChunkSize);
+      vtkm::cont::ArrayHandle<vtkm::Float64> partialSums;
+      this->Invoke(EnsembleGramPartialSum{ numMembers, numPoints, numChunks },
+                   vtkm::cont::ArrayHandleIndex(numPairs * numChunks),
+                   centered,
+                   partialSums);
+
+      vtkm::cont::ArrayHandle<vtkm::Id> pairs;
+      vtkm::cont::ArrayHandle<vtkm::Float64> sums;
+      vtkm::cont::Algorithm::ReduceByKey(
+        vtkm::cont::make_ArrayHandleTransform(vtkm::cont::ArrayHandleIndex(numPairs * numChunks),
+                                              GramPairOfPartialSum{ numChunks }),
+        partialSums,
+        pairs,
+        sums,
+        vtkm::Add());
+
+      auto sumsPortal = sums.ReadPortal();
+      vtkm::Id pair = 0;
+      for (vtkm::IdComponent a = 0; a < numMembers; a++)
+      {
+        for (vtkm::IdComponent b = a; b < numMembers; b++)
+        {
+          gram[a * numMembers + b] = sumsPortal.Get(pair);
+          gram[b * numMembers + a] = sumsPortal.Get(pair);
+          pair++;
+        }
+      }
+      this->Instrumentation.AddBytes("gram", numPairs * numChunks * sizeof(vtkm::Float64));
+    }
+
+    // The principal directions are the eigenvectors with the largest eigenvalues.
+    std::vector<vtkm::Float64> basisValues(numMembers * this->Rank);
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "eigen");
+      std::vector<vtkm::Float64> eigenValues;
+      std::vector<vtkm::Float64> eigenVectors;
+      UCVMATH::SymmetricEigen(gram, numMembers, eigenValues, eigenVectors);
+
+      std::vector<vtkm::IdComponent> order(numMembers);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](vtkm::IdComponent i, vtkm::IdComponent j) {
+        return eigenValues[i] > eigenValues[j];
+      });
+
+      vtkm::Float64 total = std::accumulate(eigenValues.begin(), eigenValues.end(), 0.0);
+      vtkm::Float64 kept = 0;
+      vtkm::Float64 scale = 1.0 / std::sqrt(static_cast<vtkm::Float64>(numMembers - 1));
+      for (vtkm::IdComponent r = 0; r < this->Rank; r++)
+      {
+        kept += eigenValues[order[r]];
+        for (vtkm::IdComponent m = 0; m < numMembers; m++)
+        {
+          basisValues[m * this->Rank + r] = eigenVectors[m * numMembers + order[r]] * scale;
+        }
+      }
+      this->ExplainedVariance = (total > 0) ? kept / total : 1.0;
+    }
+    vtkm::cont::ArrayHandle<vtkm::Float64> basis =
+      vtkm::cont::make_ArrayHandle(basisValues, vtkm::CopyFlag::On);
+
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "project");
+      switch (this->Rank)
+      {
+        case 2:
+          coefficientsArray = ComputeCoefficients<2>(centered, basis, residualArray);
+          break;
+        case 4:
+          coefficientsArray = ComputeCoefficients<4>(centered, basis, residualArray);
+          break;
+        default:
+          coefficientsArray = ComputeCoefficients<8>(centered, basis, residualArray);
+          break;
+      }
+    }
+  };
+  inArray.CastAndCallWithExtractedArray(resolveType);
+
+  this->Instrumentation.AddCount("points_processed", numPoints);
+  this->Instrumentation.AddCount("members", numMembers);
+  this->Instrumentation.AddBytes("output",
+                                 numPoints * (2 + this->Rank) * sizeof(vtkm::FloatDefault));
+
+  std::string fieldName = ensembleField.GetName();
+  vtkm::cont::DataSet result = this->CreateResult(input);
+  result.AddPointField(fieldName + this->MeanSuffix, meanArray);
+  result.AddPointField(fieldName + this->CoefficientsSuffix, coefficientsArray);
+  result.AddPointField(fieldName + this->ResidualSuffix, residualArray);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
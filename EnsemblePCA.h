@@ -0,0 +1,104 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_EnsemblePCA_h
+#define vtk_m_filter_uncertainty_EnsemblePCA_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Compresses an ensemble to its mean and its first principal components.
+///
+/// The multivariant gaussian filters keep all the members of each point (20 to 100 values)
+/// and build the covariance matrix of each cell from them. This filter computes a principal
+/// component analysis of the whole ensemble and keeps, for each point, the mean of the
+/// members, `Rank` coefficients and a residual variance. The covariance of two points is
+/// then approximated by the dot product of their coefficients, plus the residual on the
+/// diagonal (`U U^T + D`). `ContourUncertainEnsembleLowRank` samples the cells directly
+/// from these factors.
+///
+/// The principal directions are the eigenvectors of the gram matrix of the centered members
+/// (a matrix of the size of the number of members, not of the number of points), so they
+/// are shared by all the points. The output fields are the name of the ensemble field
+/// followed by `_mean`, `_pca` (a `Vec` of `Rank` values) and `_residual`.
+///
+class EnsemblePCA : public vtkm::filter::FilterField
+{
+  std::string MeanSuffix = "_mean";
+  std::string CoefficientsSuffix = "_pca";
+  std::string ResidualSuffix = "_residual";
+  vtkm::IdComponent Rank = 4;
+  vtkm::Float64 ExplainedVariance = 0.0;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT EnsemblePCA() = default;
+
+  ///@{
+  /// Specifies the field with the members of each point.
+  VTKM_CONT void SetEnsembleField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// \brief The number of principal components kept for each point, 2, 4 (the default) or 8.
+  ///
+  /// The rank must be smaller than the number of members.
+  ///
+  VTKM_CONT void SetRank(vtkm::IdComponent rank) { this->Rank = rank; }
+  VTKM_CONT vtkm::IdComponent GetRank() const { return this->Rank; }
+  ///@}
+
+  ///@{
+  /// \brief The suffixes of the output fields.
+  ///
+  VTKM_CONT void SetMeanSuffix(const std::string& suffix) { this->MeanSuffix = suffix; }
+  VTKM_CONT const std::string& GetMeanSuffix() const { return this->MeanSuffix; }
+  VTKM_CONT void SetCoefficientsSuffix(const std::string& suffix)
+  {
+    this->CoefficientsSuffix = suffix;
+  }
+  VTKM_CONT const std::string& GetCoefficientsSuffix() const { return this->CoefficientsSuffix; }
+  VTKM_CONT void SetResidualSuffix(const std::string& suffix) { this->ResidualSuffix = suffix; }
+  VTKM_CONT const std::string& GetResidualSuffix() const { return this->ResidualSuffix; }
+  ///@}
+
+  /// The fraction of the variance of the ensemble captured by the kept components in the
+  /// last execution.
+  VTKM_CONT vtkm::Float64 GetExplainedVariance() const { return this->ExplainedVariance; }
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_EnsemblePCA_h
@@ -0,0 +1,84 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "EnsembleStatistics.h"
+
+#include "ucvworklet/ExtractingEnsembleStatistics.hpp"
+
+#include <type_traits>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+vtkm::cont::DataSet EnsembleStatistics::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field ensembleField = this->GetFieldFromDataSet(0, input);
+  vtkm::cont::UnknownArrayHandle inArray = ensembleField.GetData();
+  vtkm::Id numPoints = inArray.GetNumberOfValues();
+
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> minArray;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> maxArray;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> meanArray;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> stdevArray;
+  vtkm::cont::UnknownArrayHandle centeredArray;
+
+  // The members are read as the components of each value, this works for a Vec field and
+  // for an array with one component array per member.
+  auto resolveType = [&](const auto& concreteEnsemble) {
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "statistics");
+      this->Invoke(
+        ExtractingEnsembleStatistics{}, concreteEnsemble, minArray, maxArray, meanArray, stdevArray);
+    }
+    if (this->ComputeCentered)
+    {
+      FilterInstrumentation::ScopedStage stage(this->Instrumentation, "center");
+      // The new array keeps the floating point components of the input, integer members
+      // are centered as FloatDefault.
+      using ValueType = typename std::decay_t<decltype(concreteEnsemble)>::ValueType;
+      using ComponentType = typename vtkm::VecTraits<ValueType>::ComponentType;
+      using CenteredType = typename std::
+        conditional<std::is_floating_point<ComponentType>::value, ComponentType, vtkm::FloatDefault>::type;
+      centeredArray = inArray.NewInstanceFloatBasic();
+      // These allocations are not necessary in the most recent version of VTK-m.
+      centeredArray.Allocate(numPoints);
+      auto centeredConcrete = centeredArray.ExtractArrayFromComponents<CenteredType>();
+      this->Invoke(ExtractingEnsembleCentered{}, concreteEnsemble, meanArray, centeredConcrete);
+    }
+  };
+  inArray.CastAndCallWithExtractedArray(resolveType);
+
+  vtkm::IdComponent numMembers = inArray.GetNumberOfComponentsFlat();
+  this->Instrumentation.AddCount("points_processed", numPoints);
+  this->Instrumentation.AddCount("members", numMembers);
+  this->Instrumentation.AddBytes(
+    "output",
+    numPoints * sizeof(vtkm::FloatDefault) * (4 + (this->ComputeCentered ? numMembers : 0)));
+
+  std::string fieldName = ensembleField.GetName();
+  vtkm::cont::DataSet result = this->CreateResult(input);
+  result.AddPointField(fieldName + this->MinSuffix, minArray);
+  result.AddPointField(fieldName + this->MaxSuffix, maxArray);
+  result.AddPointField(fieldName + this->MeanSuffix, meanArray);
+  result.AddPointField(fieldName + this->StdevSuffix, stdevArray);
+  if (this->ComputeCentered)
+  {
+    result.AddPointField(fieldName + this->CenteredSuffix, centeredArray);
+  }
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
@@ -0,0 +1,101 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_EnsembleStatistics_h
+#define vtk_m_filter_uncertainty_EnsembleStatistics_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Computes the distribution of each point of an ensemble from its members.
+///
+/// The `SubsampleUncertainty*` filters model the uncertainty of a block of points of a
+/// single field. For an ensemble, each point has its own distribution given by the values
+/// of the members. This filter takes a point field holding the members of each point (a
+/// `Vec` with one component per member, or an array with one component array per member)
+/// and computes, once per point, the min, max, mean and standard deviation of the members.
+/// The fields are named like the fields of `SubsampleUncertaintyUniform` and
+/// `SubsampleUncertaintyIndependentGaussian` (the name of the ensemble field followed by
+/// `_min`, `_max`, `_mean` and `_stdev`), so the result can be given directly to
+/// `ContourUncertainUniform` and `ContourUncertainIndependentGaussian`. The mean can also
+/// be given to `ContourUncertainEnsemble2D`, which then does not recompute it in each cell.
+///
+/// When `SetComputeCentered` is on, the members minus the mean of their point are also
+/// written (`_centered`). The covariance of two points is the dot product of their centered
+/// members divided by the number of members minus 1.
+///
+class EnsembleStatistics : public vtkm::filter::FilterField
+{
+  std::string MinSuffix = "_min";
+  std::string MaxSuffix = "_max";
+  std::string MeanSuffix = "_mean";
+  std::string StdevSuffix = "_stdev";
+  std::string CenteredSuffix = "_centered";
+  bool ComputeCentered = false;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT EnsembleStatistics() = default;
+
+  ///@{
+  /// Specifies the field with the members of each point.
+  VTKM_CONT void SetEnsembleField(const std::string& fieldName)
+  {
+    this->SetActiveField(0, fieldName, vtkm::cont::Field::Association::Points);
+  }
+  ///@}
+
+  ///@{
+  /// \brief The suffixes of the output fields.
+  ///
+  VTKM_CONT void SetMinSuffix(const std::string& suffix) { this->MinSuffix = suffix; }
+  VTKM_CONT const std::string& GetMinSuffix() const { return this->MinSuffix; }
+  VTKM_CONT void SetMaxSuffix(const std::string& suffix) { this->MaxSuffix = suffix; }
+  VTKM_CONT const std::string& GetMaxSuffix() const { return this->MaxSuffix; }
+  VTKM_CONT void SetMeanSuffix(const std::string& suffix) { this->MeanSuffix = suffix; }
+  VTKM_CONT const std::string& GetMeanSuffix() const { return this->MeanSuffix; }
+  VTKM_CONT void SetStdevSuffix(const std::string& suffix) { this->StdevSuffix = suffix; }
+  VTKM_CONT const std::string& GetStdevSuffix() const { return this->StdevSuffix; }
+  VTKM_CONT void SetCenteredSuffix(const std::string& suffix) { this->CenteredSuffix = suffix; }
+  VTKM_CONT const std::string& GetCenteredSuffix() const { return this->CenteredSuffix; }
+  ///@}
+
+  ///@{
+  /// Also writes the centered members of each point. Off by default.
+  VTKM_CONT void SetComputeCentered(bool flag) { this->ComputeCentered = flag; }
+  VTKM_CONT bool GetComputeCentered() const { return this->ComputeCentered; }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_EnsembleStatistics_h
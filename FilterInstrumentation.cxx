@@ -0,0 +1,273 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "FilterInstrumentation.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+template <typename RecordType>
+RecordType& FindOrAddRecord(std::vector<RecordType>& records, const std::string& name)
+{
+  auto found = std::find_if(
+    records.begin(), records.end(), [&](const RecordType& r) { return r.Name == name; });
+  if (found != records.end())
+  {
+    return *found;
+  }
+  records.emplace_back();
+  records.back().Name = name;
+  return records.back();
+}
+
+template <typename RecordType>
+const RecordType* FindRecord(const std::vector<RecordType>& records, const std::string& name)
+{
+  auto found = std::find_if(
+    records.begin(), records.end(), [&](const RecordType& r) { return r.Name == name; });
+  return (found != records.end()) ? &(*found) : nullptr;
+}
+
+void WriteJSONCounts(std::ostream& out,
+                     const std::vector<vtkm::filter::uncertainty::FilterInstrumentation::CountRecord>& records)
+{
+  out << "{";
+  for (std::size_t i = 0; i < records.size(); ++i)
+  {
+    out << (i > 0 ? ", " : "") << "\"" << records[i].Name << "\": " << records[i].Value;
+  }
+  out << "}";
+}
+
+double Ratio(vtkm::UInt64 numerator, vtkm::UInt64 denominator)
+{
+  return (denominator > 0) ? static_cast<double>(numerator) / static_cast<double>(denominator)
+                           : 0.0;
+}
+
+bool HasCounters(const vtkm::filter::uncertainty::FilterInstrumentation::StageRecord& record)
+{
+  return record.Counters.Cycles > 0;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+FilterInstrumentation::FilterInstrumentation()
+{
+  const char* env = std::getenv("UCV_INSTRUMENTATION");
+  this->Enabled = (env != nullptr) && (std::string(env) != "0");
+
+  const char* perfEnv = std::getenv("UCV_PERF_COUNTERS");
+  this->SetHardwareCountersEnabled((perfEnv != nullptr) && (std::string(perfEnv) != "0"));
+}
+
+void FilterInstrumentation::SetHardwareCountersEnabled(bool enabled)
+{
+  this->HardwareCountersEnabled = enabled;
+  if (enabled)
+  {
+    // Open the counters now so that they also count the threads created afterwards. The
+    // threads that already exist are not counted, UncertaintyRuntime opens them earlier.
+    HardwareCounters::GetInstance();
+  }
+}
+
+void FilterInstrumentation::Reset()
+{
+  this->Stages.clear();
+  this->Counts.clear();
+  this->Allocations.clear();
+}
+
+void FilterInstrumentation::AddStageTime(const std::string& stage, vtkm::Float64 seconds)
+{
+  if (!this->Enabled)
+  {
+    return;
+  }
+  StageRecord& record = FindOrAddRecord(this->Stages, stage);
+  record.Seconds += seconds;
+  record.Calls += 1;
+}
+
+void FilterInstrumentation::AddStageCounters(const std::string& stage,
+                                             const HardwareCounters::Values& counters)
+{
+  if (!this->Enabled)
+  {
+    return;
+  }
+  FindOrAddRecord(this->Stages, stage).Counters += counters;
+}
+
+void FilterInstrumentation::AddCount(const std::string& counter, vtkm::Id value)
+{
+  if (!this->Enabled)
+  {
+    return;
+  }
+  FindOrAddRecord(this->Counts, counter).Value += value;
+}
+
+void FilterInstrumentation::AddBytes(const std::string& allocation, vtkm::Id bytes)
+{
+  if (!this->Enabled)
+  {
+    return;
+  }
+  FindOrAddRecord(this->Allocations, allocation).Value += bytes;
+}
+
+vtkm::Float64 FilterInstrumentation::GetStageTime(const std::string& stage) const
+{
+  const StageRecord* record = FindRecord(this->Stages, stage);
+  return record ? record->Seconds : 0.0;
+}
+
+vtkm::Id FilterInstrumentation::GetStageCalls(const std::string& stage) const
+{
+  const StageRecord* record = FindRecord(this->Stages, stage);
+  return record ? record->Calls : 0;
+}
+
+vtkm::Id FilterInstrumentation::GetCount(const std::string& counter) const
+{
+  const CountRecord* record = FindRecord(this->Counts, counter);
+  return record ? record->Value : 0;
+}
+
+vtkm::Id FilterInstrumentation::GetBytes(const std::string& allocation) const
+{
+  const CountRecord* record = FindRecord(this->Allocations, allocation);
+  return record ? record->Value : 0;
+}
+
+void FilterInstrumentation::WriteJSON(std::ostream& out, const std::string& filterName) const
+{
+  out << "{";
+  if (!filterName.empty())
+  {
+    out << "\"filter\": \"" << filterName << "\", ";
+  }
+  out << "\"stages\": {";
+  for (std::size_t i = 0; i < this->Stages.size(); ++i)
+  {
+    const StageRecord& record = this->Stages[i];
+    out << (i > 0 ? ", " : "") << "\"" << record.Name << "\": {\"seconds\": " << record.Seconds
+        << ", \"calls\": " << record.Calls;
+    if (HasCounters(record))
+    {
+      const HardwareCounters::Values& counters = record.Counters;
+      out << ", \"cycles\": " << counters.Cycles << ", \"instructions\": " << counters.Instructions
+          << ", \"cache_references\": " << counters.CacheReferences
+          << ", \"cache_misses\": " << counters.CacheMisses << ", \"branches\": " << counters.Branches
+          << ", \"branch_misses\": " << counters.BranchMisses
+          << ", \"ipc\": " << Ratio(counters.Instructions, counters.Cycles)
+          << ", \"cache_miss_rate\": " << Ratio(counters.CacheMisses, counters.CacheReferences)
+          << ", \"branch_miss_rate\": " << Ratio(counters.BranchMisses, counters.Branches);
+    }
+    out << "}";
+  }
+  out << "}, \"counters\": ";
+  WriteJSONCounts(out, this->Counts);
+  out << ", \"bytes\": ";
+  WriteJSONCounts(out, this->Allocations);
+  out << "}";
+}
+
+void FilterInstrumentation::WriteCSV(std::ostream& out,
+                                     const std::string& filterName,
+                                     bool writeHeader) const
+{
+  if (writeHeader)
+  {
+    out << "filter,kind,name,value,calls\n";
+  }
+  for (const StageRecord& record : this->Stages)
+  {
+    out << filterName << ",stage," << record.Name << "," << record.Seconds << "," << record.Calls
+        << "\n";
+  }
+  for (const StageRecord& record : this->Stages)
+  {
+    if (!HasCounters(record))
+    {
+      continue;
+    }
+    const HardwareCounters::Values& counters = record.Counters;
+    const std::string prefix = filterName + ",hw," + record.Name + ":";
+    out << prefix << "cycles," << counters.Cycles << ",\n";
+    out << prefix << "instructions," << counters.Instructions << ",\n";
+    out << prefix << "cache_misses," << counters.CacheMisses << ",\n";
+    out << prefix << "branch_misses," << counters.BranchMisses << ",\n";
+    out << prefix << "ipc," << Ratio(counters.Instructions, counters.Cycles) << ",\n";
+    out << prefix << "cache_miss_rate," << Ratio(counters.CacheMisses, counters.CacheReferences)
+        << ",\n";
+    out << prefix << "branch_miss_rate," << Ratio(counters.BranchMisses, counters.Branches)
+        << ",\n";
+  }
+  for (const CountRecord& record : this->Counts)
+  {
+    out << filterName << ",counter," << record.Name << "," << record.Value << ",\n";
+  }
+  for (const CountRecord& record : this->Allocations)
+  {
+    out << filterName << ",bytes," << record.Name << "," << record.Value << ",\n";
+  }
+}
+
+FilterInstrumentation::ScopedStage::ScopedStage(FilterInstrumentation& instrumentation,
+                                                const char* stage)
+  : Instrumentation(instrumentation)
+{
+  if (this->Instrumentation.GetEnabled())
+  {
+    this->Stage = stage;
+    this->Timer.reset(new vtkm::cont::Timer);
+    this->ReadCounters = this->Instrumentation.GetHardwareCountersEnabled();
+    if (this->ReadCounters)
+    {
+      this->StartCounters = HardwareCounters::GetInstance().Read();
+    }
+    this->Timer->Start();
+  }
+}
+
+FilterInstrumentation::ScopedStage::~ScopedStage()
+{
+  if (this->Timer)
+  {
+    // Stop only records the stop event, GetElapsedTime waits for the device. The counters are
+    // read after it, so the host work of the asynchronous calls of the stage is included (the
+    // time spent in CUDA kernels is never counted, only the host is).
+    this->Timer->Stop();
+    vtkm::Float64 seconds = this->Timer->GetElapsedTime();
+    this->Instrumentation.AddStageTime(this->Stage, seconds);
+    if (this->ReadCounters)
+    {
+      this->Instrumentation.AddStageCounters(
+        this->Stage, HardwareCounters::GetInstance().Read() - this->StartCounters);
+    }
+  }
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
@@ -0,0 +1,160 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_FilterInstrumentation_h
+#define vtk_m_filter_uncertainty_FilterInstrumentation_h
+
+#include <vtkm/Types.h>
+#include <vtkm/cont/Timer.h>
+
+#include "HardwareCounters.h"
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Records the stage timings, counters and allocated bytes of a filter.
+///
+/// Each uncertainty filter owns one of these and fills it as it executes. The records
+/// accumulate over executions until `Reset` is called, so a time series can either be
+/// reported per step or as a whole. Recording is disabled by default, in which case each
+/// record is a single branch. It is enabled with `SetEnabled` or by setting the
+/// environment variable `UCV_INSTRUMENTATION` to a value other than 0.
+///
+/// Timing a stage synchronizes the device (see `vtkm::cont::Timer`), so the stage times
+/// are accurate but the total run time is slightly longer when recording is enabled.
+///
+/// The stages can also record CPU hardware counters (see `HardwareCounters`), which tell
+/// whether a stage is bound by memory or by computation. They are enabled with
+/// `SetHardwareCountersEnabled` or by setting `UCV_PERF_COUNTERS` to a value other than 0.
+///
+class FilterInstrumentation
+{
+public:
+  struct StageRecord
+  {
+    std::string Name;
+    vtkm::Float64 Seconds = 0.0;
+    vtkm::Id Calls = 0;
+    HardwareCounters::Values Counters;
+  };
+
+  struct CountRecord
+  {
+    std::string Name;
+    vtkm::Id Value = 0;
+  };
+
+  VTKM_CONT FilterInstrumentation();
+
+  ///@{
+  /// Turns the recording on or off.
+  VTKM_CONT void SetEnabled(bool enabled) { this->Enabled = enabled; }
+  VTKM_CONT bool GetEnabled() const { return this->Enabled; }
+  ///@}
+
+  ///@{
+  /// \brief Turns the hardware counters of the stages on or off.
+  ///
+  /// They are only recorded when the recording is enabled too and the counters are
+  /// available on this system.
+  ///
+  VTKM_CONT void SetHardwareCountersEnabled(bool enabled);
+  VTKM_CONT bool GetHardwareCountersEnabled() const
+  {
+    return this->HardwareCountersEnabled && HardwareCounters::GetInstance().IsAvailable();
+  }
+  ///@}
+
+  /// Clears all the records.
+  VTKM_CONT void Reset();
+
+  ///@{
+  /// Adds to the records with the given name (a new record is created the first time).
+  VTKM_CONT void AddStageTime(const std::string& stage, vtkm::Float64 seconds);
+  VTKM_CONT void AddStageCounters(const std::string& stage,
+                                  const HardwareCounters::Values& counters);
+  VTKM_CONT void AddCount(const std::string& counter, vtkm::Id value);
+  VTKM_CONT void AddBytes(const std::string& allocation, vtkm::Id bytes);
+  ///@}
+
+  ///@{
+  /// Returns the accumulated value of a record, or 0 if nothing was recorded with that name.
+  VTKM_CONT vtkm::Float64 GetStageTime(const std::string& stage) const;
+  VTKM_CONT vtkm::Id GetStageCalls(const std::string& stage) const;
+  VTKM_CONT vtkm::Id GetCount(const std::string& counter) const;
+  VTKM_CONT vtkm::Id GetBytes(const std::string& allocation) const;
+  ///@}
+
+  ///@{
+  /// All the records in the order they were first added.
+  VTKM_CONT const std::vector<StageRecord>& GetStages() const { return this->Stages; }
+  VTKM_CONT const std::vector<CountRecord>& GetCounts() const { return this->Counts; }
+  VTKM_CONT const std::vector<CountRecord>& GetAllocations() const { return this->Allocations; }
+  ///@}
+
+  ///@{
+  /// \brief Writes the records.
+  ///
+  /// The JSON is an object with `stages`, `counters` and `bytes` members. The CSV has
+  /// the columns `filter,kind,name,value,calls` (calls is only set for the stages).
+  /// The filter name is used to tell apart the records of several filters in one file.
+  ///
+  /// When hardware counters were recorded, each stage also reports its IPC (instructions
+  /// per cycle) and its cache and branch miss rates. In the CSV these are rows of kind
+  /// `hw` named `<stage>:<metric>`.
+  ///
+  VTKM_CONT void WriteJSON(std::ostream& out, const std::string& filterName = "") const;
+  VTKM_CONT void WriteCSV(std::ostream& out,
+                          const std::string& filterName = "",
+                          bool writeHeader = true) const;
+  ///@}
+
+  /// \brief Times a stage from construction to destruction.
+  ///
+  /// Nothing is done (not even creating a timer) when the recording is disabled.
+  ///
+  class ScopedStage
+  {
+  public:
+    VTKM_CONT ScopedStage(FilterInstrumentation& instrumentation, const char* stage);
+    VTKM_CONT ~ScopedStage();
+
+    ScopedStage(const ScopedStage&) = delete;
+    ScopedStage& operator=(const ScopedStage&) = delete;
+
+  private:
+    FilterInstrumentation& Instrumentation;
+    std::string Stage;
+    std::unique_ptr<vtkm::cont::Timer> Timer;
+    bool ReadCounters = false;
+    HardwareCounters::Values StartCounters;
+  };
+
+private:
+  bool Enabled = false;
+  bool HardwareCountersEnabled = false;
+  std::vector<StageRecord> Stages;
+  std::vector<CountRecord> Counts;
+  std::vector<CountRecord> Allocations;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_FilterInstrumentation_h
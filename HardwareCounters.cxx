@@ -0,0 +1,148 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "HardwareCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace
+{
+
+#ifdef __linux__
+int OpenCounter(vtkm::UInt64 config)
+{
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // Count the threads created later on (e.g. the OpenMP pool).
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+vtkm::UInt64 ReadCounter(int descriptor)
+{
+  if (descriptor < 0)
+  {
+    return 0;
+  }
+  // value, time enabled, time running
+  vtkm::UInt64 data[3] = { 0, 0, 0 };
+  if (read(descriptor, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+  {
+    return 0;
+  }
+  if (data[2] < data[1])
+  {
+    return static_cast<vtkm::UInt64>(static_cast<double>(data[0]) * data[1] / data[2]);
+  }
+  return data[0];
+}
+#endif
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+HardwareCounters::Values HardwareCounters::Values::operator-(const Values& other) const
+{
+  Values result;
+  result.Cycles = this->Cycles - other.Cycles;
+  result.Instructions = this->Instructions - other.Instructions;
+  result.CacheReferences = this->CacheReferences - other.CacheReferences;
+  result.CacheMisses = this->CacheMisses - other.CacheMisses;
+  result.Branches = this->Branches - other.Branches;
+  result.BranchMisses = this->BranchMisses - other.BranchMisses;
+  return result;
+}
+
+HardwareCounters::Values& HardwareCounters::Values::operator+=(const Values& other)
+{
+  this->Cycles += other.Cycles;
+  this->Instructions += other.Instructions;
+  this->CacheReferences += other.CacheReferences;
+  this->CacheMisses += other.CacheMisses;
+  this->Branches += other.Branches;
+  this->BranchMisses += other.BranchMisses;
+  return *this;
+}
+
+HardwareCounters& HardwareCounters::GetInstance()
+{
+  static HardwareCounters instance;
+  return instance;
+}
+
+HardwareCounters::HardwareCounters()
+{
+  for (int i = 0; i < NumberOfCounters; ++i)
+  {
+    this->Descriptors[i] = -1;
+  }
+#ifdef __linux__
+  // The cache events are the last level cache on most processors.
+  const vtkm::UInt64 configs[NumberOfCounters] = { PERF_COUNT_HW_CPU_CYCLES,
+                                                   PERF_COUNT_HW_INSTRUCTIONS,
+                                                   PERF_COUNT_HW_CACHE_REFERENCES,
+                                                   PERF_COUNT_HW_CACHE_MISSES,
+                                                   PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+                                                   PERF_COUNT_HW_BRANCH_MISSES };
+  for (int i = 0; i < NumberOfCounters; ++i)
+  {
+    this->Descriptors[i] = OpenCounter(configs[i]);
+  }
+#endif
+}
+
+HardwareCounters::~HardwareCounters()
+{
+#ifdef __linux__
+  for (int i = 0; i < NumberOfCounters; ++i)
+  {
+    if (this->Descriptors[i] >= 0)
+    {
+      close(this->Descriptors[i]);
+    }
+  }
+#endif
+}
+
+HardwareCounters::Values HardwareCounters::Read() const
+{
+  Values values;
+#ifdef __linux__
+  values.Cycles = ReadCounter(this->Descriptors[0]);
+  values.Instructions = ReadCounter(this->Descriptors[1]);
+  values.CacheReferences = ReadCounter(this->Descriptors[2]);
+  values.CacheMisses = ReadCounter(this->Descriptors[3]);
+  values.Branches = ReadCounter(this->Descriptors[4]);
+  values.BranchMisses = ReadCounter(this->Descriptors[5]);
+#endif
+  return values;
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
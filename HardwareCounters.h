@@ -0,0 +1,82 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_HardwareCounters_h
+#define vtk_m_filter_uncertainty_HardwareCounters_h
+
+#include <vtkm/Types.h>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Process-wide CPU hardware counters read through Linux `perf_event_open`.
+///
+/// The counters are opened once, the first time `GetInstance` is called, and count
+/// user space events of the calling thread and of every thread it creates afterwards.
+/// Threads that already exist are not counted, so the counters must be opened before the
+/// OpenMP thread pool is created. The pool is created by the first parallel region, which
+/// can be the pinning of the threads or the placement of the fields by
+/// `UncertaintyRuntime`, not only the first `Invoke`. `UncertaintyRuntime` opens the
+/// counters first when `UCV_PERF_COUNTERS` is set. `FilterInstrumentation` also opens them
+/// when it is constructed with the hardware counters enabled, which is only early enough
+/// for drivers that do not use `UncertaintyRuntime`.
+///
+/// On other platforms, or when the kernel does not allow the counters (see
+/// `/proc/sys/kernel/perf_event_paranoid`), `IsAvailable` returns false and all values
+/// are 0. Only the host is counted, the time spent in CUDA kernels is not.
+///
+class HardwareCounters
+{
+public:
+  struct Values
+  {
+    vtkm::UInt64 Cycles = 0;
+    vtkm::UInt64 Instructions = 0;
+    vtkm::UInt64 CacheReferences = 0;
+    vtkm::UInt64 CacheMisses = 0;
+    vtkm::UInt64 Branches = 0;
+    vtkm::UInt64 BranchMisses = 0;
+
+    VTKM_CONT Values operator-(const Values& other) const;
+    VTKM_CONT Values& operator+=(const Values& other);
+  };
+
+  VTKM_CONT static HardwareCounters& GetInstance();
+
+  /// Returns true if at least the cycle counter could be opened.
+  VTKM_CONT bool IsAvailable() const { return this->Descriptors[0] >= 0; }
+
+  /// \brief The counts since the counters were opened.
+  ///
+  /// When the kernel multiplexes the counters, the values are scaled by the fraction of
+  /// time each counter was running.
+  ///
+  VTKM_CONT Values Read() const;
+
+  HardwareCounters(const HardwareCounters&) = delete;
+  HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+private:
+  static constexpr int NumberOfCounters = 6;
+
+  HardwareCounters();
+  ~HardwareCounters();
+
+  int Descriptors[NumberOfCounters];
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_HardwareCounters_h
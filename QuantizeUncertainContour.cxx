@@ -0,0 +1,137 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "QuantizeUncertainContour.h"
+
+#include <vtkm/TypeList.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Invoker.h>
+
+#include "ucvworklet/QuantizeField.hpp"
+
+#include <fstream>
+
+namespace
+{
+
+template <typename CodeType>
+vtkm::cont::ArrayHandle<CodeType> Quantize(const vtkm::cont::Field& field,
+                                           vtkm::Float64 offset,
+                                           vtkm::Float64 scale,
+                                           vtkm::Float64 maxLevel)
+{
+  vtkm::cont::ArrayHandle<CodeType> codes;
+  vtkm::cont::Invoker invoke;
+  field.GetData()
+    .CastAndCallForTypesWithFloatFallback<vtkm::TypeListScalarAll, VTKM_DEFAULT_STORAGE_LIST>(
+      [&](const auto& values) { invoke(QuantizeField{ offset, scale, maxLevel }, values, codes); });
+  return codes;
+}
+
+void AddEncoding(vtkm::cont::DataSet& result,
+                 const std::string& name,
+                 vtkm::Float64 offset,
+                 vtkm::Float64 scale)
+{
+  result.AddField(vtkm::cont::Field(name + "_offset",
+                                    vtkm::cont::Field::Association::WholeDataSet,
+                                    vtkm::cont::make_ArrayHandle({ offset })));
+  result.AddField(vtkm::cont::Field(name + "_scale",
+                                    vtkm::cont::Field::Association::WholeDataSet,
+                                    vtkm::cont::make_ArrayHandle({ scale })));
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+QuantizeUncertainContour::QuantizeUncertainContour()
+{
+  this->SetCrossProbabilityName("cross_probability");
+}
+
+vtkm::cont::DataSet QuantizeUncertainContour::DoExecute(const vtkm::cont::DataSet& input)
+{
+  if ((this->NumberOfBits != 8) && (this->NumberOfBits != 16))
+  {
+    throw vtkm::cont::ErrorBadValue("The uncertain contour can only be quantized to 8 or 16 bits.");
+  }
+  if (this->MaxEntropy <= 0)
+  {
+    throw vtkm::cont::ErrorBadValue("The max entropy must be positive.");
+  }
+
+  vtkm::cont::Field crossProbField = this->GetFieldFromDataSet(input);
+  vtkm::cont::Field numNonZeroProbField = input.GetCellField(this->NumberNonzeroProbabilityName);
+  vtkm::cont::Field entropyField = input.GetCellField(this->EntropyName);
+
+  vtkm::Float64 crossProbScale = this->GetCrossProbabilityScale();
+  vtkm::Float64 entropyScale = this->GetEntropyScale();
+  vtkm::Float64 maxLevel = static_cast<vtkm::Float64>((1 << this->NumberOfBits) - 1);
+
+  vtkm::cont::UnknownArrayHandle crossProb;
+  vtkm::cont::UnknownArrayHandle numNonZeroProb;
+  vtkm::cont::UnknownArrayHandle entropy;
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "quantize");
+    if (this->NumberOfBits == 8)
+    {
+      crossProb = Quantize<vtkm::UInt8>(crossProbField, 0.0, crossProbScale, maxLevel);
+      entropy = Quantize<vtkm::UInt8>(entropyField, 0.0, entropyScale, maxLevel);
+    }
+    else
+    {
+      crossProb = Quantize<vtkm::UInt16>(crossProbField, 0.0, crossProbScale, maxLevel);
+      entropy = Quantize<vtkm::UInt16>(entropyField, 0.0, entropyScale, maxLevel);
+    }
+    // 1 to 256 cases
+    numNonZeroProb = Quantize<vtkm::UInt8>(numNonZeroProbField, 1.0, 1.0, 255.0);
+  }
+
+  // The cross probability and the entropy use NumberOfBits, the number of cases 8 bits.
+  vtkm::Id bytesPerCell = 2 * (this->NumberOfBits / 8) + 1;
+  this->Instrumentation.AddBytes("output", crossProb.GetNumberOfValues() * bytesPerCell);
+
+  vtkm::cont::DataSet result = this->CreateResult(input);
+  result.AddCellField(this->GetCrossProbabilityName(), crossProb);
+  result.AddCellField(this->GetNumberNonzeroProbabilityName(), numNonZeroProb);
+  result.AddCellField(this->GetEntropyName(), entropy);
+  AddEncoding(result, this->GetCrossProbabilityName(), 0.0, crossProbScale);
+  AddEncoding(result, this->GetNumberNonzeroProbabilityName(), 1.0, 1.0);
+  AddEncoding(result, this->GetEntropyName(), 0.0, entropyScale);
+  return result;
+}
+
+void QuantizeUncertainContour::WriteEncoding(const std::string& fileName) const
+{
+  std::ofstream out(fileName);
+  out.precision(17);
+  out << "{\n";
+  out << "  \"bits\": " << this->NumberOfBits << ",\n";
+  out << "  \"fields\": {\n";
+  out << "    \"" << this->GetCrossProbabilityName() << "\": { \"offset\": 0, \"scale\": "
+      << this->GetCrossProbabilityScale() << " },\n";
+  out << "    \"" << this->GetNumberNonzeroProbabilityName()
+      << "\": { \"offset\": 1, \"scale\": 1 },\n";
+  out << "    \"" << this->GetEntropyName() << "\": { \"offset\": 0, \"scale\": "
+      << this->GetEntropyScale() << " }\n";
+  out << "  }\n";
+  out << "}\n";
+}
+
+}
+}
+} // vtkm::filter::uncertainty
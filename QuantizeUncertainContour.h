@@ -0,0 +1,144 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_QuantizeUncertainContour_h
+#define vtk_m_filter_uncertainty_QuantizeUncertainContour_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include <string>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Encodes the output of the uncertain contour filters with fewer bits.
+///
+/// The `ContourUncertain*` filters write the cross probability and the entropy with the
+/// type of the input field (often 64 bit floats) and the number of nonzero probability
+/// cases as a `vtkm::Id`. This filter replaces these cell fields with unsigned integers
+/// of 8 or 16 bits, which makes the written files several times smaller.
+///
+/// A value is stored as the nearest level of `offset + code * scale`. The cross probability
+/// uses the range [0, 1] and the entropy the range [0, max entropy], so a zero is always
+/// encoded exactly and the encoding is the same for every block and time step. The number
+/// of nonzero probability cases is at least 1 and at most 256 for a hexahedron, so it is
+/// always stored as a `vtkm::UInt8` with an offset of 1. The scale and the offset of each
+/// field are added as whole data set fields named `<field>_scale` and `<field>_offset`.
+/// The legacy VTK writer does not write whole data set fields, so `WriteEncoding` writes
+/// them to a small json file to keep next to the written data.
+///
+class QuantizeUncertainContour : public vtkm::filter::FilterField
+{
+  std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
+  std::string EntropyName = "entropy";
+  vtkm::IdComponent NumberOfBits = 8;
+  vtkm::Float64 MaxEntropy = 8.0;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT QuantizeUncertainContour();
+
+  ///@{
+  /// Specifies the name of the cross probability field, `cross_probability` by default.
+  VTKM_CONT void SetCrossProbabilityName(const std::string& name)
+  {
+    this->SetActiveField(name, vtkm::cont::Field::Association::Cells);
+  }
+  VTKM_CONT const std::string& GetCrossProbabilityName() const
+  {
+    return this->GetActiveFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the field with the number of nonzero probability cases.
+  VTKM_CONT void SetNumberNonzeroProbabilityName(const std::string& name)
+  {
+    this->NumberNonzeroProbabilityName = name;
+  }
+  VTKM_CONT const std::string& GetNumberNonzeroProbabilityName() const
+  {
+    return this->NumberNonzeroProbabilityName;
+  }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the entropy field.
+  VTKM_CONT void SetEntropyName(const std::string& name) { this->EntropyName = name; }
+  VTKM_CONT const std::string& GetEntropyName() const { return this->EntropyName; }
+  ///@}
+
+  ///@{
+  /// \brief The number of bits of the cross probability and the entropy, 8 or 16.
+  ///
+  /// With 8 bits the error of a value is at most half of 1/255 of its range.
+  ///
+  VTKM_CONT void SetNumberOfBits(vtkm::IdComponent numBits) { this->NumberOfBits = numBits; }
+  VTKM_CONT vtkm::IdComponent GetNumberOfBits() const { return this->NumberOfBits; }
+  ///@}
+
+  ///@{
+  /// \brief The largest entropy that can be encoded.
+  ///
+  /// The entropy of the cases of a cell is at most log2 of the number of cases, which is
+  /// 8 for a hexahedron (the default) and 4 for a quad.
+  ///
+  VTKM_CONT void SetMaxEntropy(vtkm::Float64 value) { this->MaxEntropy = value; }
+  VTKM_CONT vtkm::Float64 GetMaxEntropy() const { return this->MaxEntropy; }
+  ///@}
+
+  ///@{
+  /// \brief The scales of the encoded fields, their offset is 0.
+  ///
+  /// The cross probability is `code / (2^bits - 1)` and the entropy is
+  /// `code * max entropy / (2^bits - 1)`. The number of nonzero probability cases is
+  /// `code + 1`.
+  ///
+  VTKM_CONT vtkm::Float64 GetCrossProbabilityScale() const
+  {
+    return 1.0 / static_cast<vtkm::Float64>((1 << this->NumberOfBits) - 1);
+  }
+  VTKM_CONT vtkm::Float64 GetEntropyScale() const
+  {
+    return this->MaxEntropy / static_cast<vtkm::Float64>((1 << this->NumberOfBits) - 1);
+  }
+  ///@}
+
+  /// \brief Writes the scale and the offset of each encoded field to a json file.
+  ///
+  /// The file gives the number of bits and, for each field, `offset` and `scale` such that
+  /// the value of a cell is `offset + code * scale`.
+  ///
+  VTKM_CONT void WriteEncoding(const std::string& fileName) const;
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_QuantizeUncertainContour_h
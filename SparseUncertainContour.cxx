@@ -0,0 +1,154 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "SparseUncertainContour.h"
+
+#include <vtkm/CellShape.h>
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
+#include <vtkm/cont/ArrayHandleGroupVec.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/CellSetPermutation.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/filter/MapFieldPermutation.h>
+
+#include "ucvworklet/CopyCellPointIds.hpp"
+
+#include <type_traits>
+
+namespace
+{
+
+struct GreaterThanThreshold
+{
+  vtkm::Float64 Threshold;
+
+  template <typename T>
+  VTKM_EXEC_CONT bool operator()(const T& value) const
+  {
+    return static_cast<vtkm::Float64>(value) > this->Threshold;
+  }
+};
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+SparseUncertainContour::SparseUncertainContour()
+{
+  this->SetCrossProbabilityName("cross_probability");
+}
+
+vtkm::cont::DataSet SparseUncertainContour::DoExecute(const vtkm::cont::DataSet& input)
+{
+  vtkm::cont::Field crossProbField = this->GetFieldFromDataSet(input);
+  vtkm::Id numCells = input.GetNumberOfCells();
+
+  // The ids of the kept cells.
+  vtkm::cont::ArrayHandle<vtkm::Id> cellIds;
+  auto resolveType = [&](const auto& concreteCrossProb) {
+    vtkm::cont::Algorithm::CopyIf(vtkm::cont::ArrayHandleIndex(numCells),
+                                  concreteCrossProb,
+                                  cellIds,
+                                  GreaterThanThreshold{ this->Threshold });
+  };
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "select");
+    this->CastAndCallScalarField(crossProbField, resolveType);
+  }
+
+  // The kept cells as hexahedra or quads, and the ids of their points in the input.
+  vtkm::cont::CellSetSingleType<> outCellSet;
+  vtkm::cont::ArrayHandle<vtkm::Id> pointIds;
+  auto compactCells = [&](const auto& cellSet, auto numPointsTag, vtkm::UInt8 shape) {
+    constexpr vtkm::IdComponent NumPoints = decltype(numPointsTag)::value;
+    vtkm::cont::ArrayHandle<vtkm::Id> inputConnectivity;
+    this->Invoke(CopyCellPointIds<NumPoints>{},
+                 vtkm::cont::make_CellSetPermutation(cellIds, cellSet),
+                 vtkm::cont::make_ArrayHandleGroupVec<NumPoints>(inputConnectivity));
+
+    // Only keep the points used by the kept cells and renumber the connectivity.
+    vtkm::cont::Algorithm::Copy(inputConnectivity, pointIds);
+    vtkm::cont::Algorithm::Sort(pointIds);
+    vtkm::cont::Algorithm::Unique(pointIds);
+    vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+    vtkm::cont::Algorithm::LowerBounds(pointIds, inputConnectivity, connectivity);
+    outCellSet.Fill(pointIds.GetNumberOfValues(), shape, NumPoints, connectivity);
+  };
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "compact");
+    if (input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+    {
+      vtkm::cont::CellSetStructured<3> cellSet;
+      input.GetCellSet().AsCellSet(cellSet);
+      compactCells(
+        cellSet, std::integral_constant<vtkm::IdComponent, 8>{}, vtkm::CELL_SHAPE_HEXAHEDRON);
+    }
+    else if (input.GetCellSet().IsType<vtkm::cont::CellSetStructured<2>>())
+    {
+      vtkm::cont::CellSetStructured<2> cellSet;
+      input.GetCellSet().AsCellSet(cellSet);
+      compactCells(cellSet, std::integral_constant<vtkm::IdComponent, 4>{}, vtkm::CELL_SHAPE_QUAD);
+    }
+    else
+    {
+      throw vtkm::cont::ErrorBadType(
+        "Sparse uncertain contour only works for CellSetStructured<2> and CellSetStructured<3>.");
+    }
+  }
+
+  this->Instrumentation.AddCount("cells_kept", cellIds.GetNumberOfValues());
+  this->Instrumentation.AddCount("cells_removed", numCells - cellIds.GetNumberOfValues());
+  this->Instrumentation.AddCount("points_kept", pointIds.GetNumberOfValues());
+
+  // The cell fields are restricted to the kept cells. The point fields (the statistics of
+  // the blocks) are dropped unless they are asked for, then they are restricted to the
+  // kept points.
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points;
+  vtkm::cont::CoordinateSystem coords = input.GetCoordinateSystem();
+  {
+    FilterInstrumentation::ScopedStage stage(this->Instrumentation, "compact_points");
+    vtkm::cont::ArrayCopy(
+      vtkm::cont::make_ArrayHandlePermutation(pointIds, coords.GetDataAsMultiplexer()), points);
+  }
+  auto mapper = [&](auto& outDataSet, const auto& field) {
+    if (field.IsCellField())
+    {
+      vtkm::filter::MapFieldPermutation(field, cellIds, outDataSet);
+    }
+    else if (field.IsPointField())
+    {
+      if (this->PassPointFields && (field.GetName() != coords.GetName()))
+      {
+        vtkm::filter::MapFieldPermutation(field, pointIds, outDataSet);
+      }
+    }
+    else
+    {
+      outDataSet.AddField(field);
+    }
+  };
+  vtkm::cont::DataSet result =
+    this->CreateResultCoordinateSystem(input, outCellSet, coords.GetName(), points, mapper);
+  result.AddCellField(this->OriginalCellIdName, cellIds);
+  return result;
+}
+
+}
+}
+} // vtkm::filter::uncertainty
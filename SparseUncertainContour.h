@@ -0,0 +1,100 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_SparseUncertainContour_h
+#define vtk_m_filter_uncertainty_SparseUncertainContour_h
+
+#include <vtkm/filter/FilterField.h>
+
+#include "FilterInstrumentation.h"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Keeps only the cells of an uncertain contour that may contain the contour.
+///
+/// The `ContourUncertain*` filters write dense cell fields over the whole grid, but usually
+/// only a few percent of the cells have a nonzero cross probability. This filter compacts
+/// the result of these filters to the cells with a cross probability above a threshold
+/// (0 by default), so the memory, the written files and the rendering scale with the size
+/// of the contour instead of the size of the volume.
+///
+/// The input must use a structured cell set (2D or 3D). The output has a single type cell
+/// set (hexahedra or quads) with the kept cells, only the points used by these cells (with
+/// explicit coordinates), the cell fields restricted to the kept cells and a cell field
+/// (`original_cell_id` by default) giving the id of each kept cell in the input grid. The
+/// point fields (such as the statistics of the blocks) are dropped unless
+/// `SetPassPointFields` is on.
+///
+class SparseUncertainContour : public vtkm::filter::FilterField
+{
+  std::string OriginalCellIdName = "original_cell_id";
+  vtkm::Float64 Threshold = 0.0;
+  bool PassPointFields = false;
+  FilterInstrumentation Instrumentation;
+
+public:
+  VTKM_CONT SparseUncertainContour();
+
+  ///@{
+  /// Specifies the name of the cross probability field, `cross_probability` by default.
+  VTKM_CONT void SetCrossProbabilityName(const std::string& name)
+  {
+    this->SetActiveField(name, vtkm::cont::Field::Association::Cells);
+  }
+  VTKM_CONT const std::string& GetCrossProbabilityName() const
+  {
+    return this->GetActiveFieldName();
+  }
+  ///@}
+
+  ///@{
+  /// Only the cells with a cross probability greater than the threshold are kept.
+  VTKM_CONT void SetThreshold(vtkm::Float64 value) { this->Threshold = value; }
+  VTKM_CONT vtkm::Float64 GetThreshold() const { return this->Threshold; }
+  ///@}
+
+  ///@{
+  /// Also writes the point fields of the input, restricted to the kept points. Off by default.
+  VTKM_CONT void SetPassPointFields(bool flag) { this->PassPointFields = flag; }
+  VTKM_CONT bool GetPassPointFields() const { return this->PassPointFields; }
+  ///@}
+
+  ///@{
+  /// Specifies the name of the output field with the id of each kept cell in the input.
+  VTKM_CONT void SetOriginalCellIdName(const std::string& name)
+  {
+    this->OriginalCellIdName = name;
+  }
+  VTKM_CONT const std::string& GetOriginalCellIdName() const { return this->OriginalCellIdName; }
+  ///@}
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_SparseUncertainContour_h
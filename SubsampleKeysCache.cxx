@@ -0,0 +1,55 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "SubsampleKeysCache.h"
+
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/Keys.h>
+
+#include "ucvworklet/CreateNewKey.hpp"
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+VTKM_CONT const vtkm::worklet::Keys<vtkm::Id>& SubsampleKeysCache::Get(
+    const vtkm::Id3& numPoints,
+    const vtkm::Id3& numBlocks,
+    vtkm::IdComponent blockSize,
+    FilterInstrumentation& instrumentation)
+{
+  if (!this->Keys || (this->PointDimensions != numPoints) || (this->BlockSize != blockSize))
+  {
+    FilterInstrumentation::ScopedStage stage(instrumentation, "create_keys");
+    vtkm::cont::Invoker invoke;
+    vtkm::cont::ArrayHandle<vtkm::Id> keyArray;
+    invoke(CreateNewKeyWorklet{numPoints, numBlocks, blockSize},
+           vtkm::cont::ArrayHandleIndex{ numPoints[0] * numPoints[1] * numPoints[2] },
+           keyArray);
+
+    this->Keys = std::make_shared<vtkm::worklet::Keys<vtkm::Id>>(keyArray);
+    this->PointDimensions = numPoints;
+    this->BlockSize = blockSize;
+
+    // The keys keep the sorted point ids and the offsets of each block.
+    instrumentation.AddCount("keys_rebuilt", 1);
+    instrumentation.AddBytes("keys", 2 * keyArray.GetNumberOfValues() * sizeof(vtkm::Id));
+  }
+  return *this->Keys;
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
@@ -0,0 +1,68 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_SubsampleKeysCache_h
+#define vtk_m_filter_uncertainty_SubsampleKeysCache_h
+
+#include <vtkm/Types.h>
+
+#include "FilterInstrumentation.h"
+
+#include <memory>
+
+namespace vtkm
+{
+namespace worklet
+{
+// Forward declaration
+template <typename T>
+class Keys;
+}
+}
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Keeps the keys grouping the points of a regular grid into blocks.
+///
+/// The keys only depend on the point dimensions and the block size. The subsample
+/// filters keep them between executions so that running a filter on many time steps
+/// of the same grid does not rebuild (and sort) them every time.
+///
+class SubsampleKeysCache
+{
+public:
+  /// \brief Returns the keys of the given grid, building them if the cached ones do not match.
+  ///
+  /// Building the keys is recorded in `instrumentation` as the `create_keys` stage,
+  /// the `keys_rebuilt` count and the `keys` bytes.
+  ///
+  VTKM_CONT const vtkm::worklet::Keys<vtkm::Id>& Get(const vtkm::Id3& numPoints,
+                                                    const vtkm::Id3& numBlocks,
+                                                    vtkm::IdComponent blockSize,
+                                                    FilterInstrumentation& instrumentation);
+
+  /// Releases the cached keys.
+  VTKM_CONT void Release() { this->Keys.reset(); }
+
+private:
+  std::shared_ptr<vtkm::worklet::Keys<vtkm::Id>> Keys;
+  vtkm::Id3 PointDimensions{ 0 };
+  vtkm::IdComponent BlockSize = 0;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_SubsampleKeysCache_h
@@ -10,7 +10,6 @@
 
 #include "SubsampleUncertaintyEnsemble.h"
 
-#include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
 #include <vtkm/cont/CellSetStructured.h>
 #include <vtkm/cont/DataSet.h>
@@ -20,7 +19,6 @@
 
 #include <vtkm/worklet/Keys.h>
 
-#include "ucvworklet/CreateNewKey.hpp"
 #include "ucvworklet/ExtractingMeanRaw.hpp"
 
 constexpr vtkm::IdComponent FORCE_BLOCK_SIZE = 4;
@@ -74,16 +72,15 @@ vtkm::cont::DataSet SubsampleUncertaintyEnsemble::DoExecute(const vtkm::cont::Da
   vtkm::Vec3f spacing{ (bounds.MaxCorner() - bounds.MinCorner()) / (numBlocks - 1) };
   vtkm::cont::ArrayHandleUniformPointCoordinates newCoordinates{ numBlocks, origin, spacing };
 
-  // Create key that groups subsampling
-  vtkm::cont::ArrayHandle<vtkm::Id> keyArray;
-  this->Invoke(CreateNewKeyWorklet{numPoints, numBlocks, this->BlockSize},
-               vtkm::cont::ArrayHandleIndex{ numPoints[0] * numPoints[1] * numPoints[2] },
-               keyArray);
-
-  vtkm::worklet::Keys<vtkm::Id> keys{ keyArray };
+  // Create key that groups subsampling (reused if the grid has not changed)
+  const vtkm::worklet::Keys<vtkm::Id>& keys =
+    this->KeysCache.Get(numPoints, numBlocks, this->BlockSize, this->Instrumentation);
   auto mapper = [&](vtkm::cont::DataSet& data, const vtkm::cont::Field& field) {
-    this->MapField(data, field, keys);
+    this->MapField(data, field, keys, this->Instrumentation);
   };
+  FilterInstrumentation::ScopedStage stage(this->Instrumentation, "reduce");
+  this->Instrumentation.AddCount("points_processed", numPoints[0] * numPoints[1] * numPoints[2]);
+  this->Instrumentation.AddCount("blocks", numBlocks[0] * numBlocks[1] * numBlocks[2]);
   return this->CreateResultCoordinateSystem(input,
                                             newCellSet,
                                             input.GetCoordinateSystem().GetName(),
@@ -94,7 +91,8 @@ vtkm::cont::DataSet SubsampleUncertaintyEnsemble::DoExecute(const vtkm::cont::Da
 VTKM_CONT void SubsampleUncertaintyEnsemble::MapField(
     vtkm::cont::DataSet& data,
     const vtkm::cont::Field& field,
-    const vtkm::worklet::Keys<vtkm::Id>& keys) const
+    const vtkm::worklet::Keys<vtkm::Id>& keys,
+    FilterInstrumentation& instrumentation) const
 {
   if (field.IsPointField())
   {
@@ -112,6 +110,9 @@ VTKM_CONT void SubsampleUncertaintyEnsemble::MapField(
       this->Invoke(ExtractingMeanRaw{}, keys, concrete, meanConcrete, ensembleConcrete);
       meanArray = meanConcrete;
       ensembleArray = ensembleConcrete;
+      instrumentation.AddBytes("output",
+                               meanConcrete.GetNumberOfValues() *
+                                 (sizeof(ValueType) + sizeof(vtkm::Vec<ValueType, FORCE_ENSEMBLE_SIZE>)));
     };
     // This would be easier with CastAndCallScalarField, but this is only available in
     // FilterField. Then again, the use in MapField is not great as it is usually better
@@ -12,6 +12,11 @@
 
 #include <vtkm/filter/Filter.h>
 
+#include "FilterInstrumentation.h"
+#include "SubsampleKeysCache.h"
+
+#include <memory>
+
 namespace vtkm
 {
 namespace worklet
@@ -40,6 +45,10 @@ class SubsampleUncertaintyEnsemble : public vtkm::filter::Filter
   std::string EnsembleSuffix = "_ensemble";
   vtkm::IdComponent BlockSize = 4;
 
+  SubsampleKeysCache KeysCache;
+
+  FilterInstrumentation Instrumentation;
+
 public:
   SubsampleUncertaintyEnsemble() = default;
 
@@ -63,12 +72,26 @@ public:
   VTKM_CONT vtkm::IdComponent GetBlockSize() const { return this->BlockSize; }
   ///@}
 
+  /// Releases the keys kept from the previous execution (see `SubsampleKeysCache`).
+  VTKM_CONT void ReleaseCachedKeys() { this->KeysCache.Release(); }
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
 private:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
 
   VTKM_CONT void MapField(vtkm::cont::DataSet& data,
                           const vtkm::cont::Field& field,
-                          const vtkm::worklet::Keys<vtkm::Id>& keys) const;
+                          const vtkm::worklet::Keys<vtkm::Id>& keys,
+                          FilterInstrumentation& instrumentation) const;
 };
 
 }
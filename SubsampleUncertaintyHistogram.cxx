@@ -0,0 +1,177 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "SubsampleUncertaintyHistogram.h"
+
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/Keys.h>
+
+#include "ucvworklet/ExtractingHistogram.hpp"
+
+namespace
+{
+
+template <typename CountType, vtkm::IdComponent NumBins, typename ValuesArrayType, typename MinMaxArrayType>
+VTKM_CONT vtkm::cont::UnknownArrayHandle ComputeHistogram(const vtkm::worklet::Keys<vtkm::Id>& keys,
+                                                          const ValuesArrayType& values,
+                                                          MinMaxArrayType& minArray,
+                                                          MinMaxArrayType& maxArray)
+{
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec<CountType, NumBins>> histogram;
+  invoke(ExtractingHistogram{}, keys, values, minArray, maxArray, histogram);
+  return histogram;
+}
+
+template <typename CountType, typename ValuesArrayType, typename MinMaxArrayType>
+VTKM_CONT vtkm::cont::UnknownArrayHandle ComputeHistogram(vtkm::IdComponent numBins,
+                                                          const vtkm::worklet::Keys<vtkm::Id>& keys,
+                                                          const ValuesArrayType& values,
+                                                          MinMaxArrayType& minArray,
+                                                          MinMaxArrayType& maxArray)
+{
+  switch (numBins)
+  {
+    case 8:
+      return ComputeHistogram<CountType, 8>(keys, values, minArray, maxArray);
+    case 16:
+      return ComputeHistogram<CountType, 16>(keys, values, minArray, maxArray);
+    case 32:
+      return ComputeHistogram<CountType, 32>(keys, values, minArray, maxArray);
+    default:
+      throw vtkm::cont::ErrorBadValue("The number of bins of the histograms must be 8, 16 or 32.");
+  }
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+vtkm::cont::DataSet SubsampleUncertaintyHistogram::DoExecute(const vtkm::cont::DataSet& input)
+{
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorBadType("Extraction only works for CellSetStructured<3>.");
+  }
+  vtkm::cont::CellSetStructured<3> cellSet;
+  input.GetCellSet().AsCellSet(cellSet);
+
+  if ((this->NumberOfBins != 8) && (this->NumberOfBins != 16) && (this->NumberOfBins != 32))
+  {
+    throw vtkm::cont::ErrorBadValue("The number of bins of the histograms must be 8, 16 or 32.");
+  }
+  // The counts of a block must fit in 16 bits.
+  if ((this->BlockSize < 1) ||
+      (static_cast<vtkm::Id>(this->BlockSize) * this->BlockSize * this->BlockSize > 65535))
+  {
+    throw vtkm::cont::ErrorBadValue("The block size of the histograms must be between 1 and 40.");
+  }
+
+  vtkm::Id3 numPoints = cellSet.GetPointDimensions();
+
+  vtkm::Id3 numBlocks = (numPoints + vtkm::Id3(this->BlockSize - 1)) / vtkm::Id3(this->BlockSize);
+
+  vtkm::cont::CellSetStructured<3> newCellSet;
+  newCellSet.SetPointDimensions(numBlocks);
+
+  if (!input.GetCoordinateSystem().GetData().CanConvert<vtkm::cont::ArrayHandleUniformPointCoordinates>())
+  {
+    // Technically, the filter would still "work", but the new coordinates below is only
+    // valid with uniform coordiantes.
+    throw vtkm::cont::ErrorBadType("Extraction only works with uniform point coordinates.");
+  }
+  vtkm::Bounds bounds = input.GetCoordinateSystem().GetBounds();
+  vtkm::Vec3f origin{ bounds.MinCorner() };
+  vtkm::Vec3f spacing{ (bounds.MaxCorner() - bounds.MinCorner()) / (numBlocks - 1) };
+  vtkm::cont::ArrayHandleUniformPointCoordinates newCoordinates{ numBlocks, origin, spacing };
+
+  // Create key that groups subsampling (reused if the grid has not changed)
+  const vtkm::worklet::Keys<vtkm::Id>& keys =
+    this->KeysCache.Get(numPoints, numBlocks, this->BlockSize, this->Instrumentation);
+  auto mapper = [&](vtkm::cont::DataSet& data, const vtkm::cont::Field& field) {
+    this->MapField(data, field, keys, this->Instrumentation);
+  };
+  FilterInstrumentation::ScopedStage stage(this->Instrumentation, "reduce");
+  this->Instrumentation.AddCount("points_processed", numPoints[0] * numPoints[1] * numPoints[2]);
+  this->Instrumentation.AddCount("blocks", numBlocks[0] * numBlocks[1] * numBlocks[2]);
+  return this->CreateResultCoordinateSystem(input,
+                                            newCellSet,
+                                            input.GetCoordinateSystem().GetName(),
+                                            newCoordinates,
+                                            mapper);
+}
+
+VTKM_CONT void SubsampleUncertaintyHistogram::MapField(
+    vtkm::cont::DataSet& data,
+    const vtkm::cont::Field& field,
+    const vtkm::worklet::Keys<vtkm::Id>& keys,
+    FilterInstrumentation& instrumentation) const
+{
+  if (field.IsPointField())
+  {
+    vtkm::cont::UnknownArrayHandle minArray;
+    vtkm::cont::UnknownArrayHandle maxArray;
+    vtkm::cont::UnknownArrayHandle histogramArray;
+    // The largest block holds BlockSize^3 values, they are counted with 8 bits if possible.
+    bool smallCounts = (this->BlockSize * this->BlockSize * this->BlockSize) <= 255;
+    // Only scalar fields are supported, a histogram of vectors is not meaningful here.
+    auto resolveType = [&](const auto& concrete) {
+      using ValueType = typename std::decay_t<decltype(concrete)>::ValueType;
+      vtkm::cont::ArrayHandle<ValueType> minConcrete;
+      vtkm::cont::ArrayHandle<ValueType> maxConcrete;
+      if (smallCounts)
+      {
+        histogramArray = ComputeHistogram<vtkm::UInt8>(
+          this->NumberOfBins, keys, concrete, minConcrete, maxConcrete);
+      }
+      else
+      {
+        histogramArray = ComputeHistogram<vtkm::UInt16>(
+          this->NumberOfBins, keys, concrete, minConcrete, maxConcrete);
+      }
+      minArray = minConcrete;
+      maxArray = maxConcrete;
+      instrumentation.AddBytes("output",
+                               minConcrete.GetNumberOfValues() *
+                                 (2 * sizeof(ValueType) +
+                                  this->NumberOfBins *
+                                    (smallCounts ? sizeof(vtkm::UInt8) : sizeof(vtkm::UInt16))));
+    };
+    field.GetData().CastAndCallForTypesWithFloatFallback<vtkm::TypeListFieldScalar, VTKM_DEFAULT_STORAGE_LIST>(
+          resolveType);
+    data.AddPointField(field.GetName() + this->GetMinSuffix(), minArray);
+    data.AddPointField(field.GetName() + this->GetMaxSuffix(), maxArray);
+    data.AddPointField(field.GetName() + this->GetHistogramSuffix(), histogramArray);
+  }
+  else if (field.IsWholeDataSetField())
+  {
+    // No change.
+    data.AddField(field);
+  }
+  else
+  {
+    // Cell fields not supported. They get dropped.
+  }
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
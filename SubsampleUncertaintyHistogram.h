@@ -0,0 +1,121 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_SubsampleUncertaintyHistogram_h
+#define vtk_m_filter_uncertainty_SubsampleUncertaintyHistogram_h
+
+#include <vtkm/filter/Filter.h>
+
+#include "FilterInstrumentation.h"
+#include "SubsampleKeysCache.h"
+
+#include <memory>
+
+namespace vtkm
+{
+namespace worklet
+{
+// Forward declaration
+template <typename T>
+class Keys;
+}
+}
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Subsamples a regular grid and captures the uncertainty as a histogram.
+///
+/// The uniform and gaussian models do not fit blocks with several modes (for example at
+/// the boundary of two materials), and the ensemble field keeps all the values of each
+/// block. This filter captures the distribution of each block with a histogram of a fixed
+/// number of bins between the min and the max of the block. Each scalar point field gives
+/// three fields: the min, the max and the histogram, a `Vec` of counts with one component
+/// per bin. The counts are stored as `UInt8` when a block has at most 255 values
+/// (a block size up to 6) and as `UInt16` otherwise, so the block size can not be
+/// larger than 40.
+///
+/// With 16 bins and a block size of 4, a point uses 16 bytes for the counts (plus the min
+/// and max) instead of 256 bytes for the ensemble of 64 float values. The histograms are
+/// used by `ContourUncertainHistogram`.
+///
+class SubsampleUncertaintyHistogram : public vtkm::filter::Filter
+{
+  std::string MinSuffix = "_min";
+  std::string MaxSuffix = "_max";
+  std::string HistogramSuffix = "_histogram";
+  vtkm::IdComponent BlockSize = 4;
+  vtkm::IdComponent NumberOfBins = 16;
+
+  SubsampleKeysCache KeysCache;
+
+  FilterInstrumentation Instrumentation;
+
+public:
+  SubsampleUncertaintyHistogram() = default;
+
+  ///@{
+  /// \brief The suffix used for fields modeling uncertainty.
+  ///
+  /// The min, max and histogram fields are given the name of the input field appended
+  /// with the appropriate suffix.
+  ///
+  VTKM_CONT void SetMinSuffix(const std::string& suffix) { this->MinSuffix = suffix; }
+  VTKM_CONT const std::string& GetMinSuffix() const { return this->MinSuffix; }
+  VTKM_CONT void SetMaxSuffix(const std::string& suffix) { this->MaxSuffix = suffix; }
+  VTKM_CONT const std::string& GetMaxSuffix() const { return this->MaxSuffix; }
+  VTKM_CONT void SetHistogramSuffix(const std::string& suffix) { this->HistogramSuffix = suffix; }
+  VTKM_CONT const std::string& GetHistogramSuffix() const { return this->HistogramSuffix; }
+  ///@}
+
+  ///@{
+  /// \brief Specifies the reduction factor for the subsampling
+  ///
+  VTKM_CONT void SetBlockSize(vtkm::IdComponent blocksize) { this->BlockSize = blocksize; }
+  VTKM_CONT vtkm::IdComponent GetBlockSize() const { return this->BlockSize; }
+  ///@}
+
+  ///@{
+  /// \brief Specifies the number of bins of the histograms, 8, 16 (the default) or 32.
+  ///
+  VTKM_CONT void SetNumberOfBins(vtkm::IdComponent numBins) { this->NumberOfBins = numBins; }
+  VTKM_CONT vtkm::IdComponent GetNumberOfBins() const { return this->NumberOfBins; }
+  ///@}
+
+  /// Releases the keys kept from the previous execution (see `SubsampleKeysCache`).
+  VTKM_CONT void ReleaseCachedKeys() { this->KeysCache.Release(); }
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+private:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+
+  VTKM_CONT void MapField(vtkm::cont::DataSet& data,
+                          const vtkm::cont::Field& field,
+                          const vtkm::worklet::Keys<vtkm::Id>& keys,
+                          FilterInstrumentation& instrumentation) const;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_SubsampleUncertaintyHistogram_h
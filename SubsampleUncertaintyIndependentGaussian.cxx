@@ -19,7 +19,7 @@
 
 #include <vtkm/worklet/Keys.h>
 
-#include "ucvworklet/CreateNewKey.hpp"
+#include "ucvworklet/ExtractingNeighborCorrelation.hpp"
 #include "ucvworklet/ExtractingMeanStdev.hpp"
 
 namespace
@@ -29,7 +29,10 @@ VTKM_CONT void ComputeMeanStdevForField(
     const vtkm::filter::uncertainty::SubsampleUncertaintyIndependentGaussian* self,
     vtkm::cont::DataSet& data,
     const vtkm::cont::Field& field,
-    const vtkm::worklet::Keys<vtkm::Id>& keys)
+    const vtkm::worklet::Keys<vtkm::Id>& keys,
+    const vtkm::Id3& numPoints,
+    const vtkm::Id3& numBlocks,
+    vtkm::filter::uncertainty::FilterInstrumentation& instrumentation)
 {
   if (field.IsPointField())
   {
@@ -46,8 +49,26 @@ VTKM_CONT void ComputeMeanStdevForField(
       invoke(ExtractingMeanStdev{}, keys, concrete, meanConcrete, stdevConcrete);
     };
     inArray.CastAndCallWithExtractedArray(resolveType);
+    instrumentation.AddBytes("output",
+                             2 * keys.GetInputRange() * inArray.GetNumberOfComponentsFlat() *
+                               sizeof(vtkm::FloatDefault));
     data.AddPointField(field.GetName() + self->GetMeanSuffix(), meanArray);
     data.AddPointField(field.GetName() + self->GetStdevSuffix(), stdevArray);
+
+    if (self->GetComputeCorrelation() && (inArray.GetNumberOfComponentsFlat() == 1))
+    {
+      vtkm::cont::ArrayHandle<vtkm::Vec3f> correlationArray;
+      auto resolveScalarType = [&](const auto& concrete) {
+        invoke(ExtractingNeighborCorrelation{ numPoints, numBlocks, self->GetBlockSize() },
+               vtkm::cont::ArrayHandleIndex{ keys.GetInputRange() },
+               concrete,
+               correlationArray);
+      };
+      inArray.CastAndCallForTypesWithFloatFallback<vtkm::TypeListFieldScalar, VTKM_DEFAULT_STORAGE_LIST>(
+        resolveScalarType);
+      instrumentation.AddBytes("output", keys.GetInputRange() * sizeof(vtkm::Vec3f));
+      data.AddPointField(field.GetName() + self->GetCorrelationSuffix(), correlationArray);
+    }
   }
   else if (field.IsWholeDataSetField())
   {
@@ -96,16 +117,15 @@ vtkm::cont::DataSet SubsampleUncertaintyIndependentGaussian::DoExecute(const vtk
   vtkm::Vec3f spacing{ (bounds.MaxCorner() - bounds.MinCorner()) / (numBlocks - 1) };
   vtkm::cont::ArrayHandleUniformPointCoordinates newCoordinates{ numBlocks, origin, spacing };
 
-  // Create key that groups subsampling
-  vtkm::cont::ArrayHandle<vtkm::Id> keyArray;
-  this->Invoke(CreateNewKeyWorklet{numPoints, numBlocks, this->BlockSize},
-               vtkm::cont::ArrayHandleIndex{ numPoints[0] * numPoints[1] * numPoints[2] },
-               keyArray);
-
-  vtkm::worklet::Keys<vtkm::Id> keys{ keyArray };
+  // Create key that groups subsampling (reused if the grid has not changed)
+  const vtkm::worklet::Keys<vtkm::Id>& keys =
+    this->KeysCache.Get(numPoints, numBlocks, this->BlockSize, this->Instrumentation);
   auto mapper = [&](vtkm::cont::DataSet& data, const vtkm::cont::Field& field) {
-    ComputeMeanStdevForField(this, data, field, keys);
+    ComputeMeanStdevForField(this, data, field, keys, numPoints, numBlocks, this->Instrumentation);
   };
+  FilterInstrumentation::ScopedStage stage(this->Instrumentation, "reduce");
+  this->Instrumentation.AddCount("points_processed", numPoints[0] * numPoints[1] * numPoints[2]);
+  this->Instrumentation.AddCount("blocks", numBlocks[0] * numBlocks[1] * numBlocks[2]);
   return this->CreateResultCoordinateSystem(input,
                                             newCellSet,
                                             input.GetCoordinateSystem().GetName(),
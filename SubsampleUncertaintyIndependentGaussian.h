@@ -12,6 +12,9 @@
 
 #include <vtkm/filter/Filter.h>
 
+#include "FilterInstrumentation.h"
+#include "SubsampleKeysCache.h"
+
 namespace vtkm
 {
 namespace filter
@@ -25,7 +28,13 @@ class SubsampleUncertaintyIndependentGaussian : public vtkm::filter::Filter
 {
   std::string MeanSuffix = "_mean";
   std::string StdevSuffix = "_stdev";
+  std::string CorrelationSuffix = "_correlation";
   vtkm::IdComponent BlockSize = 4;
+  bool ComputeCorrelation = false;
+
+  SubsampleKeysCache KeysCache;
+
+  FilterInstrumentation Instrumentation;
 
 public:
   SubsampleUncertaintyIndependentGaussian() = default;
@@ -42,6 +51,24 @@ public:
   VTKM_CONT const std::string& GetMeanSuffix() const { return this->MeanSuffix; }
   VTKM_CONT void SetStdevSuffix(const std::string& suffix) { this->StdevSuffix = suffix; }
   VTKM_CONT const std::string& GetStdevSuffix() const { return this->StdevSuffix; }
+  VTKM_CONT void SetCorrelationSuffix(const std::string& suffix)
+  {
+    this->CorrelationSuffix = suffix;
+  }
+  VTKM_CONT const std::string& GetCorrelationSuffix() const { return this->CorrelationSuffix; }
+  ///@}
+
+  ///@{
+  /// \brief Also captures the correlation between neighboring blocks.
+  ///
+  /// When on, each scalar field gets a third field, a `Vec3f` with the correlation between
+  /// each block and its next block along x, y and z. The values of the two blocks are paired
+  /// by their position in the block, like the ensembles of the multivariant gaussian model.
+  /// This only takes 3 values per point and is used by `ContourUncertainSeparableGaussian`.
+  /// Off by default.
+  ///
+  VTKM_CONT void SetComputeCorrelation(bool flag) { this->ComputeCorrelation = flag; }
+  VTKM_CONT bool GetComputeCorrelation() const { return this->ComputeCorrelation; }
   ///@}
 
   ///@{
@@ -51,6 +78,19 @@ public:
   VTKM_CONT vtkm::IdComponent GetBlockSize() const { return this->BlockSize; }
   ///@}
 
+  /// Releases the keys kept from the previous execution (see `SubsampleKeysCache`).
+  VTKM_CONT void ReleaseCachedKeys() { this->KeysCache.Release(); }
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
 private:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
 };
@@ -0,0 +1,141 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "SubsampleUncertaintyMixture.h"
+
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/Keys.h>
+
+#include "ucvworklet/ExtractingMixture.hpp"
+
+namespace
+{
+
+template <vtkm::IdComponent K, typename ValuesArrayType>
+VTKM_CONT vtkm::cont::UnknownArrayHandle ComputeMixture(const vtkm::worklet::Keys<vtkm::Id>& keys,
+                                                        const ValuesArrayType& values,
+                                                        vtkm::IdComponent maxIterations,
+                                                        vtkm::FloatDefault tolerance)
+{
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3 * K>> mixture;
+  invoke(ExtractingMixture{ maxIterations, tolerance }, keys, values, mixture);
+  return mixture;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+vtkm::cont::DataSet SubsampleUncertaintyMixture::DoExecute(const vtkm::cont::DataSet& input)
+{
+  if (!input.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorBadType("Extraction only works for CellSetStructured<3>.");
+  }
+  vtkm::cont::CellSetStructured<3> cellSet;
+  input.GetCellSet().AsCellSet(cellSet);
+
+  if ((this->NumberOfComponents < 2) || (this->NumberOfComponents > 4))
+  {
+    throw vtkm::cont::ErrorBadValue("The number of components of the mixtures must be 2, 3 or 4.");
+  }
+
+  vtkm::Id3 numPoints = cellSet.GetPointDimensions();
+
+  vtkm::Id3 numBlocks = (numPoints + vtkm::Id3(this->BlockSize - 1)) / vtkm::Id3(this->BlockSize);
+
+  vtkm::cont::CellSetStructured<3> newCellSet;
+  newCellSet.SetPointDimensions(numBlocks);
+
+  if (!input.GetCoordinateSystem().GetData().CanConvert<vtkm::cont::ArrayHandleUniformPointCoordinates>())
+  {
+    // Technically, the filter would still "work", but the new coordinates below is only
+    // valid with uniform coordiantes.
+    throw vtkm::cont::ErrorBadType("Extraction only works with uniform point coordinates.");
+  }
+  vtkm::Bounds bounds = input.GetCoordinateSystem().GetBounds();
+  vtkm::Vec3f origin{ bounds.MinCorner() };
+  vtkm::Vec3f spacing{ (bounds.MaxCorner() - bounds.MinCorner()) / (numBlocks - 1) };
+  vtkm::cont::ArrayHandleUniformPointCoordinates newCoordinates{ numBlocks, origin, spacing };
+
+  // Create key that groups subsampling (reused if the grid has not changed)
+  const vtkm::worklet::Keys<vtkm::Id>& keys =
+    this->KeysCache.Get(numPoints, numBlocks, this->BlockSize, this->Instrumentation);
+  auto mapper = [&](vtkm::cont::DataSet& data, const vtkm::cont::Field& field) {
+    this->MapField(data, field, keys, this->Instrumentation);
+  };
+  FilterInstrumentation::ScopedStage stage(this->Instrumentation, "reduce");
+  this->Instrumentation.AddCount("points_processed", numPoints[0] * numPoints[1] * numPoints[2]);
+  this->Instrumentation.AddCount("blocks", numBlocks[0] * numBlocks[1] * numBlocks[2]);
+  return this->CreateResultCoordinateSystem(input,
+                                            newCellSet,
+                                            input.GetCoordinateSystem().GetName(),
+                                            newCoordinates,
+                                            mapper);
+}
+
+VTKM_CONT void SubsampleUncertaintyMixture::MapField(
+    vtkm::cont::DataSet& data,
+    const vtkm::cont::Field& field,
+    const vtkm::worklet::Keys<vtkm::Id>& keys,
+    FilterInstrumentation& instrumentation) const
+{
+  if (field.IsPointField())
+  {
+    vtkm::cont::UnknownArrayHandle mixtureArray;
+    // Only scalar fields are supported. The parameters are always stored as FloatDefault,
+    // the means and the deviations of an integer field are not integers.
+    auto resolveType = [&](const auto& concrete) {
+      switch (this->NumberOfComponents)
+      {
+        case 2:
+          mixtureArray = ComputeMixture<2>(keys, concrete, this->MaxIterations, this->Tolerance);
+          break;
+        case 3:
+          mixtureArray = ComputeMixture<3>(keys, concrete, this->MaxIterations, this->Tolerance);
+          break;
+        default:
+          mixtureArray = ComputeMixture<4>(keys, concrete, this->MaxIterations, this->Tolerance);
+          break;
+      }
+    };
+    field.GetData().CastAndCallForTypesWithFloatFallback<vtkm::TypeListFieldScalar, VTKM_DEFAULT_STORAGE_LIST>(
+          resolveType);
+    instrumentation.AddBytes("output",
+                             keys.GetInputRange() * 3 * this->NumberOfComponents *
+                               sizeof(vtkm::FloatDefault));
+    data.AddPointField(field.GetName() + this->GetMixtureSuffix(), mixtureArray);
+  }
+  else if (field.IsWholeDataSetField())
+  {
+    // No change.
+    data.AddField(field);
+  }
+  else
+  {
+    // Cell fields not supported. They get dropped.
+  }
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
@@ -0,0 +1,127 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_SubsampleUncertaintyMixture_h
+#define vtk_m_filter_uncertainty_SubsampleUncertaintyMixture_h
+
+#include <vtkm/filter/Filter.h>
+
+#include "FilterInstrumentation.h"
+#include "SubsampleKeysCache.h"
+
+#include <memory>
+
+namespace vtkm
+{
+namespace worklet
+{
+// Forward declaration
+template <typename T>
+class Keys;
+}
+}
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Subsamples a regular grid and captures the uncertainty as a gaussian mixture.
+///
+/// A single gaussian does not fit blocks with several modes (for example at the boundary
+/// of two materials). This filter fits a mixture of 2 to 4 gaussians to the values of each
+/// block with a bounded number of iterations of the expectation maximization algorithm.
+/// Each scalar point field gives one field, a `Vec` of `3 * K` values holding the weights,
+/// the means and the standard deviations of the K components (in this order). With 2
+/// components a point uses 6 values instead of the 64 values of the ensemble field. The
+/// mixtures are used by `ContourUncertainMixture`.
+///
+class SubsampleUncertaintyMixture : public vtkm::filter::Filter
+{
+  std::string MixtureSuffix = "_gmm";
+  vtkm::IdComponent BlockSize = 4;
+  vtkm::IdComponent NumberOfComponents = 2;
+  vtkm::IdComponent MaxIterations = 20;
+  vtkm::FloatDefault Tolerance = 1e-4f;
+
+  SubsampleKeysCache KeysCache;
+
+  FilterInstrumentation Instrumentation;
+
+public:
+  SubsampleUncertaintyMixture() = default;
+
+  ///@{
+  /// \brief The suffix used for fields modeling uncertainty.
+  ///
+  /// The mixture field is given the name of the input field appended with this suffix.
+  ///
+  VTKM_CONT void SetMixtureSuffix(const std::string& suffix) { this->MixtureSuffix = suffix; }
+  VTKM_CONT const std::string& GetMixtureSuffix() const { return this->MixtureSuffix; }
+  ///@}
+
+  ///@{
+  /// \brief Specifies the reduction factor for the subsampling
+  ///
+  VTKM_CONT void SetBlockSize(vtkm::IdComponent blocksize) { this->BlockSize = blocksize; }
+  VTKM_CONT vtkm::IdComponent GetBlockSize() const { return this->BlockSize; }
+  ///@}
+
+  ///@{
+  /// \brief Specifies the number of gaussians of the mixtures, 2 (the default), 3 or 4.
+  ///
+  VTKM_CONT void SetNumberOfComponents(vtkm::IdComponent numComponents)
+  {
+    this->NumberOfComponents = numComponents;
+  }
+  VTKM_CONT vtkm::IdComponent GetNumberOfComponents() const { return this->NumberOfComponents; }
+  ///@}
+
+  ///@{
+  /// \brief Specifies when the expectation maximization stops.
+  ///
+  /// The fit of a block stops after `MaxIterations` iterations (20 by default) or when the
+  /// relative change of the log likelihood is below `Tolerance` (1e-4 by default). The
+  /// number of iterations is bounded so that all the blocks take about the same time.
+  ///
+  VTKM_CONT void SetMaxIterations(vtkm::IdComponent iterations) { this->MaxIterations = iterations; }
+  VTKM_CONT vtkm::IdComponent GetMaxIterations() const { return this->MaxIterations; }
+  VTKM_CONT void SetTolerance(vtkm::FloatDefault tolerance) { this->Tolerance = tolerance; }
+  VTKM_CONT vtkm::FloatDefault GetTolerance() const { return this->Tolerance; }
+  ///@}
+
+  /// Releases the keys kept from the previous execution (see `SubsampleKeysCache`).
+  VTKM_CONT void ReleaseCachedKeys() { this->KeysCache.Release(); }
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
+private:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+
+  VTKM_CONT void MapField(vtkm::cont::DataSet& data,
+                          const vtkm::cont::Field& field,
+                          const vtkm::worklet::Keys<vtkm::Id>& keys,
+                          FilterInstrumentation& instrumentation) const;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_SubsampleUncertaintyMixture_h
@@ -10,7 +10,6 @@
 
 #include "SubsampleUncertaintyUniform.h"
 
-#include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
 #include <vtkm/cont/CellSetStructured.h>
 #include <vtkm/cont/DataSet.h>
@@ -19,7 +18,6 @@
 
 #include <vtkm/worklet/Keys.h>
 
-#include "ucvworklet/CreateNewKey.hpp"
 #include "ucvworklet/ExtractingMinMax.hpp"
 
 namespace
@@ -29,7 +27,8 @@ VTKM_CONT void ComputeMinMaxForField(
     const vtkm::filter::uncertainty::SubsampleUncertaintyUniform* self,
     vtkm::cont::DataSet& data,
     const vtkm::cont::Field& field,
-    const vtkm::worklet::Keys<vtkm::Id>& keys)
+    const vtkm::worklet::Keys<vtkm::Id>& keys,
+    vtkm::filter::uncertainty::FilterInstrumentation& instrumentation)
 {
   if (field.IsPointField())
   {
@@ -45,6 +44,8 @@ VTKM_CONT void ComputeMinMaxForField(
       auto minConcrete = minArray.ExtractArrayFromComponents<ComponentType>();
       auto maxConcrete = maxArray.ExtractArrayFromComponents<ComponentType>();
       invoke(ExtractingMinMax{}, keys, concrete, minConcrete, maxConcrete);
+      instrumentation.AddBytes(
+        "output", 2 * keys.GetInputRange() * inArray.GetNumberOfComponentsFlat() * sizeof(ComponentType));
     };
     inArray.CastAndCallWithExtractedArray(resolveType);
     data.AddPointField(field.GetName() + self->GetMinSuffix(), minArray);
@@ -97,16 +98,15 @@ vtkm::cont::DataSet SubsampleUncertaintyUniform::DoExecute(const vtkm::cont::Dat
   vtkm::Vec3f spacing{ (bounds.MaxCorner() - bounds.MinCorner()) / (numBlocks - 1) };
   vtkm::cont::ArrayHandleUniformPointCoordinates newCoordinates{ numBlocks, origin, spacing };
 
-  // Create key that groups subsampling
-  vtkm::cont::ArrayHandle<vtkm::Id> keyArray;
-  this->Invoke(CreateNewKeyWorklet{numPoints, numBlocks, this->BlockSize},
-               vtkm::cont::ArrayHandleIndex{ numPoints[0] * numPoints[1] * numPoints[2] },
-               keyArray);
-
-  vtkm::worklet::Keys<vtkm::Id> keys{ keyArray };
+  // Create key that groups subsampling (reused if the grid has not changed)
+  const vtkm::worklet::Keys<vtkm::Id>& keys =
+    this->KeysCache.Get(numPoints, numBlocks, this->BlockSize, this->Instrumentation);
   auto mapper = [&](vtkm::cont::DataSet& data, const vtkm::cont::Field& field) {
-    ComputeMinMaxForField(this, data, field, keys);
+    ComputeMinMaxForField(this, data, field, keys, this->Instrumentation);
   };
+  FilterInstrumentation::ScopedStage stage(this->Instrumentation, "reduce");
+  this->Instrumentation.AddCount("points_processed", numPoints[0] * numPoints[1] * numPoints[2]);
+  this->Instrumentation.AddCount("blocks", numBlocks[0] * numBlocks[1] * numBlocks[2]);
   return this->CreateResultCoordinateSystem(input,
                                             newCellSet,
                                             input.GetCoordinateSystem().GetName(),
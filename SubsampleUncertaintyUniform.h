@@ -12,6 +12,9 @@
 
 #include <vtkm/filter/Filter.h>
 
+#include "FilterInstrumentation.h"
+#include "SubsampleKeysCache.h"
+
 namespace vtkm
 {
 namespace filter
@@ -27,6 +30,10 @@ class SubsampleUncertaintyUniform : public vtkm::filter::Filter
   std::string MaxSuffix = "_max";
   vtkm::IdComponent BlockSize = 4;
 
+  SubsampleKeysCache KeysCache;
+
+  FilterInstrumentation Instrumentation;
+
 public:
   SubsampleUncertaintyUniform() = default;
 
@@ -51,6 +58,19 @@ public:
   VTKM_CONT vtkm::IdComponent GetBlockSize() const { return this->BlockSize; }
   ///@}
 
+  /// Releases the keys kept from the previous execution (see `SubsampleKeysCache`).
+  VTKM_CONT void ReleaseCachedKeys() { this->KeysCache.Release(); }
+
+  ///@{
+  /// \brief The timings, counters and allocations recorded by this filter.
+  ///
+  VTKM_CONT FilterInstrumentation& GetInstrumentation() { return this->Instrumentation; }
+  VTKM_CONT const FilterInstrumentation& GetInstrumentation() const
+  {
+    return this->Instrumentation;
+  }
+  ///@}
+
 private:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
 };
@@ -0,0 +1,364 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "UncertaintyRuntime.h"
+
+#include "HardwareCounters.h"
+
+#include <vtkm/List.h>
+#include <vtkm/TypeList.h>
+#include <vtkm/cont/ArrayHandleBasic.h>
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+#include <vtkm/cont/Token.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace
+{
+
+std::string GetEnvironment(const char* name, const std::string& defaultValue)
+{
+  const char* value = std::getenv(name);
+  return (value != nullptr) ? std::string(value) : defaultValue;
+}
+
+// Pins each OpenMP thread to one of the cores allowed for the process.
+// Returns false if the threads could not be pinned.
+bool PinThreads(vtkm::filter::uncertainty::UncertaintyRuntime::PinningType pinning)
+{
+#if defined(_OPENMP) && defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+  {
+    return false;
+  }
+  std::vector<int> cores;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (CPU_ISSET(cpu, &allowed))
+    {
+      cores.push_back(cpu);
+    }
+  }
+  if (cores.empty())
+  {
+    return false;
+  }
+
+  bool pinned = true;
+#pragma omp parallel reduction(&& : pinned)
+  {
+    int numThreads = omp_get_num_threads();
+    int thread = omp_get_thread_num();
+    std::size_t index =
+      (pinning == vtkm::filter::uncertainty::UncertaintyRuntime::PinningType::Compact)
+      ? static_cast<std::size_t>(thread) % cores.size()
+      : (static_cast<std::size_t>(thread) * cores.size() / static_cast<std::size_t>(numThreads)) %
+        cores.size();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cores[index], &set);
+    pinned = (sched_setaffinity(0, sizeof(set), &set) == 0);
+  }
+  return pinned;
+#else
+  (void)pinning;
+  return false;
+#endif
+}
+
+// Arrays smaller than this stay where they are, they fit in the caches anyway.
+constexpr vtkm::BufferSizeType MinimumPlacedBytes = 4 * 1024 * 1024;
+
+// At most this many pages are queried by PrintPlacement.
+constexpr std::size_t MaximumQueriedPages = 4096;
+
+// Copies the array with one contiguous range of values per OpenMP thread,
+// so the pages of the copy are first touched by the threads that own them.
+template <typename T>
+vtkm::cont::ArrayHandle<T> FirstTouchCopy(const vtkm::cont::ArrayHandle<T>& source)
+{
+  vtkm::Id numValues = source.GetNumberOfValues();
+  vtkm::cont::ArrayHandleBasic<T> placed;
+  placed.Allocate(numValues);
+
+  vtkm::cont::Token token;
+  const T* in = vtkm::cont::ArrayHandleBasic<T>(source).GetReadPointer(token);
+  T* out = placed.GetWritePointer(token);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (vtkm::Id i = 0; i < numValues; ++i)
+  {
+    out[i] = in[i];
+  }
+  return placed;
+}
+
+struct PlaceBasicArray
+{
+  template <typename T>
+  void operator()(T, vtkm::cont::UnknownArrayHandle& array, bool& placed) const
+  {
+    if (!placed && array.IsType<vtkm::cont::ArrayHandle<T>>())
+    {
+      array = FirstTouchCopy(array.AsArrayHandle<vtkm::cont::ArrayHandle<T>>());
+      placed = true;
+    }
+  }
+};
+
+// The NUMA node of the sampled pages of the buffer, -1 for the pages that could not be
+// queried (such as the pages that were never touched).
+std::vector<int> QueryPageNodes(const void* pointer, std::size_t numBytes)
+{
+  std::vector<int> nodes;
+#ifdef __linux__
+  const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  std::uintptr_t first = reinterpret_cast<std::uintptr_t>(pointer) / pageSize * pageSize;
+  std::uintptr_t last = reinterpret_cast<std::uintptr_t>(pointer) + numBytes;
+  std::size_t numPages = (last - first + pageSize - 1) / pageSize;
+  std::size_t stride = (numPages + MaximumQueriedPages - 1) / MaximumQueriedPages;
+
+  std::vector<void*> pages;
+  for (std::size_t page = 0; page < numPages; page += stride)
+  {
+    pages.push_back(reinterpret_cast<void*>(first + page * pageSize));
+  }
+  std::vector<int> status(pages.size(), -1);
+  // Without target nodes move_pages only reports the node of each page.
+  if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0)
+  {
+    return nodes;
+  }
+  nodes.reserve(status.size());
+  for (int node : status)
+  {
+    nodes.push_back(node >= 0 ? node : -1);
+  }
+#else
+  (void)pointer;
+  (void)numBytes;
+#endif
+  return nodes;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+void UncertaintyRuntime::Initialize(int& argc, char* argv[])
+{
+  // The counters only count the threads created after they are opened, so they are opened
+  // before anything below (or the placement of the fields) starts the OpenMP threads.
+  if (GetEnvironment("UCV_PERF_COUNTERS", "0") != "0")
+  {
+    HardwareCounters::GetInstance();
+  }
+
+  vtkm::cont::InitializeResult initResult =
+    vtkm::cont::Initialize(argc, argv, vtkm::cont::InitializeOptions::DefaultAnyDevice);
+  this->Device = initResult.Device;
+  this->Usage = initResult.Usage;
+
+  std::string backend = GetEnvironment("UCV_VTKM_BACKEND", "");
+  if (!backend.empty())
+  {
+    std::cout << "Setting the device with UCV_VTKM_BACKEND=" << backend << "\n";
+    std::cout << "This method is antiquated. Consider using the --vtkm-device command line argument."
+              << std::endl;
+
+    vtkm::cont::RuntimeDeviceTracker& deviceTracker = vtkm::cont::GetRuntimeDeviceTracker();
+    if (backend == "serial")
+    {
+      this->Device = vtkm::cont::DeviceAdapterTagSerial{};
+    }
+    else if (backend == "openmp")
+    {
+      this->Device = vtkm::cont::DeviceAdapterTagOpenMP{};
+    }
+    else if (backend == "cuda")
+    {
+      this->Device = vtkm::cont::DeviceAdapterTagCuda{};
+    }
+    else
+    {
+      std::cerr << " unrecognized backend " << backend << std::endl;
+    }
+    if (this->Device != vtkm::cont::DeviceAdapterTagAny{})
+    {
+      deviceTracker.ForceDevice(this->Device);
+    }
+  }
+
+#ifdef _OPENMP
+  std::string numThreads = GetEnvironment("UCV_NUM_THREADS", "");
+  if (!numThreads.empty())
+  {
+    omp_set_num_threads(std::stoi(numThreads));
+  }
+  this->NumberOfThreads = omp_get_max_threads();
+#endif
+
+  std::string pinning = GetEnvironment("UCV_PIN_THREADS", "none");
+  if (pinning == "compact")
+  {
+    this->Pinning = PinningType::Compact;
+  }
+  else if (pinning == "spread")
+  {
+    this->Pinning = PinningType::Spread;
+  }
+  else if (pinning != "none")
+  {
+    std::cerr << " unrecognized UCV_PIN_THREADS " << pinning << ", use none, compact or spread"
+              << std::endl;
+  }
+  if (this->Pinning != PinningType::None && !PinThreads(this->Pinning))
+  {
+    std::cerr << " the threads could not be pinned" << std::endl;
+    this->Pinning = PinningType::None;
+  }
+
+  this->FirstTouch = (GetEnvironment("UCV_FIRST_TOUCH", "1") != "0");
+  this->NumaReport = (GetEnvironment("UCV_NUMA_REPORT", "0") != "0");
+}
+
+std::string UncertaintyRuntime::GetDeviceName() const
+{
+  if (this->Device != vtkm::cont::DeviceAdapterTagAny{})
+  {
+    return this->Device.GetName();
+  }
+  // The device that is tried first when any device is allowed.
+  vtkm::cont::RuntimeDeviceTracker& deviceTracker = vtkm::cont::GetRuntimeDeviceTracker();
+  if (deviceTracker.CanRunOn(vtkm::cont::DeviceAdapterTagCuda{}))
+  {
+    return vtkm::cont::DeviceAdapterTagCuda{}.GetName();
+  }
+  if (deviceTracker.CanRunOn(vtkm::cont::DeviceAdapterTagOpenMP{}))
+  {
+    return vtkm::cont::DeviceAdapterTagOpenMP{}.GetName();
+  }
+  return vtkm::cont::DeviceAdapterTagSerial{}.GetName();
+}
+
+bool UncertaintyRuntime::UseFirstTouch() const
+{
+  return this->FirstTouch && (this->NumberOfThreads > 1) &&
+    ((this->Device == vtkm::cont::DeviceAdapterTagOpenMP{}) ||
+     (this->Device == vtkm::cont::DeviceAdapterTagAny{})) &&
+    (this->GetDeviceName() == vtkm::cont::DeviceAdapterTagOpenMP{}.GetName());
+}
+
+bool UncertaintyRuntime::PlaceArray(vtkm::cont::UnknownArrayHandle& array) const
+{
+  if (!this->UseFirstTouch() || !array.IsStorageType<vtkm::cont::StorageTagBasic>())
+  {
+    return false;
+  }
+  if (array.GetBuffers()[0].GetNumberOfBytes() < MinimumPlacedBytes)
+  {
+    return false;
+  }
+  bool placed = false;
+  vtkm::ListForEach(PlaceBasicArray{}, vtkm::TypeListAll{}, array, placed);
+  return placed;
+}
+
+bool UncertaintyRuntime::PlaceField(vtkm::cont::DataSet& dataset,
+                                    const std::string& fieldName) const
+{
+  vtkm::cont::Field field = dataset.GetField(fieldName);
+  vtkm::cont::UnknownArrayHandle data = field.GetData();
+  if (this->NumaReport)
+  {
+    this->PrintPlacement(data, fieldName + " (read)", std::cout);
+  }
+  if (!this->PlaceArray(data))
+  {
+    return false;
+  }
+  dataset.AddField(vtkm::cont::Field(fieldName, field.GetAssociation(), data));
+  if (this->NumaReport)
+  {
+    this->PrintPlacement(data, fieldName + " (placed)", std::cout);
+  }
+  return true;
+}
+
+void UncertaintyRuntime::PrintPlacement(const vtkm::cont::UnknownArrayHandle& array,
+                                        const std::string& name,
+                                        std::ostream& out) const
+{
+  if (!array.IsStorageType<vtkm::cont::StorageTagBasic>())
+  {
+    return;
+  }
+  vtkm::cont::internal::Buffer buffer = array.GetBuffers()[0];
+  vtkm::cont::Token token;
+  std::vector<int> nodes =
+    QueryPageNodes(buffer.ReadPointerHost(token), static_cast<std::size_t>(buffer.GetNumberOfBytes()));
+  if (nodes.empty())
+  {
+    return;
+  }
+
+  std::map<int, std::size_t> pagesPerNode;
+  for (int node : nodes)
+  {
+    pagesPerNode[node]++;
+  }
+  out << "placement of " << name << " (" << nodes.size() << " pages sampled):";
+  for (const auto& entry : pagesPerNode)
+  {
+    out << " " << (entry.first >= 0 ? "node " + std::to_string(entry.first) : "unknown") << " "
+        << std::fixed << std::setprecision(1)
+        << 100.0 * static_cast<double>(entry.second) / static_cast<double>(nodes.size()) << "%";
+  }
+  out << std::defaultfloat << std::endl;
+}
+
+void UncertaintyRuntime::PrintSummary(std::ostream& out) const
+{
+  const char* pinningNames[] = { "none", "compact", "spread" };
+  out << "device: " << this->GetDeviceName() << ", threads: " << this->NumberOfThreads
+      << ", pinning: " << pinningNames[static_cast<int>(this->Pinning)]
+      << ", first touch: " << (this->UseFirstTouch() ? "on" : "off");
+  if (this->CudaBlocks > 0)
+  {
+    out << ", cuda parameters: " << this->CudaBlocks << " " << this->CudaThreadsPerBlock;
+  }
+  out << std::endl;
+}
+
+}
+}
+} // namespace vtkm::filter::uncertainty
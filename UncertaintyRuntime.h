@@ -0,0 +1,181 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_uncertainty_UncertaintyRuntime_h
+#define vtk_m_filter_uncertainty_UncertaintyRuntime_h
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DeviceAdapterList.h>
+#include <vtkm/cont/Initialize.h>
+#include <vtkm/cont/UnknownArrayHandle.h>
+
+#ifdef VTKM_CUDA
+// Note: this header will require the driver to be compiled with nvcc, but it is required
+// for vtkm::cont::cuda::ScheduleParameters.
+#include <vtkm/cont/cuda/DeviceAdapterCuda.h>
+#endif
+
+#include <cstdlib>
+#include <ostream>
+#include <string>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace uncertainty
+{
+
+/// \brief Configures the device and the threads of a driver in the same way for every run.
+///
+/// Each driver creates one of these at the start of `main` (after `MPI_Init` if it uses
+/// MPI) instead of calling `vtkm::cont::Initialize` itself. It removes the VTK-m options
+/// from `argc`/`argv` and then applies the following environment variables:
+///
+/// - `UCV_VTKM_BACKEND` forces the device (`serial`, `openmp` or `cuda`). This is kept
+///   for the old scripts, `--vtkm-device` should be used instead.
+/// - `UCV_NUM_THREADS` sets the number of OpenMP threads (default: the OpenMP default).
+/// - `UCV_PIN_THREADS` pins the OpenMP threads to the cores allowed for the process:
+///   `compact` (thread i on the i-th core), `spread` (the threads evenly spaced over the
+///   cores) or `none` (default).
+/// - `UCV_FIRST_TOUCH` (default 1) lets `PlaceArray` redistribute large arrays so that
+///   each page is first written by the thread that processes it, which puts the pages on
+///   the NUMA node of that thread.
+/// - `UCV_NUMA_REPORT=1` makes `PlaceField` print the NUMA nodes of the pages of the field
+///   before and after it is redistributed.
+/// - `UCV_PERF_COUNTERS` (when not 0) opens the `HardwareCounters` before any OpenMP
+///   thread is created, so the threads of the pool are counted.
+/// - `UCV_GPU_NUMBLOCK` and `UCV_GPU_BLOCKPERTHREAD` set the CUDA schedule of the
+///   1D worklets (both must be set).
+///
+class UncertaintyRuntime
+{
+public:
+  enum struct PinningType
+  {
+    None,
+    Compact,
+    Spread
+  };
+
+  VTKM_CONT UncertaintyRuntime(int& argc, char* argv[])
+  {
+    this->Initialize(argc, argv);
+#ifdef VTKM_CUDA
+    this->InitializeCudaSchedule();
+#endif
+  }
+
+  /// The device selected with `--vtkm-device` or `UCV_VTKM_BACKEND` (may be any device).
+  VTKM_CONT vtkm::cont::DeviceAdapterId GetDevice() const { return this->Device; }
+
+  /// The name of the device, or of the device that will be used if any device is allowed.
+  VTKM_CONT std::string GetDeviceName() const;
+
+  /// The usage of the VTK-m options, for the help of the drivers.
+  VTKM_CONT const std::string& GetUsage() const { return this->Usage; }
+
+  /// The number of OpenMP threads, 1 without OpenMP.
+  VTKM_CONT int GetNumberOfThreads() const { return this->NumberOfThreads; }
+
+  VTKM_CONT PinningType GetPinning() const { return this->Pinning; }
+
+  VTKM_CONT bool GetFirstTouch() const { return this->FirstTouch; }
+
+  VTKM_CONT bool GetNumaReport() const { return this->NumaReport; }
+
+  /// \brief Redistributes the pages of a large array for the NUMA nodes of the threads.
+  ///
+  /// The array is copied into a new array that is written in parallel by the threads
+  /// that process it, so each page is placed on the NUMA node of the thread that first
+  /// touches it (the Linux default policy). Arrays that are filled by a single thread,
+  /// such as the ones read from a file, otherwise end up on one node. The copy splits
+  /// the values in one contiguous range per thread, like the static schedule of the
+  /// OpenMP worklets. This does nothing when first touch is disabled, when the device is
+  /// not OpenMP, for small arrays and for arrays that are not stored in a basic array.
+  /// Returns true if the array was redistributed.
+  ///
+  VTKM_CONT bool PlaceArray(vtkm::cont::UnknownArrayHandle& array) const;
+
+  template <typename T>
+  VTKM_CONT bool PlaceArray(vtkm::cont::ArrayHandle<T>& array) const
+  {
+    vtkm::cont::UnknownArrayHandle unknown = array;
+    if (!this->PlaceArray(unknown))
+    {
+      return false;
+    }
+    unknown.AsArrayHandle(array);
+    return true;
+  }
+
+  /// Redistributes the array of a field of the data set, see `PlaceArray`.
+  VTKM_CONT bool PlaceField(vtkm::cont::DataSet& dataset, const std::string& fieldName) const;
+
+  /// \brief Prints the fraction of the pages of the array on each NUMA node.
+  ///
+  /// The nodes are queried with `move_pages` for up to 4096 pages evenly spaced over the
+  /// array. Nothing is printed if the array is not a basic array or if the query is not
+  /// supported.
+  ///
+  VTKM_CONT void PrintPlacement(const vtkm::cont::UnknownArrayHandle& array,
+                                const std::string& name,
+                                std::ostream& out) const;
+
+  /// Prints the configuration of the run.
+  VTKM_CONT void PrintSummary(std::ostream& out) const;
+
+private:
+  VTKM_CONT void Initialize(int& argc, char* argv[]);
+  VTKM_CONT bool UseFirstTouch() const;
+
+#ifdef VTKM_CUDA
+  static vtkm::cont::cuda::ScheduleParameters& CudaScheduleParameters()
+  {
+    static vtkm::cont::cuda::ScheduleParameters parameters;
+    return parameters;
+  }
+
+  static vtkm::cont::cuda::ScheduleParameters CudaSchedule(char const*, int, int, int, int, int)
+  {
+    return CudaScheduleParameters();
+  }
+
+  VTKM_CONT void InitializeCudaSchedule()
+  {
+    char const* nblock = std::getenv("UCV_GPU_NUMBLOCK");
+    char const* nthread = std::getenv("UCV_GPU_BLOCKPERTHREAD");
+    if (nblock != nullptr && nthread != nullptr)
+    {
+      CudaScheduleParameters().one_d_blocks = std::stoi(std::string(nblock));
+      CudaScheduleParameters().one_d_threads_per_block = std::stoi(std::string(nthread));
+      // the input value for the init scheduled parameter is a function
+      vtkm::cont::cuda::InitScheduleParameters(CudaSchedule);
+      this->CudaBlocks = CudaScheduleParameters().one_d_blocks;
+      this->CudaThreadsPerBlock = CudaScheduleParameters().one_d_threads_per_block;
+    }
+  }
+#endif
+
+  vtkm::cont::DeviceAdapterId Device = vtkm::cont::DeviceAdapterTagAny{};
+  std::string Usage;
+  int NumberOfThreads = 1;
+  PinningType Pinning = PinningType::None;
+  bool FirstTouch = true;
+  bool NumaReport = false;
+  int CudaBlocks = 0;
+  int CudaThreadsPerBlock = 0;
+};
+
+}
+}
+} // namespace vtkm::filter::uncertainty
+
+#endif //vtk_m_filter_uncertainty_UncertaintyRuntime_h
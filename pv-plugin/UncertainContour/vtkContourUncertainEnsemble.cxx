@@ -16,7 +16,24 @@ VTK_ABI_NAMESPACE_BEGIN
 
 vtkStandardNewMacro(vtkContourUncertainEnsemble);
 
-vtkContourUncertainEnsemble::vtkContourUncertainEnsemble() = default;
+// Everything that is kept between updates. The VTK-m filter holds the factorization
+// of each cell, and the converted input is kept so it does not need to be converted
+// again. Both are valid as long as the input and the selected arrays do not change.
+struct vtkContourUncertainEnsemble::CacheInternals
+{
+  vtkm::filter::uncertainty::ContourUncertainEnsemble Filter;
+  vtkm::cont::DataSet Input;
+  vtkDataSet* InputObject = nullptr;
+  vtkMTimeType InputMTime = 0;
+  std::string MeanName;
+  std::string EnsembleName;
+  bool Valid = false;
+};
+
+vtkContourUncertainEnsemble::vtkContourUncertainEnsemble()
+  : Cache(new CacheInternals)
+{
+}
 vtkContourUncertainEnsemble::~vtkContourUncertainEnsemble() = default;
 
 std::string vtkContourUncertainEnsemble::GetInputArrayName(
@@ -68,43 +85,69 @@ int vtkContourUncertainEnsemble::RequestData(
 
   try
   {
-    // Convert the input dataset to VTK-m
-    vtkm::cont::DataSet in = tovtkm::Convert(input, tovtkm::FieldsFlag::PointsAndCells);
-
-    // We are expecting the ensemble field to have tuple sizes of 64. This is currently
-    // not directly supported and results in errors. This should be handled correctly
-    // once we move to VTK-m 2.1, but for now hack the movement.
-    vtkDataArray* ensembleArray = this->GetInputArrayToProcess(1, inputVector);
-    if (ensembleArray->GetNumberOfComponents() == 64)
+    std::string meanName = this->GetInputArrayName(0, inputVector);
+    std::string ensembleName = this->GetInputArrayName(1, inputVector);
+
+    CacheInternals& cache = *this->Cache;
+    if (!this->CacheFactorization || !cache.Valid || (cache.InputObject != input) ||
+        (cache.InputMTime != input->GetMTime()) || (cache.MeanName != meanName) ||
+        (cache.EnsembleName != ensembleName))
     {
-      bool converted = false;
-      auto tryVtkToVtkm = [&](auto vtkArray) {
-        if (vtkArray == nullptr)
+      cache.Valid = false;
+      cache.Filter.InvalidateFactorization();
+
+      // Convert the input dataset to VTK-m
+      vtkm::cont::DataSet in = tovtkm::Convert(input, tovtkm::FieldsFlag::PointsAndCells);
+
+      // We are expecting the ensemble field to have tuple sizes of 64. This is currently
+      // not directly supported and results in errors. This should be handled correctly
+      // once we move to VTK-m 2.1, but for now hack the movement.
+      vtkDataArray* ensembleArray = this->GetInputArrayToProcess(1, inputVector);
+      if (ensembleArray->GetNumberOfComponents() == 64)
+      {
+        bool converted = false;
+        auto tryVtkToVtkm = [&](auto vtkArray) {
+          if (vtkArray == nullptr)
+          {
+            return;
+          }
+          auto vtkmArray =
+            tovtkm::DataArrayToArrayHandle<std::remove_pointer_t<decltype(vtkArray)>, 64>::Wrap(vtkArray);
+          in.AddPointField(vtkArray->GetName(), vtkmArray);
+          converted = true;
+        };
+        tryVtkToVtkm(vtkAOSDataArrayTemplate<float>::SafeDownCast(ensembleArray));
+        tryVtkToVtkm(vtkAOSDataArrayTemplate<double>::SafeDownCast(ensembleArray));
+        if (!converted)
         {
-          return;
+          vtkErrorMacro(<< "Unable to convert ensemble field.");
+          return 0;
         }
-        auto vtkmArray =
-          tovtkm::DataArrayToArrayHandle<std::remove_pointer_t<decltype(vtkArray)>, 64>::Wrap(vtkArray);
-        in.AddPointField(vtkArray->GetName(), vtkmArray);
-        converted = true;
-      };
-      tryVtkToVtkm(vtkAOSDataArrayTemplate<float>::SafeDownCast(ensembleArray));
-      tryVtkToVtkm(vtkAOSDataArrayTemplate<double>::SafeDownCast(ensembleArray));
-      if (!converted)
-      {
-        vtkErrorMacro(<< "Unable to convert ensemble field.");
-        return 0;
       }
+
+      cache.Input = in;
+      cache.InputObject = input;
+      cache.InputMTime = input->GetMTime();
+      cache.MeanName = meanName;
+      cache.EnsembleName = ensembleName;
+      cache.Valid = this->CacheFactorization;
     }
 
-    vtkm::filter::uncertainty::ContourUncertainEnsemble filter;
+    vtkm::filter::uncertainty::ContourUncertainEnsemble& filter = cache.Filter;
+    filter.SetCacheFactorization(this->CacheFactorization);
     filter.SetIsoValue(this->IsoValue);
     filter.SetCrossProbabilityName(this->ContourProbabilityName);
     filter.SetNumberNonzeroProbabilityName(this->NumberNonzeroProbabilityName);
     filter.SetEntropyName(this->EntropyName);
-    filter.SetMeanField(this->GetInputArrayName(0, inputVector));
-    filter.SetEnsembleField(this->GetInputArrayName(1, inputVector));
-    vtkm::cont::DataSet result = filter.Execute(in);
+    filter.SetMeanField(meanName);
+    filter.SetEnsembleField(ensembleName);
+    vtkm::cont::DataSet result = filter.Execute(cache.Input);
+
+    if (!this->CacheFactorization)
+    {
+      // Do not hold on to the converted input.
+      cache.Input = vtkm::cont::DataSet{};
+    }
 
     // Convert the result back.
     // It would be easier if there was a simple method to just convert from general
@@ -146,6 +189,7 @@ void vtkContourUncertainEnsemble::PrintSelf(ostream&os, vtkIndent indent)
   os << indent << "ContourProbabilityName: " << this->ContourProbabilityName << "\n";
   os << indent << "NumberNonzeroProbabilityName: " << this->NumberNonzeroProbabilityName << "\n";
   os << indent << "EntropyName: " << this->EntropyName << "\n";
+  os << indent << "CacheFactorization: " << this->CacheFactorization << "\n";
 }
 
 VTK_ABI_NAMESPACE_END
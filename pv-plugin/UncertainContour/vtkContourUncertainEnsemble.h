@@ -19,6 +19,8 @@
 #include "vtkImageAlgorithm.h" // Currently only support regular grids. Superclass may change.
 #include "vtkmlib/vtkmInitializer.h"
 
+#include <memory> // for std::unique_ptr
+
 VTK_ABI_NAMESPACE_BEGIN
 
 class VTKUNCERTAINCONTOURFILTERS_EXPORT vtkContourUncertainEnsemble : public vtkImageAlgorithm
@@ -90,6 +92,20 @@ public:
   vtkGetMacro(EntropyName, std::string);
   ///@}
 
+  ///@{
+  /// \brief Keep the covariance factorization of each cell between updates.
+  ///
+  /// Computing the covariance of each cell and its eigendecomposition is the expensive part
+  /// of this filter, but it does not depend on the isovalue. When this is on (the default),
+  /// the converted input, the mean vector and the factor of each cell are kept as long as
+  /// the input (and the selected arrays) do not change, so changing the isovalue only
+  /// reruns the sampling.
+  ///
+  vtkSetMacro(CacheFactorization, bool);
+  vtkGetMacro(CacheFactorization, bool);
+  vtkBooleanMacro(CacheFactorization, bool);
+  ///@}
+
 protected:
   vtkContourUncertainEnsemble();
   ~vtkContourUncertainEnsemble();
@@ -100,6 +116,7 @@ protected:
   std::string ContourProbabilityName = "contour_probability";
   std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
   std::string EntropyName = "entropy";
+  bool CacheFactorization = true;
 
 private:
   vtkContourUncertainEnsemble(const vtkContourUncertainEnsemble&) = delete;
@@ -107,6 +124,9 @@ private:
 
   vtkmInitializer Initializer;
 
+  struct CacheInternals;
+  std::unique_ptr<CacheInternals> Cache;
+
   std::string GetInputArrayName(int index, vtkInformationVector** inputVector);
 };
 
@@ -0,0 +1,257 @@
+#include "vtkContourUncertainProgressive.h"
+
+#include "ContourUncertainProgressive.h"
+
+#include "vtkCellData.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include "vtkmlib/DataSetConverters.h"
+#include "vtkmlib/ImageDataConverter.h"
+
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/Error.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace
+{
+
+inline std::array<int, 3> ExtentToDimensions(const std::array<int, 6>& wholeExtent)
+{
+  return { wholeExtent[1] - wholeExtent[0] + 1,
+           wholeExtent[3] - wholeExtent[2] + 1,
+           wholeExtent[5] - wholeExtent[4] + 1 };
+}
+
+inline std::array<int, 6> DimensionsToExtent(
+    const std::array<int, 3>& dimensions, const std::array<int, 3>& origin = { 0, 0, 0 })
+{
+  return { origin[0], dimensions[0] + origin[0] - 1,
+           origin[1], dimensions[1] + origin[1] - 1,
+           origin[2], dimensions[2] + origin[2] - 1 };
+}
+
+} // abstract namespace
+
+VTK_ABI_NAMESPACE_BEGIN
+
+vtkStandardNewMacro(vtkContourUncertainProgressive);
+
+vtkContourUncertainProgressive::vtkContourUncertainProgressive()
+{
+  this->SetNumberOfOutputPorts(2);
+}
+
+vtkContourUncertainProgressive::~vtkContourUncertainProgressive() = default;
+
+void vtkContourUncertainProgressive::SetInputField(const char* name)
+{
+  this->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, name);
+}
+void vtkContourUncertainProgressive::SetInputField(int fieldAttributeType)
+{
+  this->SetInputArrayToProcess(0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, fieldAttributeType);
+}
+
+std::vector<int> vtkContourUncertainProgressive::GetBlockSizes() const
+{
+  // Each level halves the block size of the previous one, so each cell of a level
+  // is covered by a single cell of the previous level.
+  std::vector<int> blockSizes;
+  for (int blockSize = this->FinestBlockSize; blockSize <= this->CoarsestBlockSize;
+       blockSize *= 2)
+  {
+    blockSizes.push_back(blockSize);
+  }
+  if (blockSizes.empty())
+  {
+    blockSizes.push_back(this->FinestBlockSize);
+  }
+  std::reverse(blockSizes.begin(), blockSizes.end());
+  return blockSizes;
+}
+
+int vtkContourUncertainProgressive::FillOutputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 1)
+  {
+    // One image per refinement level.
+    info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkMultiBlockDataSet");
+    return 1;
+  }
+  return this->Superclass::FillOutputPortInformation(port, info);
+}
+
+// This filter is going to resize the structured grid to the finest level. The VTK
+// streaming pipeline uses this information to request parts of the data. Make sure
+// we accurately report the size of data that this filter will return.
+int vtkContourUncertainProgressive::RequestInformation(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  this->Superclass::RequestInformation(request, inputVector, outputVector);
+
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  std::array<int, 6> wholeExtent;
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent.data());
+
+  std::array<int, 3> dimensions = ExtentToDimensions(wholeExtent);
+
+  for (auto& dim : dimensions)
+  {
+    dim = (dim + this->FinestBlockSize - 1) / this->FinestBlockSize;
+  }
+
+  wholeExtent = DimensionsToExtent(dimensions);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent.data(), 6);
+
+  // The levels have different dimensions, so the multiblock output has no single extent.
+  outputVector->GetInformationObject(1)->Remove(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
+
+  return 1;
+}
+
+// Because this filter resized the grid, it altered the whole extent of the data (see
+// RequestInformation). Thus, we need to alter the requested extent to match the whole
+// extent of the input.
+int vtkContourUncertainProgressive::RequestUpdateExtent(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  this->Superclass::RequestUpdateExtent(request, inputVector, outputVector);
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+
+  std::array<int, 6> wholeExtent;
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExtent.data());
+  std::array<int, 3> wholeDimensions = ExtentToDimensions(wholeExtent);
+
+  std::array<int, 6> updateExtent;
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent.data());
+  std::array<int, 3> updateDimensions = ExtentToDimensions(updateExtent);
+
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    updateDimensions[i] =
+      std::min(updateDimensions[i] * this->FinestBlockSize, wholeDimensions[i]);
+  }
+
+  updateExtent = DimensionsToExtent(updateDimensions,
+                                    { wholeExtent[0], wholeExtent[2], wholeExtent[4] });
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent.data(), 6);
+
+  return 1;
+}
+
+int vtkContourUncertainProgressive::RequestData(
+  vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  // Get the info objects
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  vtkImageData* input = vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData* output = vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkMultiBlockDataSet* levelsOutput = vtkMultiBlockDataSet::GetData(outputVector, 1);
+
+  int association = this->GetInputArrayAssociation(0, inputVector);
+  vtkDataArray* inputArray = this->GetInputArrayToProcess(0, inputVector);
+  if ((association != vtkDataObject::FIELD_ASSOCIATION_POINTS) || (inputArray == nullptr))
+  {
+    vtkErrorMacro("Invalid input array; array missing or not a point array.");
+    return 0;
+  }
+  const char* fieldName = inputArray->GetName();
+  if (!fieldName || fieldName[0] == '\0')
+  {
+    fieldName = tovtkm::NoNameVTKFieldName();
+  }
+
+  try
+  {
+    // Convert the input dataset to VTK-m
+    vtkm::cont::DataSet in = tovtkm::Convert(input, tovtkm::FieldsFlag::PointsAndCells);
+
+    std::vector<int> blockSizes = this->GetBlockSizes();
+    double numLevels = static_cast<double>(blockSizes.size());
+
+    vtkm::filter::uncertainty::ContourUncertainProgressive filter;
+    filter.SetActiveField(fieldName, vtkm::cont::Field::Association::Points);
+    filter.SetBlockSizes(std::vector<vtkm::IdComponent>(blockSizes.begin(), blockSizes.end()));
+    filter.SetDistribution(
+      (this->Distribution == INDEPENDENT_GAUSSIAN)
+        ? vtkm::filter::uncertainty::ContourUncertainProgressive::DistributionType::IndependentGaussian
+        : vtkm::filter::uncertainty::ContourUncertainProgressive::DistributionType::Uniform);
+    filter.SetCullThreshold(this->CullThreshold);
+    filter.SetIsoValue(this->IsoValue);
+    filter.SetCrossProbabilityName(this->ContourProbabilityName);
+    filter.SetNumberNonzeroProbabilityName(this->NumberNonzeroProbabilityName);
+    filter.SetEntropyName(this->EntropyName);
+
+    // Each level is added to the second output as soon as it is computed.
+    levelsOutput->SetNumberOfBlocks(static_cast<unsigned int>(blockSizes.size()));
+    bool levelsConverted = true;
+    filter.SetLevelCallback([&](const vtkm::cont::DataSet& levelResult, vtkm::IdComponent level) {
+      vtkNew<vtkImageData> levelImage;
+      if (fromvtkm::Convert(levelResult, levelImage, input))
+      {
+        levelImage->GetCellData()->SetActiveScalars(this->ContourProbabilityName.c_str());
+        unsigned int blockIndex = static_cast<unsigned int>(level);
+        levelsOutput->SetBlock(blockIndex, levelImage);
+        levelsOutput->GetMetaData(blockIndex)->Set(vtkCompositeDataSet::NAME(),
+          ("Block Size " + std::to_string(blockSizes[blockIndex])).c_str());
+      }
+      else
+      {
+        levelsConverted = false;
+      }
+      this->UpdateProgress((level + 1) / numLevels);
+    });
+    vtkm::cont::DataSet result = filter.Execute(in);
+
+    if (!levelsConverted)
+    {
+      vtkErrorMacro(<< "Unable to convert the VTK-m DataSet of a level back to VTK.");
+      return 0;
+    }
+
+    if (!fromvtkm::Convert(result, output, input))
+    {
+      vtkErrorMacro(<< "Unable to convert VTK-m DataSet back to VTK.");
+      return 0;
+    }
+    output->GetCellData()->SetActiveScalars(this->ContourProbabilityName.c_str());
+  }
+  catch (const vtkm::cont::Error& e)
+  {
+    vtkErrorMacro(<< "VTK-m error: " << e.GetMessage());
+    return 0;
+  }
+
+  return 1;
+}
+
+void vtkContourUncertainProgressive::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Distribution: " << this->Distribution << "\n";
+  os << indent << "CoarsestBlockSize: " << this->CoarsestBlockSize << "\n";
+  os << indent << "FinestBlockSize: " << this->FinestBlockSize << "\n";
+  os << indent << "CullThreshold: " << this->CullThreshold << "\n";
+  os << indent << "IsoValue: " << this->IsoValue << "\n";
+  os << indent << "ContourProbabilityName: " << this->ContourProbabilityName << "\n";
+  os << indent << "NumberNonzeroProbabilityName: " << this->NumberNonzeroProbabilityName << "\n";
+  os << indent << "EntropyName: " << this->EntropyName << "\n";
+}
+
+VTK_ABI_NAMESPACE_END
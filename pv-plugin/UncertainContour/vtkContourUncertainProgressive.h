@@ -0,0 +1,149 @@
+/**
+ * @class vtkContourUncertainProgressive
+ * @brief Finds the probability of contour location with progressive refinement.
+ *
+ * This filter subsamples a regular grid, captures the uncertainty of each block
+ * of points with a uniform or an independent Gaussian distribution, and computes
+ * the probability of the contour being in each cell of the subsampled grid.
+ *
+ * The computation starts on a heavily coarsened grid and is refined by halving
+ * the block size until the finest block size is reached. Each refinement only
+ * computes the cells whose parent cell in the previous level may contain the
+ * contour, so the coarse levels are cheap and the finer levels only touch the
+ * cells near the contour. The progress of the filter is updated as each level
+ * is finished.
+ *
+ * The first output is the finest level. The second output is a multiblock
+ * dataset with one image per level, from the coarsest to the finest, so the
+ * cheap coarse levels can be looked at before the finer ones. Each block is
+ * added as soon as its level is computed.
+ */
+
+#ifndef vtkContourUncertainProgressive_h
+#define vtkContourUncertainProgressive_h
+
+#include "vtkUncertainContourFiltersModule.h" // for export macro
+#include "vtkImageAlgorithm.h"
+#include "vtkmlib/vtkmInitializer.h"
+
+#include <vector>
+
+VTK_ABI_NAMESPACE_BEGIN
+
+class VTKUNCERTAINCONTOURFILTERS_EXPORT vtkContourUncertainProgressive : public vtkImageAlgorithm
+{
+public:
+  vtkTypeMacro(vtkContourUncertainProgressive, vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  static vtkContourUncertainProgressive *New();
+
+  enum DistributionTypes
+  {
+    UNIFORM = 0,
+    INDEPENDENT_GAUSSIAN = 1
+  };
+
+  ///@{
+  /// \brief The input field to contour.
+  ///
+  /// Note that these are convenience methods that call `SetInputArrayToProcess`
+  /// to set input 0.
+  ///
+  void SetInputField(const char* name);
+  void SetInputField(int fieldAttributeType);
+  ///@}
+
+  ///@{
+  /// \brief The model used for the uncertainty of each block of points.
+  ///
+  /// Either `UNIFORM` (the min/max of the block) or `INDEPENDENT_GAUSSIAN`
+  /// (the mean/standard deviation of the block).
+  ///
+  vtkSetClampMacro(Distribution, int, UNIFORM, INDEPENDENT_GAUSSIAN);
+  vtkGetMacro(Distribution, int);
+  ///@}
+
+  ///@{
+  /// \brief The block sizes of the first and of the last refinement levels.
+  ///
+  /// The block size is halved for each level, starting from the largest multiple
+  /// of the finest block size by a power of 2 that is not larger than the
+  /// coarsest block size. The output has the dimensions of the finest level.
+  ///
+  vtkSetClampMacro(CoarsestBlockSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(CoarsestBlockSize, int);
+  vtkSetClampMacro(FinestBlockSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(FinestBlockSize, int);
+  ///@}
+
+  ///@{
+  /// \brief The cross probability above which a cell is refined.
+  ///
+  /// The default of 0.001 skips the cells far from the contour for both
+  /// distributions. The Gaussian distribution needs a positive value to skip
+  /// any cell, a value of 0 is exact for the uniform distribution.
+  ///
+  vtkSetMacro(CullThreshold, double);
+  vtkGetMacro(CullThreshold, double);
+  ///@}
+
+  ///@{
+  /// \brief The scalar value to use for the isosurface.
+  ///
+  vtkSetMacro(IsoValue, double);
+  vtkGetMacro(IsoValue, double);
+  ///@}
+
+  ///@{
+  /// The name of the output field giving the probability of the contour existing in each cell.
+  ///
+  vtkSetMacro(ContourProbabilityName, std::string);
+  vtkGetMacro(ContourProbabilityName, std::string);
+  ///@}
+
+  ///@{
+  /// The name of the output field giving the number of possible marching
+  /// contour cases for each cell.
+  ///
+  vtkSetMacro(NumberNonzeroProbabilityName, std::string);
+  vtkGetMacro(NumberNonzeroProbabilityName, std::string);
+  ///@}
+
+  ///@{
+  /// The name of the output field giving the entropy of the possible
+  /// marching contour cases for each cell.
+  ///
+  vtkSetMacro(EntropyName, std::string);
+  vtkGetMacro(EntropyName, std::string);
+  ///@}
+
+protected:
+  vtkContourUncertainProgressive();
+  ~vtkContourUncertainProgressive() override;
+
+  int FillOutputPortInformation(int port, vtkInformation* info) override;
+  int RequestInformation(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+  int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
+
+  int Distribution = UNIFORM;
+  int CoarsestBlockSize = 16;
+  int FinestBlockSize = 4;
+  double CullThreshold = 0.001;
+  double IsoValue = 0.0;
+  std::string ContourProbabilityName = "contour_probability";
+  std::string NumberNonzeroProbabilityName = "num_nonzero_probability";
+  std::string EntropyName = "entropy";
+
+private:
+  vtkContourUncertainProgressive(const vtkContourUncertainProgressive&) = delete;
+  void operator=(const vtkContourUncertainProgressive&) = delete;
+
+  vtkmInitializer Initializer;
+
+  std::vector<int> GetBlockSizes() const;
+};
+
+VTK_ABI_NAMESPACE_END
+
+#endif //vtkContourUncertainProgressive_h
@@ -0,0 +1,215 @@
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/Initialize.h>
+
+#include "EnsemblePCA.h"
+#include "ucvworklet/linalg/ucv_symmetric_eigen.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+// checks the jacobi eigenpairs used by EnsemblePCA and the low rank covariance U U^T + D
+// of its output against the covariance of a small ensemble computed directly
+
+const int NumPoints = 6;
+const int NumMembers = 5;
+
+// the members of each point
+double ensemble[NumPoints][NumMembers] = {
+    {1.0, 2.0, 3.0, 4.0, 5.0},
+    {2.0, 1.5, 3.5, 3.0, 6.0},
+    {0.5, 2.5, 2.0, 5.0, 4.0},
+    {3.0, 3.0, 1.0, 2.0, 2.5},
+    {1.5, 0.0, 4.0, 4.5, 3.0},
+    {2.5, 2.0, 2.5, 1.0, 5.5}};
+
+// relative to the magnitude of b, the filter outputs are FloatDefault
+int equal_double(double a, double b, double tolerance)
+{
+    if (fabs(a - b) < tolerance * fmax(1.0, fabs(b)))
+    {
+        return 1;
+    }
+    return 0;
+}
+
+double member_mean(int point)
+{
+    double sum = 0;
+    for (int m = 0; m < NumMembers; m++)
+    {
+        sum += ensemble[point][m];
+    }
+    return sum / NumMembers;
+}
+
+// the sample covariance of two points over the members
+double covariance(int a, int b)
+{
+    double meanA = member_mean(a);
+    double meanB = member_mean(b);
+    double sum = 0;
+    for (int m = 0; m < NumMembers; m++)
+    {
+        sum += (ensemble[a][m] - meanA) * (ensemble[b][m] - meanB);
+    }
+    return sum / (NumMembers - 1);
+}
+
+// A v = lambda v for each pair, orthonormal vectors and the eigenvalues add up to the trace
+void check_eigen_pairs(const std::vector<double> &matrix, int size)
+{
+    std::vector<double> values;
+    std::vector<double> vectors;
+    UCVMATH::SymmetricEigen(matrix, size, values, vectors);
+
+    double trace = 0;
+    double sum = 0;
+    for (int i = 0; i < size; i++)
+    {
+        trace += matrix[i * size + i];
+        sum += values[i];
+        printf("%f ", values[i]);
+    }
+    printf("\n");
+    assert(equal_double(sum, trace, 1e-9) == 1);
+
+    for (int e = 0; e < size; e++)
+    {
+        for (int row = 0; row < size; row++)
+        {
+            double av = 0;
+            for (int col = 0; col < size; col++)
+            {
+                av += matrix[row * size + col] * vectors[col * size + e];
+            }
+            assert(equal_double(av, values[e] * vectors[row * size + e], 1e-9) == 1);
+        }
+        for (int f = 0; f < size; f++)
+        {
+            double dot = 0;
+            for (int k = 0; k < size; k++)
+            {
+                dot += vectors[k * size + e] * vectors[k * size + f];
+            }
+            assert(equal_double(dot, e == f ? 1.0 : 0.0, 1e-9) == 1);
+        }
+    }
+}
+
+void test_eigen_2by2()
+{
+    printf("--test_eigen_2by2\n");
+
+    // the eigenvalues are 1 and 3, with the eigenvectors (1, -1) and (1, 1) up to the sign
+    std::vector<double> matrix = {2.0, 1.0,
+                                  1.0, 2.0};
+    std::vector<double> values;
+    std::vector<double> vectors;
+    UCVMATH::SymmetricEigen(matrix, 2, values, vectors);
+
+    int small = values[0] < values[1] ? 0 : 1;
+    int large = 1 - small;
+    assert(equal_double(values[small], 1.0, 1e-9) == 1);
+    assert(equal_double(values[large], 3.0, 1e-9) == 1);
+    assert(equal_double(vectors[0 * 2 + small], -vectors[1 * 2 + small], 1e-9) == 1);
+    assert(equal_double(vectors[0 * 2 + large], vectors[1 * 2 + large], 1e-9) == 1);
+    assert(equal_double(fabs(vectors[0 * 2 + large]), sqrt(0.5), 1e-9) == 1);
+
+    check_eigen_pairs(matrix, 2);
+}
+
+void test_eigen_gram()
+{
+    printf("--test_eigen_gram\n");
+
+    // the gram matrix of the centered members, as EnsemblePCA builds it
+    std::vector<double> gram(NumMembers * NumMembers, 0.0);
+    for (int p = 0; p < NumPoints; p++)
+    {
+        double mean = member_mean(p);
+        for (int a = 0; a < NumMembers; a++)
+        {
+            for (int b = 0; b < NumMembers; b++)
+            {
+                gram[a * NumMembers + b] += (ensemble[p][a] - mean) * (ensemble[p][b] - mean);
+            }
+        }
+    }
+
+    check_eigen_pairs(gram, NumMembers);
+}
+
+// the covariance of the points rebuilt from the coefficients and the residual of EnsemblePCA,
+// the diagonal is always exact, the off diagonal is exact when the rank spans the centered
+// members (NumMembers - 1 directions)
+template <vtkm::IdComponent Rank>
+void test_low_rank()
+{
+    printf("--test_low_rank %d\n", Rank);
+
+    std::vector<vtkm::Vec<vtkm::Float64, NumMembers>> members(NumPoints);
+    for (int p = 0; p < NumPoints; p++)
+    {
+        for (int m = 0; m < NumMembers; m++)
+        {
+            members[p][m] = ensemble[p][m];
+        }
+    }
+
+    vtkm::cont::DataSetBuilderUniform builder;
+    vtkm::cont::DataSet data = builder.Create(vtkm::Id2(3, 2));
+    data.AddPointField("ensemble", vtkm::cont::make_ArrayHandle(members, vtkm::CopyFlag::On));
+
+    vtkm::filter::uncertainty::EnsemblePCA pca;
+    pca.SetEnsembleField("ensemble");
+    pca.SetRank(Rank);
+    vtkm::cont::DataSet result = pca.Execute(data);
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> meanArray;
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, Rank>> coefficientsArray;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> residualArray;
+    result.GetPointField("ensemble_mean").GetData().AsArrayHandle(meanArray);
+    result.GetPointField("ensemble_pca").GetData().AsArrayHandle(coefficientsArray);
+    result.GetPointField("ensemble_residual").GetData().AsArrayHandle(residualArray);
+    auto meanPortal = meanArray.ReadPortal();
+    auto coefficientsPortal = coefficientsArray.ReadPortal();
+    auto residualPortal = residualArray.ReadPortal();
+
+    bool exact = (Rank == NumMembers - 1);
+    for (int a = 0; a < NumPoints; a++)
+    {
+        assert(equal_double(meanPortal.Get(a), member_mean(a), 1e-4) == 1);
+        for (int b = 0; b < NumPoints; b++)
+        {
+            double rebuilt = static_cast<double>(vtkm::Dot(coefficientsPortal.Get(a), coefficientsPortal.Get(b)));
+            if (a == b)
+            {
+                rebuilt += residualPortal.Get(a);
+            }
+            printf("%f ", rebuilt);
+            if (exact || (a == b))
+            {
+                assert(equal_double(rebuilt, covariance(a, b), 1e-4) == 1);
+            }
+        }
+        printf("\n");
+        if (exact)
+        {
+            assert(fabs(residualPortal.Get(a)) < 1e-4 * fmax(1.0, covariance(a, a)));
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    vtkm::cont::Initialize(argc, argv);
+
+    test_eigen_2by2();
+    test_eigen_gram();
+    test_low_rank<4>();
+    test_low_rank<2>();
+    return 0;
+}
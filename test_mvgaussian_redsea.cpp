@@ -13,10 +13,15 @@
 #include "ucvworklet/CreateNewKey.hpp"
 #include "ucvworklet/MVGaussianWithEnsemble2DTryLialgEntropy.hpp"
 #include "ContourUncertainEnsemble2D.h"
+#include "EnsembleStatistics.h"
+#include "EnsemblePCA.h"
+#include "ContourUncertainEnsembleLowRank.h"
 #include "ucvworklet/MVGaussianWithEnsemble2DPolyTryLialgEntropy.hpp"
+#include "UncertaintyRuntime.h"
 
 #include <vtkm/cont/Timer.h>
 
+#include <cstdlib>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -26,53 +31,6 @@
 
 using SupportedTypesVec = vtkm::List<vtkm::Vec<double, 20>>;
 
-std::string backend = "openmp";
-
-void initBackend(vtkm::cont::Timer &timer)
-{
-  // init the vtkh device
-  char const *tmp = getenv("UCV_VTKM_BACKEND");
-
-  if (tmp == nullptr)
-  {
-    std::cout << "no UCV_VTKM_BACKEND env, use openmp" << std::endl;
-    backend = "openmp";
-  }
-  else
-  {
-    backend = std::string(tmp);
-  }
-
-  // if (rank == 0)
-  //{
-  std::cout << "vtkm backend is:" << backend << std::endl;
-  //}
-
-  if (backend == "serial")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagSerial());
-    timer.Reset(vtkm::cont::DeviceAdapterTagSerial());
-  }
-  else if (backend == "openmp")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagOpenMP());
-    timer.Reset(vtkm::cont::DeviceAdapterTagOpenMP());
-  }
-  else if (backend == "cuda")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagCuda());
-    timer.Reset(vtkm::cont::DeviceAdapterTagCuda());
-  }
-  else
-  {
-    std::cerr << " unrecognized backend " << backend << std::endl;
-  }
-  return;
-}
-
 void callWorklet(vtkm::cont::Timer &timer, vtkm::cont::DataSet vtkmDataSet, double iso, int numSamples, std::string datatype)
 {
   timer.Start();
@@ -106,11 +64,38 @@ void callWorklet(vtkm::cont::Timer &timer, vtkm::cont::DataSet vtkmDataSet, doub
   else if (datatype == "stru")
   {
     //try to test the filter
+    // the mean of each point is computed once and shared by its cells
+    vtkm::filter::uncertainty::EnsembleStatistics statistics;
+    statistics.SetEnsembleField("ensemble_array");
+    vtkmDataSet = statistics.Execute(vtkmDataSet);
+
     vtkm::filter::uncertainty::ContourUncertainEnsemble2D contour;
     contour.SetEnsembleField("ensemble_array");
+    contour.SetMeanField("ensemble_array" + statistics.GetMeanSuffix());
     contour.SetIsoValue(iso);
     vtkmDataSet = contour.Execute(vtkmDataSet);
 
+  }
+  else if (datatype == "pca")
+  {
+    // keep the mean and a few principal components of the members instead of the members
+    vtkm::filter::uncertainty::EnsemblePCA pca;
+    pca.SetEnsembleField("ensemble_array");
+    char const *rankEnv = getenv("UCV_PCA_RANK");
+    if (rankEnv != nullptr)
+    {
+      pca.SetRank(std::stoi(rankEnv));
+    }
+    vtkmDataSet = pca.Execute(vtkmDataSet);
+    std::cout << "explained variance: " << pca.GetExplainedVariance() << std::endl;
+
+    vtkm::filter::uncertainty::ContourUncertainEnsembleLowRank contour;
+    contour.SetMeanField("ensemble_array" + pca.GetMeanSuffix());
+    contour.SetCoefficientsField("ensemble_array" + pca.GetCoefficientsSuffix());
+    contour.SetResidualField("ensemble_array" + pca.GetResidualSuffix());
+    contour.SetIsoValue(iso);
+    contour.SetNumberOfSamples(numSamples);
+    vtkmDataSet = contour.Execute(vtkmDataSet);
   }else{
     // executing the uncertianty thing
     using WorkletType = MVGaussianWithEnsemble2DTryLialgEntropy;
@@ -150,7 +135,8 @@ int main(int argc, char *argv[])
 
   vtkm::cont::SetLogLevelName(vtkm::cont::LogLevel::Perf , "custom");
 
-  vtkm::cont::Initialize(argc, argv);
+  vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+  runtime.PrintSummary(std::cout);
   
   if (argc != 3)
   {
@@ -159,8 +145,7 @@ int main(int argc, char *argv[])
   }
 
 
-  vtkm::cont::Timer timer;
-  initBackend(timer);
+  vtkm::cont::Timer timer{ runtime.GetDevice() };
   std::cout << "timer device: " << timer.GetDevice().GetName() << std::endl;
 
   vtkm::Id xdim = 500;
@@ -235,6 +220,9 @@ int main(int argc, char *argv[])
   
   callWorklet(timer, vtkmDataSet, isovalue, num_samples, "stru");
   std::cout << "ok for struc 2" << std::endl;
+
+  callWorklet(timer, vtkmDataSet, isovalue, num_samples, "pca");
+  std::cout << "ok for pca" << std::endl;
   
   // test unstructred grid
   // convert the original data to the unstructured grid
@@ -12,6 +12,7 @@
 
 #include "ucvworklet/CreateNewKey.hpp"
 #include "ucvworklet/MVGaussianWithEnsemble3DTryLialg2.hpp"
+#include "UncertaintyRuntime.h"
 
 #include <vtkm/cont/Timer.h>
 
@@ -24,53 +25,6 @@
 
 using SupportedTypesVec = vtkm::List<vtkm::Vec<double, 20>>;
 
-std::string backend = "openmp";
-
-void initBackend(vtkm::cont::Timer &timer)
-{
-  // init the vtkh device
-  char const *tmp = getenv("UCV_VTKM_BACKEND");
-
-  if (tmp == nullptr)
-  {
-    std::cout << "no UCV_VTKM_BACKEND env, use openmp" << std::endl;
-    backend = "openmp";
-  }
-  else
-  {
-    backend = std::string(tmp);
-  }
-
-  // if (rank == 0)
-  //{
-  std::cout << "vtkm backend is:" << backend << std::endl;
-  //}
-
-  if (backend == "serial")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagSerial());
-    timer.Reset(vtkm::cont::DeviceAdapterTagSerial());
-  }
-  else if (backend == "openmp")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagOpenMP());
-    timer.Reset(vtkm::cont::DeviceAdapterTagOpenMP());
-  }
-  else if (backend == "cuda")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagCuda());
-    timer.Reset(vtkm::cont::DeviceAdapterTagCuda());
-  }
-  else
-  {
-    std::cerr << " unrecognized backend " << backend << std::endl;
-  }
-  return;
-}
-
 void callWorklet(vtkm::cont::Timer &timer, vtkm::cont::DataSet vtkmDataSet, double iso, int numSamples, std::string datatype)
 {
   timer.Start();
@@ -134,7 +88,8 @@ void callWorklet(vtkm::cont::Timer &timer, vtkm::cont::DataSet vtkmDataSet, doub
 
 int main(int argc, char *argv[])
 {
-  vtkm::cont::Initialize(argc, argv);
+  vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+  runtime.PrintSummary(std::cout);
 
   if (argc != 3)
   {
@@ -142,8 +97,7 @@ int main(int argc, char *argv[])
     exit(0);
   }
 
-  vtkm::cont::Timer timer;
-  initBackend(timer);
+  vtkm::cont::Timer timer{ runtime.GetDevice() };
   std::cout << "timer device: " << timer.GetDevice().GetName() << std::endl;
 
   vtkm::Id numSlices = 10;
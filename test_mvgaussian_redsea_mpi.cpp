@@ -6,6 +6,8 @@
 #include <vtkm/worklet/DispatcherMapTopology.h>
 #include <vtkm/cont/ArrayHandleSOA.h>
 #include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/Initialize.h>
 #include <vtkm/filter/clean_grid/CleanGrid.h>
 #include <vtkm/filter/geometry_refinement/Triangulate.h>
@@ -13,7 +15,11 @@
 #include "ucvworklet/CreateNewKey.hpp"
 #include "ucvworklet/MVGaussianWithEnsemble2DTryLialgEntropy.hpp"
 #include "ucvworklet/MVGaussianWithEnsemble2DPolyTryLialgEntropy.hpp"
+#include "ucvworklet/UncertainPointCost.hpp"
+#include "UncertaintyRuntime.h"
 
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/Invoker.h>
 #include <vtkm/cont/Timer.h>
 
 #include <mpi.h>
@@ -24,57 +30,20 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 using SupportedTypesVec = vtkm::List<vtkm::Vec<double, 20>>;
 
-std::string backend = "openmp";
-
-void initBackend(vtkm::cont::Timer &timer)
-{
-  // init the vtkh device
-  char const *tmp = getenv("UCV_VTKM_BACKEND");
-
-  if (tmp == nullptr)
-  {
-    std::cout << "no UCV_VTKM_BACKEND env, use openmp" << std::endl;
-    backend = "openmp";
-  }
-  else
-  {
-    backend = std::string(tmp);
-  }
-
-  // if (rank == 0)
-  //{
-  std::cout << "vtkm backend is:" << backend << std::endl;
-  //}
-
-  if (backend == "serial")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagSerial());
-    timer.Reset(vtkm::cont::DeviceAdapterTagSerial());
-  }
-  else if (backend == "openmp")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagOpenMP());
-    timer.Reset(vtkm::cont::DeviceAdapterTagOpenMP());
-  }
-  else if (backend == "cuda")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagCuda());
-    timer.Reset(vtkm::cont::DeviceAdapterTagCuda());
-  }
-  else
-  {
-    std::cerr << " unrecognized backend " << backend << std::endl;
-  }
-  return;
-}
-
-void callWorklet(vtkm::cont::DataSet vtkmDataSet, double iso, int numSamples, std::string datatype)
+// the results are added to a shallow copy of the input data set
+// so they can be written out after the worklet finishes
+vtkm::cont::DataSet callWorklet(vtkm::cont::DataSet vtkmDataSet, double iso, int numSamples, std::string datatype)
 {
 
   vtkm::cont::ArrayHandle<vtkm::Float64> crossProbability;
@@ -85,6 +54,7 @@ void callWorklet(vtkm::cont::DataSet vtkmDataSet, double iso, int numSamples, st
   {
 
     std::cout << "only support structured case" << std::endl;
+    return vtkmDataSet;
   }
   else
   {
@@ -100,35 +70,91 @@ void callWorklet(vtkm::cont::DataSet vtkmDataSet, double iso, int numSamples, st
     vtkmDataSet.GetField("ensembles").GetData().CastAndCallForTypes<SupportedTypesVec, VTKM_DEFAULT_STORAGE_LIST>(resolveType);
   }
 
-  /*
-  // do not output the data for the parallel case
-  // output is ms
-  std::cout << "execution time: " << timer.GetElapsedTime() * 1000 << std::endl;
+  // we use a shallow copy as the data set for the output
+  vtkm::cont::DataSet outputDataSet;
+  outputDataSet.SetCellSet(vtkmDataSet.GetCellSet());
+  outputDataSet.AddCoordinateSystem(vtkmDataSet.GetCoordinateSystem());
+  outputDataSet.AddCellField("cross_prob", crossProbability);
+  outputDataSet.AddCellField("num_nonzero_prob", numNonZeroProb);
+  outputDataSet.AddCellField("entropy", entropy);
+  return outputDataSet;
+}
 
-  std::stringstream stream;
-  stream << std::fixed << std::setprecision(2) << iso;
-  std::string isostr = stream.str();
+// a blocking queue with a fixed capacity, this is used to connect the loader,
+// the compute and the writer stages, the capacity bounds the number of slices
+// that are in memory at the same time
+template <typename T>
+class BoundedQueue
+{
+public:
+  BoundedQueue(std::size_t capacity) : m_capacity(capacity){};
+
+  // block if the queue is full, return false if the queue is closed
+  bool push(T item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [&]()
+                   { return m_items.size() < m_capacity || m_closed; });
+    if (m_closed)
+    {
+      return false;
+    }
+    m_items.push_back(std::move(item));
+    m_notEmpty.notify_one();
+    return true;
+  }
+
+  // block if the queue is empty, return false if it is closed and drained
+  bool pop(T &item)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait(lock, [&]()
+                    { return !m_items.empty() || m_closed; });
+    if (m_items.empty())
+    {
+      return false;
+    }
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    m_notFull.notify_one();
+    return true;
+  }
 
-  // check results
-  // we use a shallow copy as the data set for
-  auto outputDataSet = vtkmDataSet;
-  outputDataSet.AddCellField("cross_prob_" + isostr, crossProbability);
+  // the producer calls this after the last push
+  void close()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+  }
 
-  std::string outputFileName = "./red_sea_ucv_iso_" + datatype + "_" + isostr + ".vtk";
-  vtkm::io::VTKDataSetWriter writeCross(outputFileName);
-  writeCross.WriteDataSet(outputDataSet);
-  */
-}
+private:
+  std::size_t m_capacity;
+  std::deque<T> m_items;
+  bool m_closed = false;
+  std::mutex m_mutex;
+  std::condition_variable m_notEmpty;
+  std::condition_variable m_notFull;
+};
 
-vtkm::cont::DataSet loadData(int sliceId)
+struct SliceItem
+{
+  int sliceId = -1;
+  vtkm::cont::DataSet dataSet;
+};
+
+// load the first NumEnsembles members of one slice into the "ensembles" field
+template <int NumEnsembles>
+vtkm::cont::DataSet loadMembers(int sliceId)
 {
   std::string dataDir = "./red_sea_vtkdata_velocityMagnitude/";
-  const int numEnsembles = 20;
+  const int numEnsembles = NumEnsembles;
   vtkm::Id xdim = 500;
   vtkm::Id ydim = 500;
   vtkm::Id zdim = 1;
-  using Vec20 = vtkm::Vec<double, numEnsembles>;
-  vtkm::cont::ArrayHandle<Vec20> dataArraySOA;
+  using VecType = vtkm::Vec<double, numEnsembles>;
+  vtkm::cont::ArrayHandle<VecType> dataArraySOA;
   dataArraySOA.Allocate(xdim * ydim);
   std::vector<vtkm::cont::ArrayHandle<vtkm::Float64>> dataArray;
   for (int ensId = 1; ensId <= numEnsembles; ensId++)
@@ -147,20 +173,28 @@ vtkm::cont::DataSet loadData(int sliceId)
   }
 
   // do through the data array and put them into the dataArraySOA
+  // get the portals once, creating a portal for each value is expensive
+  // when the loader runs in parallel with the worklets
+  std::vector<vtkm::cont::ArrayHandle<vtkm::Float64>::ReadPortalType> memberPortals;
+  for (int ensId = 1; ensId <= numEnsembles; ensId++)
+  {
+    memberPortals.push_back(dataArray[ensId - 1].ReadPortal());
+  }
+  auto ensemblePortal = dataArraySOA.WritePortal();
   for (int j = 0; j < ydim; j++)
   {
     for (int i = 0; i < xdim; i++)
     {
       int index = j * ydim + i;
 
-      // each entry has 20 ensembles
-      Vec20 ensembles;
+      // each entry has numEnsembles members
+      VecType ensembles;
       for (int ensId = 1; ensId <= numEnsembles; ensId++)
       {
-        ensembles[ensId - 1] = dataArray[ensId - 1].ReadPortal().Get(index);
+        ensembles[ensId - 1] = memberPortals[ensId - 1].Get(index);
       }
 
-      dataArraySOA.WritePortal().Set(index, ensembles);
+      ensemblePortal.Set(index, ensembles);
     }
   }
 
@@ -171,10 +205,161 @@ vtkm::cont::DataSet loadData(int sliceId)
   return vtkmDataSet;
 }
 
+vtkm::cont::DataSet loadData(int sliceId)
+{
+  return loadMembers<20>(sliceId);
+}
+
+// the lpt estimation only reads the first few members of each slice
+// and looks at every LptPointStride point, the cost only needs to rank
+// the slices, not to predict the run time exactly
+constexpr int LptNumMembers = 5;
+constexpr vtkm::Id LptPointStride = 4;
+
+vtkm::cont::DataSet loadEstimationData(int sliceId)
+{
+  return loadMembers<LptNumMembers>(sliceId);
+}
+
+// map the slice id used for the performance test back to the slice on disk
+// there are 50 slices in total, for the convenience of performance test
+// we use the 128 instead, for the number >=50 slices in total
+// load the existance data again
+int getActualSliceId(int sliceId, int actualTotal)
+{
+  int actualSliceId = sliceId;
+  if (actualSliceId >= 2 * actualTotal)
+  {
+    actualSliceId = actualSliceId - 2 * actualTotal;
+  }
+
+  if (actualSliceId >= actualTotal)
+  {
+    actualSliceId = actualSliceId - actualTotal;
+  }
+  return actualSliceId;
+}
+
+// estimate the cost of running the uncertainty worklet on one slice
+// this only needs one pass over the points and is much cheaper than the sampling
+// only every pointStride point is visited
+double estimateSliceCost(vtkm::cont::DataSet vtkmDataSet, double iso, double numStdev, double uncertainWeight, vtkm::Id pointStride)
+{
+  using EstimationTypesVec = vtkm::List<vtkm::Vec<double, LptNumMembers>, vtkm::Vec<double, 20>>;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> pointCost;
+  auto resolveType = [&](const auto &concrete)
+  {
+    vtkm::Id numSamples = (concrete.GetNumberOfValues() + pointStride - 1) / pointStride;
+    auto sampledIds = vtkm::cont::make_ArrayHandleCounting<vtkm::Id>(0, pointStride, numSamples);
+    vtkm::cont::Invoker invoke;
+    invoke(UncertainPointCost{iso, numStdev, uncertainWeight}, vtkm::cont::make_ArrayHandlePermutation(sampledIds, concrete), pointCost);
+  };
+  vtkmDataSet.GetField("ensembles").GetData().CastAndCallForTypes<EstimationTypesVec, VTKM_DEFAULT_STORAGE_LIST>(resolveType);
+
+  vtkm::FloatDefault totalCost = vtkm::cont::Algorithm::Reduce(pointCost, vtkm::FloatDefault(0));
+  // use the fraction of the points so the value does not depend on the slice size
+  return static_cast<double>(totalCost) / static_cast<double>(pointCost.GetNumberOfValues());
+}
+
+// longest processing time first, the most expensive slice is assigned to the rank
+// with the smallest load each time, ties are broken by the slice id and the rank id
+// so every rank computes the same assignment
+std::vector<int> assignSlicesLPT(const std::vector<double> &sliceCost, int numProcesses)
+{
+  std::vector<int> order(sliceCost.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+                   { return sliceCost[a] > sliceCost[b]; });
+
+  using LoadEntry = std::pair<double, int>;
+  std::priority_queue<LoadEntry, std::vector<LoadEntry>, std::greater<LoadEntry>> rankLoad;
+  for (int r = 0; r < numProcesses; r++)
+  {
+    rankLoad.push(LoadEntry(0.0, r));
+  }
+
+  std::vector<int> owner(sliceCost.size(), 0);
+  for (int sliceId : order)
+  {
+    LoadEntry entry = rankLoad.top();
+    rankLoad.pop();
+    owner[sliceId] = entry.second;
+    entry.first = entry.first + sliceCost[sliceId];
+    rankLoad.push(entry);
+  }
+  return owner;
+}
+
+const int TAG_REQUEST_SLICE = 1;
+const int TAG_ASSIGN_SLICE = 2;
+
+// rank 0 works as the master and hands out the slice ids one by one
+// the worker ask for a new slice once it finishes the previous one, so
+// the ranks that get the expensive slices just process fewer of them
+void masterDispatchSlices(int totalSlice, int numProcesses)
+{
+  int nextSlice = 0;
+  int numFinishedWorkers = 0;
+  while (numFinishedWorkers < numProcesses - 1)
+  {
+    int request = 0;
+    MPI_Status status;
+    MPI_Recv(&request, 1, MPI_INT, MPI_ANY_SOURCE, TAG_REQUEST_SLICE, MPI_COMM_WORLD, &status);
+
+    int assigned = -1;
+    if (nextSlice < totalSlice)
+    {
+      assigned = nextSlice;
+      nextSlice++;
+    }
+    else
+    {
+      numFinishedWorkers++;
+    }
+    MPI_Send(&assigned, 1, MPI_INT, status.MPI_SOURCE, TAG_ASSIGN_SLICE, MPI_COMM_WORLD);
+  }
+}
+
+int workerRequestSlice()
+{
+  int request = 0;
+  int assigned = -1;
+  MPI_Send(&request, 1, MPI_INT, 0, TAG_REQUEST_SLICE, MPI_COMM_WORLD);
+  MPI_Recv(&assigned, 1, MPI_INT, 0, TAG_ASSIGN_SLICE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  return assigned;
+}
+
+// write the results to the disk, this runs on its own thread so the
+// compute stage does not wait for the file system
+void writeResults(BoundedQueue<SliceItem> &resultQueue, const std::string &outputDir, double iso)
+{
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(2) << iso;
+  std::string isostr = stream.str();
+
+  SliceItem item;
+  while (resultQueue.pop(item))
+  {
+    if (outputDir.empty())
+    {
+      // results are dropped when there is no output dir
+      continue;
+    }
+    std::string outputFileName = outputDir + "/red_sea_ucv_slice_" + std::to_string(item.sliceId) + "_iso_" + isostr + ".vtk";
+    vtkm::io::VTKDataSetWriter writeCross(outputFileName);
+    writeCross.SetFileTypeToBinary();
+    writeCross.WriteDataSet(item.dataSet);
+  }
+}
+
 int main(int argc, char *argv[])
 {
   // compute the number of slices processed by this rank
-  int rc = MPI_Init(&argc, &argv);
+  // the loader thread asks the master for new slices in the dynamic schedule
+  // while the main thread is running the worklets, so MPI calls can come from
+  // different threads (but never at the same time)
+  int provided = MPI_THREAD_SINGLE;
+  int rc = MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
   int rank;
   int numProcesses;
   if (rc != MPI_SUCCESS)
@@ -185,67 +370,217 @@ int main(int argc, char *argv[])
   MPI_Comm_size(MPI_COMM_WORLD, &numProcesses);
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-  if (argc != 3)
+  if (argc < 3 || argc > 5)
   {
     if (rank == 0)
     {
-      std::cout << "<executable> <iso> <num of sample>" << std::endl;
-      exit(0);
+      std::cout << "<executable> <iso> <num of sample> [schedule: static|lpt|dynamic] [num of stdev for cost]" << std::endl;
+      std::cout << "env UCV_PIPELINE_DEPTH sets the number of slices buffered between the loading, computing and writing stages (default 2)" << std::endl;
+      std::cout << "env UCV_OUTPUT_DIR sets the dir to write the results, nothing is written if it is not set" << std::endl;
     }
+    MPI_Finalize();
+    exit(0);
   }
 
   double isovalue = std::stod(argv[1]);
   int num_samples = std::stoi(argv[2]);
+  std::string schedule = "static";
+  if (argc >= 4)
+  {
+    schedule = std::string(argv[3]);
+  }
+  double numStdev = 2.0;
+  if (argc >= 5)
+  {
+    numStdev = std::stod(argv[4]);
+  }
+  // the points close to the isovalue are the ones that have more nonzero cases
+  // and are more expensive for the adaptive sampling, this weight is only used for the estimation
+  double uncertainWeight = 1.0;
+
+  std::size_t pipelineDepth = 2;
+  char const *depthEnv = getenv("UCV_PIPELINE_DEPTH");
+  if (depthEnv != nullptr)
+  {
+    pipelineDepth = std::max(1, std::stoi(std::string(depthEnv)));
+  }
+  std::string outputDir;
+  char const *outputEnv = getenv("UCV_OUTPUT_DIR");
+  if (outputEnv != nullptr)
+  {
+    outputDir = std::string(outputEnv);
+  }
+
   if (rank == 0)
   {
-    std::cout << "iso value is: " << isovalue << " num_samples is: " << num_samples << std::endl;
+    std::cout << "iso value is: " << isovalue << " num_samples is: " << num_samples << " schedule is: " << schedule
+              << " pipeline depth is: " << pipelineDepth << std::endl;
   }
 
-  vtkm::cont::Initialize(argc, argv);
-  vtkm::cont::Timer timer;
-  initBackend(timer);
+  if (schedule != "static" && schedule != "lpt" && schedule != "dynamic")
+  {
+    if (rank == 0)
+    {
+      std::cout << "unsupported schedule " << schedule << ", use static, lpt or dynamic" << std::endl;
+    }
+    MPI_Finalize();
+    exit(0);
+  }
+
+  if (provided < MPI_THREAD_SERIALIZED && schedule == "dynamic")
+  {
+    if (rank == 0)
+    {
+      std::cout << "the dynamic schedule requires MPI_THREAD_SERIALIZED" << std::endl;
+    }
+    MPI_Finalize();
+    exit(0);
+  }
+
+  vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+  runtime.PrintSummary(std::cout);
+  vtkm::cont::Timer timer{ runtime.GetDevice() };
   std::cout << "timer device: " << timer.GetDevice().GetName() << std::endl;
 
   int totalSlice = 128;
   int actualTotal = 50;
-  // there are 50 slices in total
-  // for the convenience of performance test
-  // use the 128 instead, for the number >=50 slices in total
-  // load the existance data again
   if (numProcesses > totalSlice)
   {
-    std::cout << "only works when the num of proces < 64" << std::endl;
+    std::cout << "only works when the num of proces <= " << totalSlice << std::endl;
     exit(0);
   }
 
-  std::vector<vtkm::cont::DataSet> dsList;
-  for (int sliceId = 0; sliceId < totalSlice; sliceId++)
+  // the slices processed by current rank, this is empty for the dynamic schedule
+  // where the slices are asked from the master one by one
+  std::vector<int> rankSlices;
+  // the time spent on estimating the slice cost for the lpt schedule
+  double estimationTime = 0;
+  if (schedule == "static" || numProcesses == 1)
   {
-    if (sliceId % numProcesses == rank)
+    for (int sliceId = 0; sliceId < totalSlice; sliceId++)
     {
-      int actualSliceId = sliceId;
-      if(actualSliceId>=2*actualTotal){
-        actualSliceId = actualSliceId - 2*actualTotal;
+      if (sliceId % numProcesses == rank)
+      {
+        rankSlices.push_back(sliceId);
       }
-
-      if(actualSliceId>=actualTotal){
-        actualSliceId = actualSliceId - actualTotal;
+    }
+  }
+  else if (schedule == "lpt")
+  {
+    // every rank estimates the cost of the round robin slices on disk
+    // and then all ranks agree on the same assignment
+    // the repeated slices share the cost of the slice they are mapped to,
+    // so each slice on disk is only estimated once, from a subsample of its members and points
+    // the estimation is not covered by the pipeline timer, it is timed and reported separately
+    vtkm::cont::Timer estimateTimer{ runtime.GetDevice() };
+    MPI_Barrier(MPI_COMM_WORLD);
+    estimateTimer.Start();
+    std::vector<double> localCost(actualTotal, 0.0);
+    for (int actualSliceId = 0; actualSliceId < actualTotal; actualSliceId++)
+    {
+      if (actualSliceId % numProcesses == rank)
+      {
+        vtkm::cont::DataSet ds = loadEstimationData(actualSliceId);
+        localCost[actualSliceId] = estimateSliceCost(ds, isovalue, numStdev, uncertainWeight, LptPointStride);
       }
+    }
+    std::vector<double> actualCost(actualTotal, 0.0);
+    MPI_Allreduce(localCost.data(), actualCost.data(), actualTotal, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    std::vector<double> sliceCost(totalSlice, 0.0);
+    for (int sliceId = 0; sliceId < totalSlice; sliceId++)
+    {
+      sliceCost[sliceId] = actualCost[getActualSliceId(sliceId, actualTotal)];
+    }
+    estimateTimer.Stop();
+    estimationTime = estimateTimer.GetElapsedTime();
 
-      // current rank load the ith slice
-      std::cout << "rank " << rank << " load slice " << actualSliceId << " currid " << sliceId << std::endl;
-      vtkm::cont::DataSet ds = loadData(actualSliceId);
-      dsList.push_back(ds);
+    std::vector<int> owner = assignSlicesLPT(sliceCost, numProcesses);
+    double estimatedLoad = 0;
+    for (int sliceId = 0; sliceId < totalSlice; sliceId++)
+    {
+      if (owner[sliceId] == rank)
+      {
+        rankSlices.push_back(sliceId);
+        estimatedLoad += sliceCost[sliceId];
+      }
     }
+    std::cout << "rank " << rank << " num of slices " << rankSlices.size() << " estimated load " << estimatedLoad << std::endl;
   }
 
-  // do the processing for each member in the list
-  // time it
+  bool isMaster = (schedule == "dynamic" && numProcesses > 1 && rank == 0);
+
+  // the time spent on the uncertainty worklet by this rank
+  double localComputeTime = 0;
+
+  // the loading and the writing overlap with the computation
+  // so the timer covers the whole pipeline
+  MPI_Barrier(MPI_COMM_WORLD);
   timer.Start();
 
-  for (std::size_t i = 0; i < dsList.size(); i++)
+  if (isMaster)
   {
-    callWorklet(dsList[i], isovalue, num_samples, "stru");
+    masterDispatchSlices(totalSlice, numProcesses);
+  }
+  else
+  {
+    BoundedQueue<SliceItem> loadQueue(pipelineDepth);
+    BoundedQueue<SliceItem> resultQueue(pipelineDepth);
+
+    // the loader prefetches the next slices while the device computes current one
+    std::thread loader([&]()
+                       {
+      auto loadSlice = [&](int sliceId)
+      {
+        int actualSliceId = getActualSliceId(sliceId, actualTotal);
+        std::cout << "rank " << rank << " load slice " << actualSliceId << " currid " << sliceId << std::endl;
+        SliceItem item;
+        item.sliceId = sliceId;
+        item.dataSet = loadData(actualSliceId);
+        return loadQueue.push(std::move(item));
+      };
+
+      if (schedule == "dynamic" && numProcesses > 1)
+      {
+        int sliceId = workerRequestSlice();
+        while (sliceId >= 0 && loadSlice(sliceId))
+        {
+          sliceId = workerRequestSlice();
+        }
+      }
+      else
+      {
+        for (int sliceId : rankSlices)
+        {
+          if (!loadSlice(sliceId))
+          {
+            break;
+          }
+        }
+      }
+      loadQueue.close(); });
+
+    std::thread writer([&]()
+                       { writeResults(resultQueue, outputDir, isovalue); });
+
+    vtkm::cont::Timer computeTimer(timer.GetDevice());
+    SliceItem item;
+    while (loadQueue.pop(item))
+    {
+      computeTimer.Start();
+      SliceItem result;
+      result.sliceId = item.sliceId;
+      result.dataSet = callWorklet(item.dataSet, isovalue, num_samples, "stru");
+      computeTimer.Stop();
+      localComputeTime += computeTimer.GetElapsedTime();
+
+      // release the input before waiting for the writer
+      item = SliceItem{};
+      resultQueue.push(std::move(result));
+    }
+    resultQueue.close();
+
+    loader.join();
+    writer.join();
   }
 
   //maybe add more operations here
@@ -256,9 +591,30 @@ int main(int argc, char *argv[])
   MPI_Barrier(MPI_COMM_WORLD);
   timer.Stop();
 
+  // the imbalance is the ratio between the slowest rank and the average
+  double maxComputeTime = 0;
+  double sumComputeTime = 0;
+  MPI_Reduce(&localComputeTime, &maxComputeTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&localComputeTime, &sumComputeTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  double maxEstimationTime = 0;
+  MPI_Reduce(&estimationTime, &maxEstimationTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
   if (rank == 0)
   {
     std::cout << "execution time for rank 0: " << timer.GetElapsedTime() * 1000 << std::endl;
+    if (schedule == "lpt" && numProcesses > 1)
+    {
+      std::cout << "lpt estimation time: " << maxEstimationTime * 1000
+                << " total with estimation: " << (timer.GetElapsedTime() + maxEstimationTime) * 1000 << std::endl;
+    }
+    int numComputeRanks = isMaster ? numProcesses - 1 : numProcesses;
+    double avgComputeTime = sumComputeTime / numComputeRanks;
+    std::cout << "compute time max: " << maxComputeTime * 1000 << " avg: " << avgComputeTime * 1000;
+    if (avgComputeTime > 0)
+    {
+      std::cout << " imbalance: " << maxComputeTime / avgComputeTime;
+    }
+    std::cout << std::endl;
   }
 
   MPI_Finalize();
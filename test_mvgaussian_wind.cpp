@@ -9,6 +9,7 @@
 #include "ucvworklet/CreateNewKey.hpp"
 //#include "ucvworklet/MVGaussianWithEnsemble2D.hpp"
 #include "ucvworklet/MVGaussianWithEnsemble2DTryLialg.hpp"
+#include "UncertaintyRuntime.h"
 
 #include <vtkm/cont/Timer.h>
 
@@ -35,52 +36,6 @@ void exampleDataSet(int pointNum, std::vector<std::vector<double>> &data)
   }
 }
 
-std::string backend = "openmp";
-
-void initBackend(vtkm::cont::Timer &timer)
-{
-  // init the vtkh device
-  char const *tmp = getenv("UCV_VTKM_BACKEND");
-
-  if (tmp == nullptr)
-  {
-    std::cout << "no UCV_VTKM_BACKEND env, use openmp" << std::endl;
-    backend = "openmp";
-  }
-  else
-  {
-    backend = std::string(tmp);
-  }
-
-  // if (rank == 0)
-  //{
-  std::cout << "vtkm backend is:" << backend << std::endl;
-  //}
-
-  if (backend == "serial")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagSerial());
-    timer.Reset(vtkm::cont::DeviceAdapterTagSerial());
-  }
-  else if (backend == "openmp")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagOpenMP());
-    timer.Reset(vtkm::cont::DeviceAdapterTagOpenMP());
-  }
-  else if (backend == "cuda")
-  {
-    vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-    device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagCuda());
-    timer.Reset(vtkm::cont::DeviceAdapterTagCuda());
-  }
-  else
-  {
-    std::cerr << " unrecognized backend " << backend << std::endl;
-  }
-  return;
-}
 int main(int argc, char *argv[])
 {
 
@@ -89,9 +44,9 @@ int main(int argc, char *argv[])
     exit(0);
   } 
 
-  vtkm::cont::Initialize(argc, argv);
-  vtkm::cont::Timer timer;
-  initBackend(timer);
+  vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+  runtime.PrintSummary(std::cout);
+  vtkm::cont::Timer timer{ runtime.GetDevice() };
   std::cout << "timer device: "<< timer.GetDevice().GetName()<< std::endl;
 
 
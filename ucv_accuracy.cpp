@@ -0,0 +1,496 @@
+#include <vtkm/cont/Initialize.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/Timer.h>
+
+#include "ucvworklet/EntropyIndependentGaussian.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DFactorize.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DSampling.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DTryLialg.hpp"
+#include "UncertaintyRuntime.h"
+#include "ucv_command_line.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// accuracy regression harness for the multivariant gaussian worklets
+// it sweeps the sample count, the sampler and the precision of the input fields,
+// measures the error of the cross probability and the entropy against a reference
+// and writes one csv row per configuration together with the time, the rows on the
+// error vs time pareto front are marked so that a speed optimisation of the sampling
+// path can be checked against the accuracy it gives away
+//
+// reference=closed: the ensemble of each point is built from the columns of a 64x64
+// Walsh-Hadamard matrix, so the sample covariance of each cell is exactly diagonal and
+// the multivariant gaussian must match the closed form of the independent gaussian
+// reference=sampled: the ensemble members share a random component (correlated points)
+// and the reference is the sampler in double precision with many samples, drawn from
+// its own seed so its random sequence is independent of the runs it is compared with
+
+constexpr vtkm::IdComponent ENSEMBLE_SIZE = 64;
+
+struct AccuracyOptions
+{
+    vtkm::Id3 dims{16, 16, 16};
+    std::vector<int> samples{10, 100, 1000, 10000};
+    std::vector<std::string> samplers{"fused", "cached"};
+    std::vector<std::string> precisions{"float32", "float64"};
+    std::string reference = "closed";
+    int referenceSamples = 100000;
+    unsigned int referenceSeed = 12345;
+    double isovalue = 0.0;
+    int repetitions = 3;
+    unsigned int seed = 0;
+    std::string output;
+};
+
+struct AccuracyResult
+{
+    std::string sampler;
+    std::string precision;
+    int samples;
+    double setupTime;
+    double time;
+    double meanAbsError;
+    double rmsError;
+    double maxAbsError;
+    double entropyMeanAbsError;
+    bool pareto;
+};
+
+AccuracyOptions options;
+std::vector<AccuracyResult> results;
+
+// the values of each point before they are converted to the precision of the run
+struct PointEnsemble
+{
+    std::vector<double> mean;
+    std::vector<double> stdev;
+    std::vector<double> members;
+};
+
+// entry (row, col) of the Sylvester construction of the Walsh-Hadamard matrix
+// the columns other than 0 sum to zero and are orthogonal to each other
+double hadamard(int row, int col)
+{
+    int bits = row & col;
+    int parity = 0;
+    while (bits != 0)
+    {
+        parity ^= (bits & 1);
+        bits >>= 1;
+    }
+    return parity ? -1.0 : 1.0;
+}
+
+PointEnsemble generateEnsemble(const vtkm::Id3 &dims)
+{
+    vtkm::Id numPoints = dims[0] * dims[1] * dims[2];
+    std::mt19937 rng(options.seed);
+    std::normal_distribution<double> norm(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(0.1, 0.5);
+
+    PointEnsemble ensemble;
+    ensemble.mean.resize(numPoints);
+    ensemble.stdev.resize(numPoints);
+    ensemble.members.resize(numPoints * ENSEMBLE_SIZE);
+
+    // shared component of each member, only used for the correlated ensemble
+    std::vector<double> shared(ENSEMBLE_SIZE);
+    for (auto &value : shared)
+    {
+        value = norm(rng);
+    }
+
+    vtkm::Id index = 0;
+    for (vtkm::Id z = 0; z < dims[2]; z++)
+    {
+        for (vtkm::Id y = 0; y < dims[1]; y++)
+        {
+            for (vtkm::Id x = 0; x < dims[0]; x++)
+            {
+                // the mean is close to the isovalue so most cells have a nonzero probability
+                double mean = options.isovalue + 0.3 * norm(rng);
+                double stdev = uniform(rng);
+                ensemble.mean[index] = mean;
+                ensemble.stdev[index] = stdev;
+
+                double *members = &ensemble.members[index * ENSEMBLE_SIZE];
+                if (options.reference == "closed")
+                {
+                    // the 8 vertices of a cell have different parities, so they get different columns
+                    int col = 1 + static_cast<int>((x % 2) + 2 * (y % 2) + 4 * (z % 2));
+                    // the sample variance is divided by (n-1)
+                    double scale = stdev * std::sqrt((ENSEMBLE_SIZE - 1.0) / ENSEMBLE_SIZE);
+                    for (int m = 0; m < ENSEMBLE_SIZE; m++)
+                    {
+                        members[m] = mean + scale * hadamard(m, col);
+                    }
+                }
+                else
+                {
+                    double sum = 0;
+                    for (int m = 0; m < ENSEMBLE_SIZE; m++)
+                    {
+                        members[m] = mean + stdev * (0.7 * shared[m] + 0.3 * norm(rng));
+                        sum += members[m];
+                    }
+                    ensemble.mean[index] = sum / ENSEMBLE_SIZE;
+                }
+                index++;
+            }
+        }
+    }
+    return ensemble;
+}
+
+template <typename ValueType>
+void convertEnsemble(const PointEnsemble &ensemble,
+                     vtkm::cont::ArrayHandle<vtkm::Vec<ValueType, ENSEMBLE_SIZE>> &members,
+                     vtkm::cont::ArrayHandle<ValueType> &mean)
+{
+    vtkm::Id numPoints = static_cast<vtkm::Id>(ensemble.mean.size());
+    members.Allocate(numPoints);
+    mean.Allocate(numPoints);
+    auto membersPortal = members.WritePortal();
+    auto meanPortal = mean.WritePortal();
+    for (vtkm::Id i = 0; i < numPoints; i++)
+    {
+        vtkm::Vec<ValueType, ENSEMBLE_SIZE> value;
+        for (int m = 0; m < ENSEMBLE_SIZE; m++)
+        {
+            value[m] = static_cast<ValueType>(ensemble.members[i * ENSEMBLE_SIZE + m]);
+        }
+        membersPortal.Set(i, value);
+        meanPortal.Set(i, static_cast<ValueType>(ensemble.mean[i]));
+    }
+}
+
+struct ReferenceValues
+{
+    std::vector<double> crossProb;
+    std::vector<double> entropy;
+};
+
+ReferenceValues computeReference(const vtkm::cont::CellSetStructured<3> &cellSet,
+                                 const PointEnsemble &ensemble)
+{
+    vtkm::cont::Invoker invoke;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> crossProb;
+    vtkm::cont::ArrayHandle<vtkm::Id> numNonzeroProb;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> entropy;
+
+    if (options.reference == "closed")
+    {
+        vtkm::cont::ArrayHandle<vtkm::FloatDefault> mean;
+        vtkm::cont::ArrayHandle<vtkm::FloatDefault> stdev;
+        mean.Allocate(static_cast<vtkm::Id>(ensemble.mean.size()));
+        stdev.Allocate(static_cast<vtkm::Id>(ensemble.mean.size()));
+        auto meanPortal = mean.WritePortal();
+        auto stdevPortal = stdev.WritePortal();
+        for (std::size_t i = 0; i < ensemble.mean.size(); i++)
+        {
+            meanPortal.Set(static_cast<vtkm::Id>(i), static_cast<vtkm::FloatDefault>(ensemble.mean[i]));
+            stdevPortal.Set(static_cast<vtkm::Id>(i), static_cast<vtkm::FloatDefault>(ensemble.stdev[i]));
+        }
+        invoke(EntropyIndependentGaussian{options.isovalue}, cellSet, mean, stdev, crossProb, numNonzeroProb, entropy);
+    }
+    else
+    {
+        // the runs use the default seed, the first samples of a reference with the same
+        // sequence would be the samples of the runs and hide part of their error
+        vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, ENSEMBLE_SIZE>> members;
+        vtkm::cont::ArrayHandle<vtkm::Float64> mean;
+        convertEnsemble(ensemble, members, mean);
+        vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 8>> cellMean;
+        vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 64>> cellFactor;
+        invoke(MVGaussianWithEnsemble3DFactorize{}, cellSet, members, mean, cellMean, cellFactor);
+        invoke(MVGaussianWithEnsemble3DSampling{options.isovalue, options.referenceSamples, options.referenceSeed},
+               cellMean, cellFactor, crossProb, numNonzeroProb, entropy);
+    }
+
+    ReferenceValues reference;
+    auto crossProbPortal = crossProb.ReadPortal();
+    auto entropyPortal = entropy.ReadPortal();
+    for (vtkm::Id i = 0; i < crossProb.GetNumberOfValues(); i++)
+    {
+        reference.crossProb.push_back(crossProbPortal.Get(i));
+        reference.entropy.push_back(entropyPortal.Get(i));
+    }
+    return reference;
+}
+
+void computeError(const ReferenceValues &reference,
+                  const vtkm::cont::ArrayHandle<vtkm::FloatDefault> &crossProb,
+                  const vtkm::cont::ArrayHandle<vtkm::FloatDefault> &entropy,
+                  AccuracyResult &result)
+{
+    auto crossProbPortal = crossProb.ReadPortal();
+    auto entropyPortal = entropy.ReadPortal();
+    double sumAbs = 0;
+    double sumSquare = 0;
+    double maxAbs = 0;
+    double sumEntropyAbs = 0;
+    vtkm::Id numCells = crossProb.GetNumberOfValues();
+    for (vtkm::Id i = 0; i < numCells; i++)
+    {
+        double error = std::abs(crossProbPortal.Get(i) - reference.crossProb[i]);
+        sumAbs += error;
+        sumSquare += error * error;
+        maxAbs = std::max(maxAbs, error);
+        sumEntropyAbs += std::abs(entropyPortal.Get(i) - reference.entropy[i]);
+    }
+    result.meanAbsError = sumAbs / numCells;
+    result.rmsError = std::sqrt(sumSquare / numCells);
+    result.maxAbsError = maxAbs;
+    result.entropyMeanAbsError = sumEntropyAbs / numCells;
+}
+
+template <typename BodyType>
+double meanTime(BodyType &&body)
+{
+    double total = 0;
+    for (int r = 0; r < options.repetitions; r++)
+    {
+        vtkm::cont::Timer timer;
+        timer.Start();
+        body();
+        timer.Stop();
+        total += timer.GetElapsedTime();
+    }
+    return total / options.repetitions;
+}
+
+template <typename ValueType>
+void sweepPrecision(const std::string &precision,
+                    const vtkm::cont::CellSetStructured<3> &cellSet,
+                    const PointEnsemble &ensemble,
+                    const ReferenceValues &reference)
+{
+    vtkm::cont::Invoker invoke;
+    vtkm::cont::ArrayHandle<vtkm::Vec<ValueType, ENSEMBLE_SIZE>> members;
+    vtkm::cont::ArrayHandle<ValueType> mean;
+    convertEnsemble(ensemble, members, mean);
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> crossProb;
+    vtkm::cont::ArrayHandle<vtkm::Id> numNonzeroProb;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> entropy;
+
+    // the factorization of the cached sampler does not depend on the sample count
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 8>> cellMean;
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 64>> cellFactor;
+    double factorizeTime = 0;
+    if (std::find(options.samplers.begin(), options.samplers.end(), "cached") != options.samplers.end())
+    {
+        invoke(MVGaussianWithEnsemble3DFactorize{}, cellSet, members, mean, cellMean, cellFactor);
+        factorizeTime = meanTime([&]()
+                                 { invoke(MVGaussianWithEnsemble3DFactorize{}, cellSet, members, mean, cellMean, cellFactor); });
+    }
+
+    for (const std::string &sampler : options.samplers)
+    {
+        for (int numSamples : options.samples)
+        {
+            AccuracyResult result;
+            result.sampler = sampler;
+            result.precision = precision;
+            result.samples = numSamples;
+            result.pareto = false;
+
+            if (sampler == "fused")
+            {
+                result.setupTime = 0;
+                result.time = meanTime([&]()
+                                       { invoke(MVGaussianWithEnsemble3DTryLialg{options.isovalue, numSamples},
+                                                cellSet, members, mean, crossProb, numNonzeroProb, entropy); });
+            }
+            else
+            {
+                result.setupTime = factorizeTime;
+                result.time = meanTime([&]()
+                                       { invoke(MVGaussianWithEnsemble3DSampling{options.isovalue, numSamples},
+                                                cellMean, cellFactor, crossProb, numNonzeroProb, entropy); });
+            }
+
+            computeError(reference, crossProb, entropy, result);
+            results.push_back(result);
+
+            std::cerr << sampler << " " << precision << " samples " << numSamples
+                      << " time " << result.setupTime + result.time
+                      << "s rms error " << result.rmsError << std::endl;
+        }
+    }
+}
+
+// a configuration is on the pareto front if no other configuration is both
+// faster (including the setup) and more accurate
+void markParetoFront()
+{
+    for (auto &candidate : results)
+    {
+        double candidateTime = candidate.setupTime + candidate.time;
+        candidate.pareto = true;
+        for (const auto &other : results)
+        {
+            double otherTime = other.setupTime + other.time;
+            bool noWorse = otherTime <= candidateTime && other.rmsError <= candidate.rmsError;
+            bool better = otherTime < candidateTime || other.rmsError < candidate.rmsError;
+            if (noWorse && better)
+            {
+                candidate.pareto = false;
+                break;
+            }
+        }
+    }
+}
+
+void writeCsv(std::ostream &out, const std::string &device)
+{
+    out << "device,reference,dims,sampler,precision,samples,setup_time,time,"
+        << "cross_prob_mean_abs_error,cross_prob_rms_error,cross_prob_max_abs_error,"
+        << "entropy_mean_abs_error,pareto\n";
+    for (const auto &r : results)
+    {
+        out << device << "," << options.reference << ","
+            << options.dims[0] << "x" << options.dims[1] << "x" << options.dims[2] << ","
+            << r.sampler << "," << r.precision << "," << r.samples << ","
+            << r.setupTime << "," << r.time << ","
+            << r.meanAbsError << "," << r.rmsError << "," << r.maxAbsError << ","
+            << r.entropyMeanAbsError << "," << (r.pareto ? 1 : 0) << "\n";
+    }
+}
+
+const std::string usageOptions =
+    "  --dims=X,Y,Z            grid size (default 16,16,16)\n"
+    "  --samples=N[,N...]      sample counts (default 10,100,1000,10000)\n"
+    "  --samplers=S[,S...]     fused and/or cached (default fused,cached)\n"
+    "  --precisions=P[,P...]   float32 and/or float64 input fields (default float32,float64)\n"
+    "  --reference=R           closed (diagonal covariance, compared with the independent\n"
+    "                          gaussian) or sampled (correlated, compared with many samples)\n"
+    "  --reference-samples=N   sample count of the sampled reference (default 100000)\n"
+    "  --reference-seed=N      nonzero seed of the sampled reference (default 12345)\n"
+    "  --isovalue=V            isovalue (default 0)\n"
+    "  --repetitions=N         number of timed runs of each configuration (default 3)\n"
+    "  --seed=N                seed of the generated ensemble (default 0)\n"
+    "  --output=FILE           write the csv report to FILE instead of stdout\n"
+    "The sampled reference draws its own random sequence, independent of the runs, and\n"
+    "should use many more samples than the largest sample count of the sweep.";
+
+int main(int argc, char *argv[])
+{
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+
+    bool parsed = parseCommandLine(argc, argv, usageOptions, [](const std::string &key, const std::string &value)
+                                   {
+        if (key == "--dims")
+        {
+            return parseDims(value, options.dims);
+        }
+        if (key == "--samples")
+        {
+            return parseIntList(value, options.samples);
+        }
+        if (key == "--samplers")
+        {
+            options.samplers = splitList(value);
+            bool ok = !options.samplers.empty();
+            for (const auto &item : options.samplers)
+            {
+                ok = ok && (item == "fused" || item == "cached");
+            }
+            return ok;
+        }
+        if (key == "--precisions")
+        {
+            options.precisions = splitList(value);
+            bool ok = !options.precisions.empty();
+            for (const auto &item : options.precisions)
+            {
+                ok = ok && (item == "float32" || item == "float64");
+            }
+            return ok;
+        }
+        if (key == "--reference")
+        {
+            options.reference = value;
+            return (value == "closed" || value == "sampled");
+        }
+        if (key == "--reference-samples")
+        {
+            options.referenceSamples = std::stoi(value);
+            return options.referenceSamples > 0;
+        }
+        if (key == "--reference-seed")
+        {
+            options.referenceSeed = static_cast<unsigned int>(std::stoul(value));
+            return options.referenceSeed != 0;
+        }
+        if (key == "--isovalue")
+        {
+            options.isovalue = std::stod(value);
+            return true;
+        }
+        if (key == "--repetitions")
+        {
+            options.repetitions = std::stoi(value);
+            return options.repetitions > 0;
+        }
+        if (key == "--seed")
+        {
+            options.seed = static_cast<unsigned int>(std::stoul(value));
+            return true;
+        }
+        if (key == "--output")
+        {
+            options.output = value;
+            return true;
+        }
+        return false; });
+    if (!parsed)
+    {
+        exit(1);
+    }
+
+    std::string device = runtime.GetDeviceName();
+
+    vtkm::cont::CellSetStructured<3> cellSet;
+    cellSet.SetPointDimensions(options.dims);
+
+    PointEnsemble ensemble = generateEnsemble(options.dims);
+    ReferenceValues reference = computeReference(cellSet, ensemble);
+
+    for (const std::string &precision : options.precisions)
+    {
+        if (precision == "float32")
+        {
+            sweepPrecision<vtkm::Float32>(precision, cellSet, ensemble, reference);
+        }
+        else
+        {
+            sweepPrecision<vtkm::Float64>(precision, cellSet, ensemble, reference);
+        }
+    }
+
+    markParetoFront();
+
+    if (options.output.empty())
+    {
+        writeCsv(std::cout, device);
+    }
+    else
+    {
+        std::ofstream out(options.output);
+        writeCsv(out, device);
+        std::cerr << "write the report to " << options.output << std::endl;
+    }
+
+    return 0;
+}
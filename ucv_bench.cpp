@@ -0,0 +1,476 @@
+#include <vtkm/cont/Initialize.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/Timer.h>
+#include <vtkm/worklet/Keys.h>
+
+#include "ucvworklet/CreateNewKey.hpp"
+#include "ucvworklet/EntropyIndependentGaussian.hpp"
+#include "ucvworklet/EntropyUniform.hpp"
+#include "ucvworklet/ExtractingMeanRaw.hpp"
+#include "ucvworklet/ExtractingMeanStdev.hpp"
+#include "ucvworklet/ExtractingMinMax.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DFactorize.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DSampling.hpp"
+#include "ucvworklet/MVGaussianWithEnsemble3DTryLialg.hpp"
+#include "ucvworklet/linalg/ucv_matrix_static_3by3.h"
+#include "ucvworklet/linalg/ucv_matrix_static_4by4.h"
+#include "ucvworklet/linalg/ucv_matrix_static_8by8.h"
+#include "UncertaintyRuntime.h"
+#include "ucv_command_line.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// micro benchmarks for the uncertainty worklets and the linear algebra kernels
+// the results are reported as json (similar to the google benchmark output)
+// with the throughput in items (cells, points or matrices) and bytes per second
+// so that the results of two builds can be compared
+
+constexpr vtkm::IdComponent ENSEMBLE_BLOCK_SIZE = 4;
+constexpr vtkm::IdComponent ENSEMBLE_SIZE = ENSEMBLE_BLOCK_SIZE * ENSEMBLE_BLOCK_SIZE * ENSEMBLE_BLOCK_SIZE;
+
+struct BenchOptions
+{
+    vtkm::Id3 dims{64, 64, 64};
+    vtkm::Id3 mvgDims{24, 24, 24};
+    std::vector<int> samples{100, 1000};
+    vtkm::Id numMatrices = 20000;
+    int repetitions = 5;
+    std::string filter;
+    std::string output;
+};
+
+struct BenchResult
+{
+    std::string name;
+    int repetitions;
+    double minTime;
+    double meanTime;
+    double maxTime;
+    double items;
+    double bytes;
+};
+
+BenchOptions options;
+std::vector<BenchResult> results;
+
+std::string dimsToString(const vtkm::Id3 &dims)
+{
+    std::stringstream ss;
+    ss << dims[0] << "x" << dims[1] << "x" << dims[2];
+    return ss.str();
+}
+
+// run the body once to warm up (this also moves the input arrays to the device)
+// and then time it for the number of repetitions, the throughput uses the mean time
+template <typename BodyType>
+void runBenchmark(const std::string &name, double items, double bytes, BodyType &&body)
+{
+    if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+    {
+        return;
+    }
+
+    body();
+
+    std::vector<double> times;
+    for (int r = 0; r < options.repetitions; r++)
+    {
+        vtkm::cont::Timer timer;
+        timer.Start();
+        body();
+        timer.Stop();
+        times.push_back(timer.GetElapsedTime());
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.repetitions = options.repetitions;
+    result.minTime = *std::min_element(times.begin(), times.end());
+    result.maxTime = *std::max_element(times.begin(), times.end());
+    result.meanTime = 0;
+    for (double t : times)
+    {
+        result.meanTime += t;
+    }
+    result.meanTime /= times.size();
+    result.items = items;
+    result.bytes = bytes;
+    results.push_back(result);
+
+    std::cerr << name << " mean " << result.meanTime << "s, "
+              << items / result.meanTime << " items/s" << std::endl;
+}
+
+// smooth field with some noise so that the contour goes through a good part of the domain
+vtkm::FloatDefault syntheticValue(const vtkm::Id3 &dims, vtkm::Id x, vtkm::Id y, vtkm::Id z)
+{
+    const double twoPi = 2.0 * vtkm::Pi();
+    double fx = std::sin(twoPi * 3.0 * x / dims[0]);
+    double fy = std::cos(twoPi * 2.0 * y / dims[1]);
+    double fz = std::sin(twoPi * 1.0 * z / dims[2]);
+    return static_cast<vtkm::FloatDefault>(fx * fy + 0.5 * fz);
+}
+
+vtkm::cont::ArrayHandle<vtkm::FloatDefault> generateField(const vtkm::Id3 &dims, double noise)
+{
+    std::mt19937 rng(0);
+    std::normal_distribution<double> norm(0.0, 1.0);
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> field;
+    field.Allocate(dims[0] * dims[1] * dims[2]);
+    auto portal = field.WritePortal();
+    vtkm::Id index = 0;
+    for (vtkm::Id z = 0; z < dims[2]; z++)
+    {
+        for (vtkm::Id y = 0; y < dims[1]; y++)
+        {
+            for (vtkm::Id x = 0; x < dims[0]; x++)
+            {
+                portal.Set(index++, syntheticValue(dims, x, y, z) + static_cast<vtkm::FloatDefault>(noise * norm(rng)));
+            }
+        }
+    }
+    return field;
+}
+
+vtkm::Id numberOfCells(const vtkm::Id3 &dims)
+{
+    return (dims[0] - 1) * (dims[1] - 1) * (dims[2] - 1);
+}
+
+void benchEigenDecomposition()
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    vtkm::Id numMatrices = options.numMatrices;
+
+    // symmetric positive definite matrices built as B*B^T + I
+    auto fillSPD = [&](auto &m, int size)
+    {
+        double b[8][8];
+        for (int i = 0; i < size; i++)
+        {
+            for (int j = 0; j < size; j++)
+            {
+                b[i][j] = dist(rng);
+            }
+        }
+        for (int i = 0; i < size; i++)
+        {
+            for (int j = 0; j < size; j++)
+            {
+                double sum = (i == j) ? 1.0 : 0.0;
+                for (int k = 0; k < size; k++)
+                {
+                    sum += b[i][k] * b[j][k];
+                }
+                m.v[i][j] = sum;
+            }
+        }
+    };
+
+    // the matrices are generated once and decomposed in the timed loop,
+    // the decomposition works on a copy since the eigen solver modifies its input
+    std::vector<UCVMATH_THREE::mat_t> mats3(numMatrices);
+    std::vector<UCVMATH4BY4::mat_t> mats4(numMatrices);
+    std::vector<UCVMATH::mat_t> mats8(numMatrices);
+    for (vtkm::Id i = 0; i < numMatrices; i++)
+    {
+        fillSPD(mats3[i], 3);
+        fillSPD(mats4[i], 4);
+        fillSPD(mats8[i], 8);
+    }
+
+    volatile double sink = 0;
+    runBenchmark("BM_EigenDecomposition/3x3", numMatrices, numMatrices * sizeof(double) * 3 * 3 * 2, [&]()
+                 {
+        for (vtkm::Id i = 0; i < numMatrices; i++)
+        {
+            UCVMATH_THREE::mat_t m = mats3[i];
+            UCVMATH_THREE::mat_t a = UCVMATH_THREE::eigen_vector_decomposition(&m);
+            sink = sink + a.v[0][0];
+        } });
+    runBenchmark("BM_EigenDecomposition/4x4", numMatrices, numMatrices * sizeof(double) * 4 * 4 * 2, [&]()
+                 {
+        for (vtkm::Id i = 0; i < numMatrices; i++)
+        {
+            UCVMATH4BY4::mat_t m = mats4[i];
+            UCVMATH4BY4::mat_t a = UCVMATH4BY4::eigen_vector_decomposition(&m);
+            sink = sink + a.v[0][0];
+        } });
+    runBenchmark("BM_EigenDecomposition/8x8", numMatrices, numMatrices * sizeof(double) * 8 * 8 * 2, [&]()
+                 {
+        for (vtkm::Id i = 0; i < numMatrices; i++)
+        {
+            UCVMATH::mat_t m = mats8[i];
+            UCVMATH::mat_t a = UCVMATH::eigen_vector_decomposition(&m);
+            sink = sink + a.v[0][0];
+        } });
+}
+
+void benchSubsample()
+{
+    vtkm::cont::Invoker invoke;
+    vtkm::Id3 dims = options.dims;
+    vtkm::Id numPoints = dims[0] * dims[1] * dims[2];
+    vtkm::Id3 numBlocks = (dims + vtkm::Id3(ENSEMBLE_BLOCK_SIZE - 1)) / vtkm::Id3(ENSEMBLE_BLOCK_SIZE);
+    vtkm::Id numReduced = numBlocks[0] * numBlocks[1] * numBlocks[2];
+    std::string suffix = "/" + dimsToString(dims);
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> field = generateField(dims, 0.1);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> keyArray;
+    runBenchmark("BM_CreateKeys" + suffix, numPoints, numPoints * sizeof(vtkm::Id), [&]()
+                 { invoke(CreateNewKeyWorklet{dims, numBlocks, ENSEMBLE_BLOCK_SIZE},
+                          vtkm::cont::ArrayHandleIndex{numPoints},
+                          keyArray); });
+    vtkm::worklet::Keys<vtkm::Id> keys(keyArray);
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> out1;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> out2;
+    double twoScalarBytes = numPoints * sizeof(vtkm::FloatDefault) + 2.0 * numReduced * sizeof(vtkm::FloatDefault);
+
+    runBenchmark("BM_ExtractingMinMax" + suffix, numPoints, twoScalarBytes, [&]()
+                 { invoke(ExtractingMinMax{}, keys, field, out1, out2); });
+    runBenchmark("BM_ExtractingMeanStdev" + suffix, numPoints, twoScalarBytes, [&]()
+                 { invoke(ExtractingMeanStdev{}, keys, field, out1, out2); });
+
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, ENSEMBLE_SIZE>> rawVec;
+    runBenchmark("BM_ExtractingMeanRaw" + suffix, numPoints,
+                 2.0 * numPoints * sizeof(vtkm::FloatDefault) + numReduced * sizeof(vtkm::FloatDefault), [&]()
+                 { invoke(ExtractingMeanRaw{}, keys, field, out1, rawVec); });
+}
+
+void benchEntropy()
+{
+    vtkm::cont::Invoker invoke;
+    vtkm::Id3 dims = options.dims;
+    vtkm::Id numPoints = dims[0] * dims[1] * dims[2];
+    vtkm::Id numCells = numberOfCells(dims);
+    std::string suffix = "/" + dimsToString(dims);
+
+    vtkm::cont::CellSetStructured<3> cellSet;
+    cellSet.SetPointDimensions(dims);
+
+    // the uncertainty range is a random width around the synthetic field
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> center = generateField(dims, 0.0);
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> width = generateField(dims, 0.1);
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> lower;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> upper;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> stdev;
+    lower.Allocate(numPoints);
+    upper.Allocate(numPoints);
+    stdev.Allocate(numPoints);
+    {
+        auto centerPortal = center.ReadPortal();
+        auto widthPortal = width.ReadPortal();
+        auto lowerPortal = lower.WritePortal();
+        auto upperPortal = upper.WritePortal();
+        auto stdevPortal = stdev.WritePortal();
+        for (vtkm::Id i = 0; i < numPoints; i++)
+        {
+            vtkm::FloatDefault w = vtkm::Abs(widthPortal.Get(i) - centerPortal.Get(i)) + 0.05f;
+            lowerPortal.Set(i, centerPortal.Get(i) - w);
+            upperPortal.Set(i, centerPortal.Get(i) + w);
+            stdevPortal.Set(i, w);
+        }
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> crossProb;
+    vtkm::cont::ArrayHandle<vtkm::Id> numNonzeroProb;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> entropy;
+
+    // the bytes are the unique data read and written, each point is
+    // gathered by up to 8 cells but it mostly stays in the cache
+    double bytes = 2.0 * numPoints * sizeof(vtkm::FloatDefault) +
+                   numCells * (2.0 * sizeof(vtkm::FloatDefault) + sizeof(vtkm::Id));
+
+    runBenchmark("BM_EntropyUniform" + suffix, numCells, bytes, [&]()
+                 { invoke(EntropyUniform{0.0}, cellSet, lower, upper, crossProb, numNonzeroProb, entropy); });
+    runBenchmark("BM_EntropyIndependentGaussian" + suffix, numCells, bytes, [&]()
+                 { invoke(EntropyIndependentGaussian{0.0}, cellSet, center, stdev, crossProb, numNonzeroProb, entropy); });
+}
+
+void benchMVGaussian()
+{
+    vtkm::cont::Invoker invoke;
+    vtkm::Id3 dims = options.mvgDims;
+    vtkm::Id numPoints = dims[0] * dims[1] * dims[2];
+    vtkm::Id numCells = numberOfCells(dims);
+    std::string suffix = "/" + dimsToString(dims);
+
+    vtkm::cont::CellSetStructured<3> cellSet;
+    cellSet.SetPointDimensions(dims);
+
+    // each point has ENSEMBLE_SIZE members around the synthetic field
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, ENSEMBLE_SIZE>> ensemble;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> mean;
+    ensemble.Allocate(numPoints);
+    mean.Allocate(numPoints);
+    {
+        std::mt19937 rng(0);
+        std::normal_distribution<double> norm(0.0, 0.2);
+        auto ensemblePortal = ensemble.WritePortal();
+        auto meanPortal = mean.WritePortal();
+        vtkm::Id index = 0;
+        for (vtkm::Id z = 0; z < dims[2]; z++)
+        {
+            for (vtkm::Id y = 0; y < dims[1]; y++)
+            {
+                for (vtkm::Id x = 0; x < dims[0]; x++)
+                {
+                    vtkm::FloatDefault value = syntheticValue(dims, x, y, z);
+                    vtkm::Vec<vtkm::FloatDefault, ENSEMBLE_SIZE> members;
+                    vtkm::FloatDefault sum = 0;
+                    for (vtkm::IdComponent m = 0; m < ENSEMBLE_SIZE; m++)
+                    {
+                        members[m] = value + static_cast<vtkm::FloatDefault>(norm(rng));
+                        sum += members[m];
+                    }
+                    ensemblePortal.Set(index, members);
+                    meanPortal.Set(index, sum / ENSEMBLE_SIZE);
+                    index++;
+                }
+            }
+        }
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> crossProb;
+    vtkm::cont::ArrayHandle<vtkm::Id> numNonzeroProb;
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> entropy;
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 8>> cellMean;
+    vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::Float64, 64>> cellFactor;
+
+    double inBytes = numPoints * (ENSEMBLE_SIZE + 1.0) * sizeof(vtkm::FloatDefault);
+    double outBytes = numCells * (2.0 * sizeof(vtkm::FloatDefault) + sizeof(vtkm::Id));
+    double factorBytes = numCells * (8.0 + 64.0) * sizeof(vtkm::Float64);
+
+    runBenchmark("BM_MVGaussian3DFactorize" + suffix, numCells, inBytes + factorBytes, [&]()
+                 { invoke(MVGaussianWithEnsemble3DFactorize{}, cellSet, ensemble, mean, cellMean, cellFactor); });
+
+    for (int numSamples : options.samples)
+    {
+        std::string sampleSuffix = suffix + "/samples:" + std::to_string(numSamples);
+        runBenchmark("BM_MVGaussian3D" + sampleSuffix, numCells, inBytes + outBytes, [&]()
+                     { invoke(MVGaussianWithEnsemble3DTryLialg{0.0, numSamples},
+                              cellSet, ensemble, mean, crossProb, numNonzeroProb, entropy); });
+        runBenchmark("BM_MVGaussian3DSampling" + sampleSuffix, numCells, factorBytes + outBytes, [&]()
+                     { invoke(MVGaussianWithEnsemble3DSampling{0.0, numSamples},
+                              cellMean, cellFactor, crossProb, numNonzeroProb, entropy); });
+    }
+}
+
+void writeJson(std::ostream &out, const std::string &device)
+{
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"device\": \"" << device << "\",\n";
+    out << "    \"repetitions\": " << options.repetitions << ",\n";
+    out << "    \"dims\": \"" << dimsToString(options.dims) << "\",\n";
+    out << "    \"mvg_dims\": \"" << dimsToString(options.mvgDims) << "\",\n";
+    out << "    \"float_bytes\": " << sizeof(vtkm::FloatDefault) << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult &r = results[i];
+        out << "    {\n";
+        out << "      \"name\": \"" << r.name << "\",\n";
+        out << "      \"repetitions\": " << r.repetitions << ",\n";
+        out << "      \"real_time\": " << r.meanTime << ",\n";
+        out << "      \"min_time\": " << r.minTime << ",\n";
+        out << "      \"max_time\": " << r.maxTime << ",\n";
+        out << "      \"time_unit\": \"s\",\n";
+        out << "      \"items_per_second\": " << r.items / r.meanTime << ",\n";
+        out << "      \"bytes_per_second\": " << r.bytes / r.meanTime << "\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+const std::string usageOptions =
+    "  --dims=X,Y,Z          grid size of the subsampling and entropy benchmarks (default 64,64,64)\n"
+    "  --mvg-dims=X,Y,Z      grid size of the multivariant gaussian benchmarks (default 24,24,24)\n"
+    "  --samples=N[,N...]    sample counts of the multivariant gaussian benchmarks (default 100,1000)\n"
+    "  --matrices=N          number of matrices for the eigen decomposition benchmarks (default 20000)\n"
+    "  --repetitions=N       number of timed runs of each benchmark (default 5)\n"
+    "  --filter=STR          only run the benchmarks whose name contains STR\n"
+    "  --output=FILE         write the json report to FILE instead of stdout\n"
+    "The backend is selected with --vtkm-device and the threads with UCV_NUM_THREADS.";
+
+int main(int argc, char *argv[])
+{
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+
+    bool parsed = parseCommandLine(argc, argv, usageOptions, [](const std::string &key, const std::string &value)
+                                   {
+        if (key == "--dims")
+        {
+            return parseDims(value, options.dims);
+        }
+        if (key == "--mvg-dims")
+        {
+            return parseDims(value, options.mvgDims);
+        }
+        if (key == "--samples")
+        {
+            return parseIntList(value, options.samples);
+        }
+        if (key == "--matrices")
+        {
+            options.numMatrices = std::stol(value);
+            return options.numMatrices > 0;
+        }
+        if (key == "--repetitions")
+        {
+            options.repetitions = std::stoi(value);
+            return options.repetitions > 0;
+        }
+        if (key == "--filter")
+        {
+            options.filter = value;
+            return true;
+        }
+        if (key == "--output")
+        {
+            options.output = value;
+            return true;
+        }
+        return false; });
+    if (!parsed)
+    {
+        exit(1);
+    }
+
+    std::string device = runtime.GetDeviceName();
+
+    benchEigenDecomposition();
+    benchSubsample();
+    benchEntropy();
+    benchMVGaussian();
+
+    if (options.output.empty())
+    {
+        writeJson(std::cout, device);
+    }
+    else
+    {
+        std::ofstream out(options.output);
+        writeJson(out, device);
+        std::cerr << "write the report to " << options.output << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,405 @@
+#include <vtkm/cont/Initialize.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/Timer.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include "ContourUncertainEnsemble.h"
+#include "ContourUncertainIndependentGaussian.h"
+#include "ContourUncertainUniform.h"
+#include "SubsampleUncertaintyEnsemble.h"
+#include "SubsampleUncertaintyIndependentGaussian.h"
+#include "SubsampleUncertaintyUniform.h"
+#include "UncertaintyRuntime.h"
+#include "ucv_command_line.h"
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// end to end benchmark of the subsample -> contour pipeline on synthetic data
+// the input is a gaussian random field (white noise smoothed with a gaussian kernel
+// whose width is the correlation length) plus uncorrelated noise, so the
+// performance studies can be reproduced without the beetle/red sea data sets
+//
+// as in ucv_reduce_umc, the ensemble of each subsampled point is the block of
+// points grouped into it, so the ensemble size is the cube of the block size
+
+// standard normal numbers computed from the index (splitmix64 + Box-Muller),
+// so the same field is generated with every backend and number of threads
+struct GenerateWhiteNoise : public vtkm::worklet::WorkletMapField
+{
+    GenerateWhiteNoise(vtkm::UInt64 seed) : m_seed(seed){};
+
+    using ControlSignature = void(FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2);
+
+    VTKM_EXEC vtkm::Float64 uniform(vtkm::UInt64 x) const
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x = x ^ (x >> 31);
+        // 53 bits in (0, 1]
+        return (static_cast<vtkm::Float64>(x >> 11) + 1.0) / 9007199254740992.0;
+    }
+
+    VTKM_EXEC void operator()(const vtkm::Id &index, vtkm::FloatDefault &value) const
+    {
+        vtkm::UInt64 counter = m_seed * 0x100000000ull + 2 * static_cast<vtkm::UInt64>(index);
+        vtkm::Float64 u1 = uniform(counter);
+        vtkm::Float64 u2 = uniform(counter + 1);
+        value = static_cast<vtkm::FloatDefault>(vtkm::Sqrt(-2.0 * vtkm::Log(u1)) * vtkm::Cos(2.0 * vtkm::Pi() * u2));
+    }
+
+private:
+    vtkm::UInt64 m_seed;
+};
+
+// one pass of a separable gaussian filter along the given axis,
+// the points outside of the domain are clamped to the boundary
+struct GaussianSmoothAxis : public vtkm::worklet::WorkletMapField
+{
+    GaussianSmoothAxis(vtkm::Id3 dims, vtkm::IdComponent axis, vtkm::Float64 sigma)
+        : m_dims(dims), m_axis(axis), m_sigma(sigma), m_radius(static_cast<vtkm::Id>(vtkm::Ceil(3.0 * sigma))){};
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename InPortalType>
+    VTKM_EXEC void operator()(const vtkm::Id &index, const InPortalType &inPortal, vtkm::FloatDefault &value) const
+    {
+        vtkm::Id3 ijk(index % m_dims[0], (index / m_dims[0]) % m_dims[1], index / m_dims[0] / m_dims[1]);
+
+        vtkm::Float64 sum = 0;
+        vtkm::Float64 weightSum = 0;
+        for (vtkm::Id k = -m_radius; k <= m_radius; k++)
+        {
+            vtkm::Id3 p = ijk;
+            p[m_axis] = vtkm::Min(vtkm::Max(p[m_axis] + k, vtkm::Id(0)), m_dims[m_axis] - 1);
+            vtkm::Float64 weight = vtkm::Exp(-0.5 * k * k / (m_sigma * m_sigma));
+            sum += weight * static_cast<vtkm::Float64>(inPortal.Get(p[0] + p[1] * m_dims[0] + p[2] * m_dims[0] * m_dims[1]));
+            weightSum += weight;
+        }
+        value = static_cast<vtkm::FloatDefault>(sum / weightSum);
+    }
+
+private:
+    vtkm::Id3 m_dims;
+    vtkm::IdComponent m_axis;
+    vtkm::Float64 m_sigma;
+    vtkm::Id m_radius;
+};
+
+struct SyntheticOptions
+{
+    vtkm::Id3 dims{128, 128, 128};
+    double corrLength = 4.0;
+    int ensembleSize = 64;
+    double noise = 0.1;
+    double isovalue = 0.0;
+    int numSamples = 1000;
+    int repetitions = 3;
+    vtkm::UInt64 seed = 1;
+    std::vector<std::string> distributions{"uni", "ig", "mg"};
+    std::string output;
+};
+
+SyntheticOptions options;
+
+// the field is a unit variance gaussian random field with the given correlation
+// length plus uncorrelated gaussian noise with the given standard deviation
+vtkm::cont::ArrayHandle<vtkm::FloatDefault> generateField()
+{
+    vtkm::cont::Invoker invoke;
+    vtkm::Id3 dims = options.dims;
+    vtkm::Id numPoints = dims[0] * dims[1] * dims[2];
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> grf;
+    invoke(GenerateWhiteNoise{options.seed}, vtkm::cont::ArrayHandleIndex(numPoints), grf);
+
+    if (options.corrLength > 0)
+    {
+        vtkm::cont::ArrayHandle<vtkm::FloatDefault> smoothed;
+        for (vtkm::IdComponent axis = 0; axis < 3; axis++)
+        {
+            invoke(GaussianSmoothAxis{dims, axis, options.corrLength}, vtkm::cont::ArrayHandleIndex(numPoints), grf, smoothed);
+            std::swap(grf, smoothed);
+        }
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> white;
+    invoke(GenerateWhiteNoise{options.seed + 1}, vtkm::cont::ArrayHandleIndex(numPoints), white);
+
+    // normalize the smoothed field, the smoothing reduces its variance
+    auto grfPortal = grf.WritePortal();
+    auto whitePortal = white.ReadPortal();
+    double sum = 0;
+    double sumSquare = 0;
+    for (vtkm::Id i = 0; i < numPoints; i++)
+    {
+        double v = grfPortal.Get(i);
+        sum += v;
+        sumSquare += v * v;
+    }
+    double mean = sum / numPoints;
+    double stdev = std::sqrt(std::max(sumSquare / numPoints - mean * mean, 1e-30));
+    for (vtkm::Id i = 0; i < numPoints; i++)
+    {
+        double v = (grfPortal.Get(i) - mean) / stdev + options.noise * whitePortal.Get(i);
+        grfPortal.Set(i, static_cast<vtkm::FloatDefault>(v));
+    }
+
+    return grf;
+}
+
+// resets the peak resident set size of the process to its current size, so the peak
+// read after a run only covers that run, this needs linux 4.0 or later
+bool resetPeakRSS()
+{
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (!clearRefs)
+    {
+        return false;
+    }
+    clearRefs << "5";
+    clearRefs.flush();
+    return static_cast<bool>(clearRefs);
+}
+
+// the peak resident set size since the last reset (VmHWM), or since the start of the
+// process when /proc/self/status is not available
+double maxRSSMB()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            std::stringstream ss(line.substr(6));
+            double kilobytes = 0;
+            ss >> kilobytes;
+            return kilobytes / 1024.0;
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    // ru_maxrss is in kilobytes on linux
+    return usage.ru_maxrss / 1024.0;
+}
+
+const std::string usageOptions =
+    "  --dims=X,Y,Z            size of the synthetic grid (default 128,128,128)\n"
+    "  --corr-length=L         correlation length of the random field in points (default 4)\n"
+    "  --ensemble-size=N       points grouped for each subsampled point, a cube such as 8, 27, 64 (default 64)\n"
+    "  --noise=S               standard deviation of the uncorrelated noise (default 0.1)\n"
+    "  --isovalue=V            isovalue of the contour (default 0)\n"
+    "  --samples=N             samples of the multivariant gaussian (default 1000)\n"
+    "  --distributions=LIST    subset of uni,ig,mg (default uni,ig,mg)\n"
+    "  --repetitions=N         runs of the pipeline for each distribution (default 3)\n"
+    "  --seed=N                seed of the random field (default 1)\n"
+    "  --output=FILE           write the csv to FILE instead of stdout\n"
+    "The backend is selected with --vtkm-device and the threads with UCV_NUM_THREADS.";
+
+int main(int argc, char *argv[])
+{
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+    vtkm::cont::Timer timer{runtime.GetDevice()};
+
+    bool parsed = parseCommandLine(argc, argv, usageOptions, [](const std::string &key, const std::string &value)
+                                   {
+        if (key == "--dims")
+        {
+            return parseDims(value, options.dims);
+        }
+        if (key == "--corr-length")
+        {
+            options.corrLength = std::stod(value);
+            return options.corrLength >= 0;
+        }
+        if (key == "--ensemble-size")
+        {
+            options.ensembleSize = std::stoi(value);
+            return options.ensembleSize > 0;
+        }
+        if (key == "--noise")
+        {
+            options.noise = std::stod(value);
+            return options.noise >= 0;
+        }
+        if (key == "--isovalue")
+        {
+            options.isovalue = std::stod(value);
+            return true;
+        }
+        if (key == "--samples")
+        {
+            options.numSamples = std::stoi(value);
+            return options.numSamples > 0;
+        }
+        if (key == "--distributions")
+        {
+            options.distributions = splitList(value);
+            bool ok = !options.distributions.empty();
+            for (const std::string &item : options.distributions)
+            {
+                ok = ok && (item == "uni" || item == "ig" || item == "mg");
+            }
+            return ok;
+        }
+        if (key == "--repetitions")
+        {
+            options.repetitions = std::stoi(value);
+            return options.repetitions > 0;
+        }
+        if (key == "--seed")
+        {
+            options.seed = std::stoull(value);
+            return true;
+        }
+        if (key == "--output")
+        {
+            options.output = value;
+            return true;
+        }
+        return false; });
+    if (!parsed)
+    {
+        exit(1);
+    }
+
+    int blocksize = static_cast<int>(std::round(std::cbrt(static_cast<double>(options.ensembleSize))));
+    if (blocksize * blocksize * blocksize != options.ensembleSize)
+    {
+        std::cout << "the ensemble size " << options.ensembleSize << " is not the cube of a block size" << std::endl;
+        exit(1);
+    }
+
+    const std::string fieldName = "synthetic";
+    vtkm::Id3 dims = options.dims;
+    vtkm::Id numInputCells = (dims[0] - 1) * (dims[1] - 1) * (dims[2] - 1);
+
+    timer.Start();
+    vtkm::cont::DataSet input = vtkm::cont::DataSetBuilderUniform::Create(dims);
+    input.AddPointField(fieldName, generateField());
+    timer.Stop();
+    double generateTime = timer.GetElapsedTime();
+    std::cerr << "generate time: " << generateTime << std::endl;
+
+    std::ofstream outFile;
+    if (!options.output.empty())
+    {
+        outFile.open(options.output);
+    }
+    std::ostream &out = options.output.empty() ? std::cout : outFile;
+
+    out << "distribution,dims_x,dims_y,dims_z,corr_length,ensemble_size,noise,samples,repetition,"
+        << "generate_time,subsample_time,contour_time,total_time,input_cells,output_cells,input_cells_per_second,max_rss_mb,rss_scope"
+        << std::endl;
+
+    for (const std::string &distribution : options.distributions)
+    {
+        if (distribution == "mg" && blocksize != 4)
+        {
+            std::cerr << "skip mg, the multivariant gaussian only supports the ensemble size 64" << std::endl;
+            continue;
+        }
+
+        for (int rep = 0; rep < options.repetitions; rep++)
+        {
+            // the peak of each run starts from the memory in use before it (the input field),
+            // without the reset it is the peak of the whole process so far
+            bool perRunPeak = resetPeakRSS();
+
+            vtkm::cont::DataSet dataset;
+            double subsampleTime = 0;
+            double contourTime = 0;
+
+            if (distribution == "uni")
+            {
+                vtkm::filter::uncertainty::SubsampleUncertaintyUniform subsample;
+                subsample.SetBlockSize(blocksize);
+
+                timer.Start();
+                dataset = subsample.Execute(input);
+                timer.Stop();
+                subsampleTime = timer.GetElapsedTime();
+
+                vtkm::filter::uncertainty::ContourUncertainUniform contour;
+                contour.SetMinField(fieldName + subsample.GetMinSuffix());
+                contour.SetMaxField(fieldName + subsample.GetMaxSuffix());
+                contour.SetIsoValue(options.isovalue);
+
+                timer.Start();
+                dataset = contour.Execute(dataset);
+                timer.Stop();
+                contourTime = timer.GetElapsedTime();
+            }
+            else if (distribution == "ig")
+            {
+                vtkm::filter::uncertainty::SubsampleUncertaintyIndependentGaussian subsample;
+                subsample.SetBlockSize(blocksize);
+
+                timer.Start();
+                dataset = subsample.Execute(input);
+                timer.Stop();
+                subsampleTime = timer.GetElapsedTime();
+
+                vtkm::filter::uncertainty::ContourUncertainIndependentGaussian contour;
+                contour.SetMeanField(fieldName + subsample.GetMeanSuffix());
+                contour.SetStdevField(fieldName + subsample.GetStdevSuffix());
+                contour.SetIsoValue(options.isovalue);
+
+                timer.Start();
+                dataset = contour.Execute(dataset);
+                timer.Stop();
+                contourTime = timer.GetElapsedTime();
+            }
+            else
+            {
+                vtkm::filter::uncertainty::SubsampleUncertaintyEnsemble subsample;
+                subsample.SetBlockSize(blocksize);
+
+                timer.Start();
+                dataset = subsample.Execute(input);
+                timer.Stop();
+                subsampleTime = timer.GetElapsedTime();
+
+                vtkm::filter::uncertainty::ContourUncertainEnsemble contour;
+                contour.SetMeanField(fieldName + subsample.GetMeanSuffix());
+                contour.SetEnsembleField(fieldName + subsample.GetEnsembleSuffix());
+                contour.SetIsoValue(options.isovalue);
+                contour.SetNumberOfSamples(options.numSamples);
+
+                timer.Start();
+                dataset = contour.Execute(dataset);
+                timer.Stop();
+                contourTime = timer.GetElapsedTime();
+            }
+
+            double totalTime = subsampleTime + contourTime;
+            // host memory only
+            out << distribution << "," << dims[0] << "," << dims[1] << "," << dims[2] << ","
+                << options.corrLength << "," << options.ensembleSize << "," << options.noise << ","
+                << options.numSamples << "," << rep << ","
+                << generateTime << "," << subsampleTime << "," << contourTime << "," << totalTime << ","
+                << numInputCells << "," << dataset.GetNumberOfCells() << ","
+                << numInputCells / totalTime << "," << maxRSSMB() << ","
+                << (perRunPeak ? "run" : "process") << std::endl;
+        }
+    }
+
+    return 0;
+}
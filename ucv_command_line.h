@@ -0,0 +1,101 @@
+#ifndef UCV_COMMAND_LINE_h
+#define UCV_COMMAND_LINE_h
+
+#include <vtkm/Types.h>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// the --key=value command line of the benchmark and accuracy drivers
+// (ucv_bench, ucv_bench_synthetic, ucv_accuracy and ucv_scaling)
+
+// X,Y,Z with more than one point along each axis
+inline bool parseDims(const std::string &value, vtkm::Id3 &dims)
+{
+    char sep1, sep2;
+    std::stringstream ss(value);
+    if (!(ss >> dims[0] >> sep1 >> dims[1] >> sep2 >> dims[2]))
+    {
+        return false;
+    }
+    return dims[0] > 1 && dims[1] > 1 && dims[2] > 1;
+}
+
+// the items of a comma separated list
+inline std::vector<std::string> splitList(const std::string &value)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        items.push_back(item);
+    }
+    return items;
+}
+
+// a non empty comma separated list of positive integers
+inline bool parseIntList(const std::string &value, std::vector<int> &list)
+{
+    list.clear();
+    for (const std::string &item : splitList(value))
+    {
+        list.push_back(std::stoi(item));
+        if (list.back() < 1)
+        {
+            return false;
+        }
+    }
+    return !list.empty();
+}
+
+// the usage line followed by the option lines of the driver
+inline void printUsage(const char *name, const std::string &optionLines)
+{
+    std::cout << "Usage: " << name << " [options]\n"
+              << optionLines << std::endl;
+}
+
+// splits each argument into the key and the value after '=' (empty without '=') and passes
+// them to the handler, which returns false for an unknown key or an invalid value
+// --help prints the usage and exits, an invalid argument prints it and returns false
+template <typename HandlerType>
+bool parseCommandLine(int argc, char *argv[], const std::string &optionLines, HandlerType &&handler)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string key = arg.substr(0, arg.find('='));
+        std::string value = arg.find('=') == std::string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (key == "--help")
+        {
+            printUsage(argv[0], optionLines);
+            exit(0);
+        }
+
+        bool ok = false;
+        try
+        {
+            ok = handler(key, value);
+        }
+        catch (const std::exception &)
+        {
+            // std::stoi and the other conversions throw on a value that is not a number
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            std::cout << "unrecognized or invalid argument " << arg << std::endl;
+            printUsage(argv[0], optionLines);
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // UCV_COMMAND_LINE_h
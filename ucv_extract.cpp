@@ -5,6 +5,8 @@
 #include <vtkm/worklet/WorkletPointNeighborhood.h>
 #include <vtkm/cont/ArrayHandle.h>
 
+#include "UncertaintyRuntime.h"
+
 #include <float.h>
 
 struct GoThroughNeigoborhood : public vtkm::worklet::WorkletPointNeighborhood
@@ -68,8 +70,9 @@ using SupportedTypes = vtkm::List<vtkm::Float32,
 // TODO, extracting the ensemble data based on vtk operation
 int main(int argc, char *argv[])
 {
-    // init the vtkm (set the backend and log level here)
-    vtkm::cont::Initialize(argc, argv);
+    // init the vtkm (set the backend, threads and log level here)
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+    runtime.PrintSummary(std::cout);
 
     if (argc != 3)
     {
@@ -10,6 +10,8 @@
 
 #include <vtkm/worklet/WorkletMapField.h>
 
+#include "UncertaintyRuntime.h"
+
 #include <float.h>
 
 struct CreateNewKeyWorklet : public vtkm::worklet::WorkletMapField
@@ -96,8 +98,9 @@ using SupportedTypes = vtkm::List<vtkm::Float32,
 
 int main(int argc, char *argv[])
 {
-    // init the vtkm (set the backend and log level here)
-    vtkm::cont::Initialize(argc, argv);
+    // init the vtkm (set the backend, threads and log level here)
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+    runtime.PrintSummary(std::cout);
 
     if (argc != 3)
     {
@@ -8,87 +8,26 @@
 #include <vtkm/cont/Initialize.h>
 #include <vtkm/cont/Timer.h>
 
+#include "ContourUncertainEdges.h"
 #include "ContourUncertainEnsemble.h"
+#include "ContourUncertainGeometry.h"
+#include "ContourUncertainHistogram.h"
 #include "ContourUncertainIndependentGaussian.h"
+#include "ContourUncertainMixture.h"
+#include "ContourUncertainSeparableGaussian.h"
 #include "ContourUncertainUniform.h"
+#include "QuantizeUncertainContour.h"
+#include "SparseUncertainContour.h"
 #include "SubsampleUncertaintyEnsemble.h"
+#include "SubsampleUncertaintyHistogram.h"
 #include "SubsampleUncertaintyIndependentGaussian.h"
+#include "SubsampleUncertaintyMixture.h"
 #include "SubsampleUncertaintyUniform.h"
+#include "UncertaintyRuntime.h"
 
 #include <sstream>
 #include <iomanip>
 
-int oneDBlocks = 16;
-int threadsPerBlock = 16;
-#ifdef VTKM_CUDA
-// Note: this header will require this file to be compiled with nvcc, but it is required
-// for vtkm::cont::cuda::ScheduleParameters.
-#include <vtkm/cont/cuda/DeviceAdapterCuda.h>
-
-vtkm::cont::cuda::ScheduleParameters
-mySchedParams(char const *name,
-              int major,
-              int minor,
-              int multiProcessorCount,
-              int maxThreadsPerMultiProcessor,
-              int maxThreadsPerBlock)
-{
-    vtkm::cont::cuda::ScheduleParameters p;
-    p.one_d_blocks = oneDBlocks;
-    p.one_d_threads_per_block = threadsPerBlock;
-
-    return p;
-}
-#endif
-
-std::string backend = "openmp";
-
-void initBackend(vtkm::cont::Timer &timer)
-{
-    // init the vtkh device
-    char const *tmp = getenv("UCV_VTKM_BACKEND");
-
-    if (tmp == nullptr)
-    {
-        return;
-    }
-    else
-    {
-        backend = std::string(tmp);
-        std::cout << "Setting the device with UCV_VTKM_BACKEND=" << backend << "\n";
-        std::cout << "This method is antiquated. Consider using the --vtkm-device command line argument." << std::endl;
-    }
-
-    // if (rank == 0)
-    //{
-    std::cout << "vtkm backend is:" << backend << std::endl;
-    //}
-
-    if (backend == "serial")
-    {
-        vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-        device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagSerial());
-        timer.Reset(vtkm::cont::DeviceAdapterTagSerial());
-    }
-    else if (backend == "openmp")
-    {
-        vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-        device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagOpenMP());
-        timer.Reset(vtkm::cont::DeviceAdapterTagOpenMP());
-    }
-    else if (backend == "cuda")
-    {
-        vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-        device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagCuda());
-        timer.Reset(vtkm::cont::DeviceAdapterTagCuda());
-    }
-    else
-    {
-        std::cerr << " unrecognized backend " << backend << std::endl;
-    }
-    return;
-}
-
 using SupportedTypes = vtkm::List<vtkm::Float32,
                                   vtkm::Float64,
                                   vtkm::Int8,
@@ -102,19 +41,16 @@ using SupportedTypes = vtkm::List<vtkm::Float32,
 int main(int argc, char *argv[])
 {
 
-    // init the vtkm (set the backend and log level here)
-    vtkm::cont::InitializeResult initResult = vtkm::cont::Initialize(
-        argc, argv, vtkm::cont::InitializeOptions::DefaultAnyDevice);
-    vtkm::cont::Timer timer{ initResult.Device };
-    initBackend(timer);
-
-    std::cout << "initResult.Device: " << initResult.Device.GetName() <<  " timer device: " << timer.GetDevice().GetName() << std::endl;
+    // init the vtkm (set the backend, threads and log level here)
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+    vtkm::cont::Timer timer{ runtime.GetDevice() };
+    runtime.PrintSummary(std::cout);
 
     if (argc != 6)
     {
         std::cout << "executable [VTK-m options] <filename> <fieldname> <distribution> <blocksize> <isovalue>" << std::endl;
         std::cout << "VTK-m options are:\n";
-        std::cout << initResult.Usage << std::endl;
+        std::cout << runtime.GetUsage() << std::endl;
         exit(0);
     }
 
@@ -124,24 +60,6 @@ int main(int argc, char *argv[])
     int blocksize = std::stoi(argv[4]);
     double isovalue = std::atof(argv[5]);
 
-#ifdef VTKM_CUDA
-
-    if (backend == "cuda")
-    {
-        char const *nblock = getenv("UCV_GPU_NUMBLOCK");
-        char const *nthread = getenv("UCV_GPU_BLOCKPERTHREAD");
-        if (nblock != NULL && nthread != NULL)
-        {
-            oneDBlocks = std::stoi(std::string(nblock));
-            threadsPerBlock = std::stoi(std::string(nthread));
-            // the input value for the init scheduled parameter is a function
-            vtkm::cont::cuda::InitScheduleParameters(mySchedParams);
-            std::cout << "cuda parameters: " << oneDBlocks << " " << threadsPerBlock << std::endl;
-        }
-    }
-
-#endif
-
     // load the dataset (beetles data set, structured one)
     // TODO, the data set can be distributed between different ranks
 
@@ -153,6 +71,16 @@ int main(int argc, char *argv[])
     // check the property of the data
     dataset.PrintSummary(std::cout);
 
+    // the reader fills the field on one thread, spread its pages over the NUMA nodes
+    // of the OpenMP threads before the memory bound subsampling (UCV_FIRST_TOUCH=0 to skip)
+    timer.Start();
+    bool placed = runtime.PlaceField(dataset, fieldName);
+    timer.Stop();
+    if (placed)
+    {
+        std::cout << "FirstTouchPlacement time: " << timer.GetElapsedTime() << std::endl;
+    }
+
     // Implementation note: it is typical when running a filter to store the results in
     // a new `DataSet`. However, we are using the same `DataSet` object over and over.
     // This is OK as C++ will properly manage the object and we won't need the data once
@@ -161,6 +89,18 @@ int main(int argc, char *argv[])
     // longer being used gets deleted. This has the desirable side effect of booting
     // data off of a device, which might be important if uniform memory is not being used.
 
+    // the crossing probability and position of each unique edge, UCV_EDGE_OUTPUT=1 (uni and ig)
+    char const *edgeOutput = getenv("UCV_EDGE_OUTPUT");
+    bool computeEdges = edgeOutput != nullptr && std::string(edgeOutput) != "0";
+    vtkm::cont::DataSet edgeDataset;
+
+    // the triangles of the most probable contour case of each cell, UCV_SURFACE_OUTPUT=1
+    char const *surfaceOutput = getenv("UCV_SURFACE_OUTPUT");
+    bool computeSurface = surfaceOutput != nullptr && std::string(surfaceOutput) != "0";
+    vtkm::filter::uncertainty::ContourUncertainGeometry surface;
+    surface.SetIsoValue(isovalue);
+    vtkm::cont::DataSet surfaceDataset;
+
     if (distribution == "uni")
     {
       // uniform
@@ -177,10 +117,42 @@ int main(int argc, char *argv[])
       contour.SetMaxField(fieldName + subsample.GetMaxSuffix());
       contour.SetIsoValue(isovalue);
 
+      // the point probabilities are stored with 8 bits, UCV_POINT_PROBABILITY_BITS=8
+      char const *pointProbBits = getenv("UCV_POINT_PROBABILITY_BITS");
+      contour.SetQuantizePointProbability(pointProbBits != nullptr && std::string(pointProbBits) == "8");
+
       timer.Start();
       dataset = contour.Execute(dataset);
       timer.Stop();
       std::cout << "EntropyUniformTime time: " << timer.GetElapsedTime() << std::endl;
+
+      if (computeEdges)
+      {
+        vtkm::filter::uncertainty::ContourUncertainEdges edges;
+        edges.SetDistribution(vtkm::filter::uncertainty::ContourUncertainEdges::DistributionType::Uniform);
+        edges.SetMinField(fieldName + subsample.GetMinSuffix());
+        edges.SetMaxField(fieldName + subsample.GetMaxSuffix());
+        edges.SetIsoValue(isovalue);
+
+        timer.Start();
+        edgeDataset = edges.Execute(dataset);
+        timer.Stop();
+        std::cout << "EdgeUniformTime time: " << timer.GetElapsedTime() << std::endl;
+      }
+
+      if (computeSurface)
+      {
+        surface.SetDistribution(vtkm::filter::uncertainty::ContourUncertainGeometry::DistributionType::Uniform);
+        surface.SetMinField(fieldName + subsample.GetMinSuffix());
+        surface.SetMaxField(fieldName + subsample.GetMaxSuffix());
+      }
+
+      // Per-stage records, enabled with UCV_INSTRUMENTATION=1
+      if (contour.GetInstrumentation().GetEnabled())
+      {
+        subsample.GetInstrumentation().WriteCSV(std::cout, "SubsampleUncertaintyUniform");
+        contour.GetInstrumentation().WriteCSV(std::cout, "ContourUncertainUniform", false);
+      }
     }
     else if (distribution == "ig")
     {
@@ -198,10 +170,42 @@ int main(int argc, char *argv[])
       contour.SetStdevField(fieldName + subsample.GetStdevSuffix());
       contour.SetIsoValue(isovalue);
 
+      // polynomial erf for the point probabilities, UCV_FAST_ERF=1
+      char const *fastErf = getenv("UCV_FAST_ERF");
+      contour.SetFastErf(fastErf != nullptr && std::string(fastErf) != "0");
+
       timer.Start();
       dataset = contour.Execute(dataset);
       timer.Stop();
       std::cout << "EIGaussianTime time: " << timer.GetElapsedTime() << std::endl;
+
+      if (computeEdges)
+      {
+        vtkm::filter::uncertainty::ContourUncertainEdges edges;
+        edges.SetDistribution(vtkm::filter::uncertainty::ContourUncertainEdges::DistributionType::IndependentGaussian);
+        edges.SetMeanField(fieldName + subsample.GetMeanSuffix());
+        edges.SetStdevField(fieldName + subsample.GetStdevSuffix());
+        edges.SetIsoValue(isovalue);
+
+        timer.Start();
+        edgeDataset = edges.Execute(dataset);
+        timer.Stop();
+        std::cout << "EdgeIGaussianTime time: " << timer.GetElapsedTime() << std::endl;
+      }
+
+      if (computeSurface)
+      {
+        surface.SetDistribution(vtkm::filter::uncertainty::ContourUncertainGeometry::DistributionType::IndependentGaussian);
+        surface.SetMeanField(fieldName + subsample.GetMeanSuffix());
+        surface.SetStdevField(fieldName + subsample.GetStdevSuffix());
+      }
+
+      // Per-stage records, enabled with UCV_INSTRUMENTATION=1
+      if (contour.GetInstrumentation().GetEnabled())
+      {
+        subsample.GetInstrumentation().WriteCSV(std::cout, "SubsampleUncertaintyIndependentGaussian");
+        contour.GetInstrumentation().WriteCSV(std::cout, "ContourUncertainIndependentGaussian", false);
+      }
     }
     else if (distribution == "mg")
     {
@@ -218,17 +222,171 @@ int main(int argc, char *argv[])
       contour.SetMeanField(fieldName + subsample.GetMeanSuffix());
       contour.SetEnsembleField(fieldName + subsample.GetEnsembleSuffix());
       contour.SetIsoValue(isovalue);
+      // the surface reuses the most probable case of the samples instead of sampling again
+      contour.SetComputeMostProbableCase(computeSurface);
 
       timer.Start();
       dataset = contour.Execute(dataset);
       timer.Stop();
       std::cout << "MVGTime time: " << timer.GetElapsedTime() << std::endl;
+
+      if (computeSurface)
+      {
+        surface.SetDistribution(vtkm::filter::uncertainty::ContourUncertainGeometry::DistributionType::MultivariateGaussian);
+        surface.SetMeanField(fieldName + subsample.GetMeanSuffix());
+        surface.SetMostProbableCaseFields(contour.GetMostProbableCaseName(), contour.GetMostProbableCaseProbabilityName());
+      }
+
+      // Per-stage records, enabled with UCV_INSTRUMENTATION=1
+      if (contour.GetInstrumentation().GetEnabled())
+      {
+        subsample.GetInstrumentation().WriteCSV(std::cout, "SubsampleUncertaintyEnsemble");
+        contour.GetInstrumentation().WriteCSV(std::cout, "ContourUncertainEnsemble", false);
+      }
+    }
+    else if (distribution == "hist")
+    {
+      // histogram of each block, UCV_HISTOGRAM_BINS=8, 16 (default) or 32 bins
+      vtkm::filter::uncertainty::SubsampleUncertaintyHistogram subsample;
+      subsample.SetBlockSize(blocksize);
+      char const *histogramBins = getenv("UCV_HISTOGRAM_BINS");
+      if (histogramBins != nullptr)
+      {
+        subsample.SetNumberOfBins(std::stoi(std::string(histogramBins)));
+      }
+
+      timer.Start();
+      dataset = subsample.Execute(dataset);
+      timer.Stop();
+      std::cout << "ExtractingHistogram time: " << timer.GetElapsedTime() << std::endl;
+
+      vtkm::filter::uncertainty::ContourUncertainHistogram contour;
+      contour.SetMinField(fieldName + subsample.GetMinSuffix());
+      contour.SetMaxField(fieldName + subsample.GetMaxSuffix());
+      contour.SetHistogramField(fieldName + subsample.GetHistogramSuffix());
+      contour.SetIsoValue(isovalue);
+
+      timer.Start();
+      dataset = contour.Execute(dataset);
+      timer.Stop();
+      std::cout << "HistogramTime time: " << timer.GetElapsedTime() << std::endl;
+
+      // the surface is not computed for the histogram model
+      computeSurface = false;
+
+      // Per-stage records, enabled with UCV_INSTRUMENTATION=1
+      if (contour.GetInstrumentation().GetEnabled())
+      {
+        subsample.GetInstrumentation().WriteCSV(std::cout, "SubsampleUncertaintyHistogram");
+        contour.GetInstrumentation().WriteCSV(std::cout, "ContourUncertainHistogram", false);
+      }
+    }
+    else if (distribution == "gmm")
+    {
+      // gaussian mixture of each block, UCV_GMM_COMPONENTS=2 (default), 3 or 4 gaussians
+      vtkm::filter::uncertainty::SubsampleUncertaintyMixture subsample;
+      subsample.SetBlockSize(blocksize);
+      char const *gmmComponents = getenv("UCV_GMM_COMPONENTS");
+      if (gmmComponents != nullptr)
+      {
+        subsample.SetNumberOfComponents(std::stoi(std::string(gmmComponents)));
+      }
+
+      timer.Start();
+      dataset = subsample.Execute(dataset);
+      timer.Stop();
+      std::cout << "ExtractingMixture time: " << timer.GetElapsedTime() << std::endl;
+
+      vtkm::filter::uncertainty::ContourUncertainMixture contour;
+      contour.SetMixtureField(fieldName + subsample.GetMixtureSuffix());
+      contour.SetIsoValue(isovalue);
+
+      timer.Start();
+      dataset = contour.Execute(dataset);
+      timer.Stop();
+      std::cout << "MixtureTime time: " << timer.GetElapsedTime() << std::endl;
+
+      // the surface is not computed for the mixture model
+      computeSurface = false;
+
+      // Per-stage records, enabled with UCV_INSTRUMENTATION=1
+      if (contour.GetInstrumentation().GetEnabled())
+      {
+        subsample.GetInstrumentation().WriteCSV(std::cout, "SubsampleUncertaintyMixture");
+        contour.GetInstrumentation().WriteCSV(std::cout, "ContourUncertainMixture", false);
+      }
+    }
+    else if (distribution == "sg")
+    {
+      // gaussian with the correlation of the neighboring points (separable covariance)
+      vtkm::filter::uncertainty::SubsampleUncertaintyIndependentGaussian subsample;
+      subsample.SetBlockSize(blocksize);
+      subsample.SetComputeCorrelation(true);
+
+      timer.Start();
+      dataset = subsample.Execute(dataset);
+      timer.Stop();
+      std::cout << "ExtractingMeanStdevCorrelation time: " << timer.GetElapsedTime() << std::endl;
+
+      vtkm::filter::uncertainty::ContourUncertainSeparableGaussian contour;
+      contour.SetMeanField(fieldName + subsample.GetMeanSuffix());
+      contour.SetStdevField(fieldName + subsample.GetStdevSuffix());
+      contour.SetCorrelationField(fieldName + subsample.GetCorrelationSuffix());
+      contour.SetIsoValue(isovalue);
+
+      timer.Start();
+      dataset = contour.Execute(dataset);
+      timer.Stop();
+      std::cout << "SeparableGaussianTime time: " << timer.GetElapsedTime() << std::endl;
+
+      // the surface is not computed for the separable gaussian model
+      computeSurface = false;
+
+      // Per-stage records, enabled with UCV_INSTRUMENTATION=1
+      if (contour.GetInstrumentation().GetEnabled())
+      {
+        subsample.GetInstrumentation().WriteCSV(std::cout, "SubsampleUncertaintyIndependentGaussian");
+        contour.GetInstrumentation().WriteCSV(std::cout, "ContourUncertainSeparableGaussian", false);
+      }
     }
     else
     {
         throw std::runtime_error("unsupported distribution: " + distribution);
     }
 
+    if (computeSurface)
+    {
+        timer.Start();
+        surfaceDataset = surface.Execute(dataset);
+        timer.Stop();
+        std::cout << "SurfaceTime time: " << timer.GetElapsedTime() << " triangles: " << surfaceDataset.GetNumberOfCells() << std::endl;
+    }
+
+    // only keep the cells that may contain the contour, UCV_SPARSE_OUTPUT=1
+    char const *sparseOutput = getenv("UCV_SPARSE_OUTPUT");
+    if (sparseOutput != nullptr && std::string(sparseOutput) != "0")
+    {
+        vtkm::filter::uncertainty::SparseUncertainContour sparse;
+
+        timer.Start();
+        dataset = sparse.Execute(dataset);
+        timer.Stop();
+        std::cout << "SparseOutput time: " << timer.GetElapsedTime() << " cells: " << dataset.GetNumberOfCells() << std::endl;
+    }
+
+    // encode the output with 8 or 16 bits to make the file smaller, UCV_OUTPUT_BITS=8 or 16
+    char const *outputBits = getenv("UCV_OUTPUT_BITS");
+    vtkm::filter::uncertainty::QuantizeUncertainContour quantize;
+    if (outputBits != nullptr)
+    {
+        quantize.SetNumberOfBits(std::stoi(std::string(outputBits)));
+
+        timer.Start();
+        dataset = quantize.Execute(dataset);
+        timer.Stop();
+        std::cout << "Quantize time: " << timer.GetElapsedTime() << std::endl;
+    }
+
     // dataset.PrintSummary(std::cout);
     std::stringstream stream;
     stream << std::fixed << std::setprecision(2) << isovalue;
@@ -240,6 +398,27 @@ int main(int argc, char *argv[])
     vtkm::io::VTKDataSetWriter write(outputFileName);
     write.SetFileTypeToBinary();
     write.WriteDataSet(dataset);
+    if (outputBits != nullptr)
+    {
+        // the legacy vtk files do not keep the scale and the offset of the codes
+        quantize.WriteEncoding(outputFileName.substr(0, outputFileName.size() - 4) + "_encoding.json");
+    }
+
+    if (edgeDataset.GetNumberOfCells() > 0)
+    {
+        std::string edgeFileName = fileSuffix + "_iso" + isostr + "_" + distribution + "_block" + std::to_string(blocksize) + std::string("_Edges.vtk");
+        vtkm::io::VTKDataSetWriter edgeWrite(edgeFileName);
+        edgeWrite.SetFileTypeToBinary();
+        edgeWrite.WriteDataSet(edgeDataset);
+    }
+
+    if (computeSurface)
+    {
+        std::string surfaceFileName = fileSuffix + "_iso" + isostr + "_" + distribution + "_block" + std::to_string(blocksize) + std::string("_Surface.vtk");
+        vtkm::io::VTKDataSetWriter surfaceWrite(surfaceFileName);
+        surfaceWrite.SetFileTypeToBinary();
+        surfaceWrite.WriteDataSet(surfaceDataset);
+    }
 
     return 0;
 }
@@ -17,67 +17,7 @@
 
 #include "ucvworklet/EntropyUniform.hpp"
 #include "ucvworklet/EntropyIndependentGaussian.hpp"
-
-int oneDBlocks = 128;
-int threadsPerBlock = 128;
-#ifdef VTKM_CUDA
-vtkm::cont::cuda::ScheduleParameters
-mySchedParams(char const *name,
-              int major,
-              int minor,
-              int multiProcessorCount,
-              int maxThreadsPerMultiProcessor,
-              int maxThreadsPerBlock)
-{
-    vtkm::cont::cuda::ScheduleParameters p;
-    p.one_d_blocks = oneDBlocks;
-    p.one_d_threads_per_block = threadsPerBlock;
-
-    return p;
-}
-#endif
-
-void initBackend()
-{
-    // init the vtkh device
-    char const *tmp = getenv("UCV_VTKM_BACKEND");
-    std::string backend;
-    if (tmp == nullptr)
-    {
-        std::cout << "no UCV_VTKM_BACKEND env, use openmp" << std::endl;
-        backend = "openmp";
-    }
-    else
-    {
-        backend = std::string(tmp);
-    }
-
-    // if (rank == 0)
-    //{
-    std::cout << "vtkm backend is:" << backend << std::endl;
-    //}
-
-    if (backend == "serial")
-    {
-        vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-        device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagSerial());
-    }
-    else if (backend == "openmp")
-    {
-        vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-        device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagOpenMP());
-    }
-    else if (backend == "cuda")
-    {
-        vtkm::cont::RuntimeDeviceTracker &device_tracker = vtkm::cont::GetRuntimeDeviceTracker();
-        device_tracker.ForceDevice(vtkm::cont::DeviceAdapterTagCuda());
-    }
-    else
-    {
-        std::cerr << " unrecognized backend " << backend << std::endl;
-    }
-    return;
-}
+#include "UncertaintyRuntime.h"
 
 using SupportedTypes = vtkm::List<vtkm::Float32,
                                   vtkm::Float64,
@@ -91,9 +31,9 @@ using SupportedTypes = vtkm::List<vtkm::Float32,
 
 int main(int argc, char *argv[])
 {
-    initBackend();
-    // init the vtkm (set the backend and log level here)
-    vtkm::cont::Initialize(argc, argv);
+    // init the vtkm (set the backend, threads and log level here)
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+    runtime.PrintSummary(std::cout);
 
     if (argc != 5)
     {
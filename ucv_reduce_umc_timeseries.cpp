@@ -0,0 +1,314 @@
+#include <vtkm/cont/Initialize.h>
+#include <vtkm/io/VTKDataSetReader.h>
+#include <vtkm/io/VTKDataSetWriter.h>
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/Timer.h>
+
+#include "ContourUncertainEnsemble.h"
+#include "ContourUncertainIndependentGaussian.h"
+#include "ContourUncertainUniform.h"
+#include "EnsembleAccumulator.h"
+#include "QuantizeUncertainContour.h"
+#include "SubsampleUncertaintyEnsemble.h"
+#include "SubsampleUncertaintyIndependentGaussian.h"
+#include "SubsampleUncertaintyUniform.h"
+#include "UncertaintyRuntime.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+
+using SupportedTypes = vtkm::List<vtkm::Float32,
+                                  vtkm::Float64,
+                                  vtkm::Int8,
+                                  vtkm::UInt8,
+                                  vtkm::Int16,
+                                  vtkm::UInt16,
+                                  vtkm::Int32,
+                                  vtkm::UInt32,
+                                  vtkm::Id>;
+
+// the time steps are either listed in a text file (one file name per line)
+// or given by a printf style pattern such as data_%04d.vtk and a range
+std::vector<std::string> getTimeStepFiles(const std::string &input, int first, int last)
+{
+    std::vector<std::string> files;
+    if (first < 0)
+    {
+        std::ifstream fin(input.c_str());
+        if (!fin.is_open())
+        {
+            throw std::runtime_error("failed to open the time step list: " + input);
+        }
+        std::string line;
+        while (std::getline(fin, line))
+        {
+            if (!line.empty())
+            {
+                files.push_back(line);
+            }
+        }
+        return files;
+    }
+
+    for (int step = first; step <= last; step++)
+    {
+        std::vector<char> buffer(input.size() + 64);
+        std::snprintf(buffer.data(), buffer.size(), input.c_str(), step);
+        files.push_back(std::string(buffer.data()));
+    }
+    return files;
+}
+
+std::string getFileName(const std::string &path)
+{
+    std::size_t pos = path.find_last_of("/");
+    if (pos == std::string::npos)
+    {
+        return path;
+    }
+    return path.substr(pos + 1);
+}
+
+// write the collection of the outputs so the time series can be opened at once
+// the .vtk.series is the file series format that paraview uses for the legacy vtk files
+// (a .pvd collection can only list the xml files)
+void writeCollection(const std::string &prefix, const std::vector<std::string> &outputFiles)
+{
+    std::ofstream series(prefix + ".vtk.series");
+    series << "{\n  \"file-series-version\" : \"1.0\",\n  \"files\" : [\n";
+    for (std::size_t i = 0; i < outputFiles.size(); i++)
+    {
+        series << "    { \"name\" : \"" << getFileName(outputFiles[i]) << "\", \"time\" : " << i << " }";
+        series << ((i + 1 < outputFiles.size()) ? ",\n" : "\n");
+    }
+    series << "  ]\n}\n";
+}
+
+// the point dimensions of a structured grid, or only the number of points (with the
+// other dimensions set to 0) for the other cell sets
+vtkm::Id3 getPointDimensions(const vtkm::cont::UnknownCellSet &cellSet)
+{
+    if (cellSet.IsType<vtkm::cont::CellSetStructured<3>>())
+    {
+        return cellSet.AsCellSet<vtkm::cont::CellSetStructured<3>>().GetPointDimensions();
+    }
+    if (cellSet.IsType<vtkm::cont::CellSetStructured<2>>())
+    {
+        vtkm::Id2 dims = cellSet.AsCellSet<vtkm::cont::CellSetStructured<2>>().GetPointDimensions();
+        return vtkm::Id3(dims[0], dims[1], 1);
+    }
+    return vtkm::Id3(cellSet.GetNumberOfPoints(), 0, 0);
+}
+
+int main(int argc, char *argv[])
+{
+
+    // init the vtkm (set the backend, threads and log level here)
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+    vtkm::cont::Timer timer{ runtime.GetDevice() };
+    runtime.PrintSummary(std::cout);
+
+    if (argc != 7 && argc != 9)
+    {
+        std::cout << "executable [VTK-m options] <timesteps> <fieldname> <distribution> <blocksize> <isovalue> <outputprefix> [<first> <last>]" << std::endl;
+        std::cout << "<timesteps> is a text file listing one file per time step, or a printf pattern such as data_%04d.vtk when <first> <last> are given" << std::endl;
+        std::cout << "VTK-m options are:\n";
+        std::cout << runtime.GetUsage() << std::endl;
+        exit(0);
+    }
+
+    std::string timeStepInput = argv[1];
+    std::string fieldName = argv[2];
+    std::string distribution = argv[3];
+    int blocksize = std::stoi(argv[4]);
+    double isovalue = std::atof(argv[5]);
+    std::string outputPrefix = argv[6];
+    int firstStep = -1;
+    int lastStep = -1;
+    if (argc == 9)
+    {
+        firstStep = std::stoi(argv[7]);
+        lastStep = std::stoi(argv[8]);
+    }
+
+    if (distribution != "uni" && distribution != "ig" && distribution != "mg" && distribution != "members")
+    {
+        throw std::runtime_error("unsupported distribution: " + distribution);
+    }
+
+    std::vector<std::string> timeStepFiles = getTimeStepFiles(timeStepInput, firstStep, lastStep);
+    std::cout << "number of time steps: " << timeStepFiles.size() << std::endl;
+
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(2) << isovalue;
+    std::string isostr = stream.str();
+
+    // The filters are created once and reused for every time step. The subsample filters
+    // keep the keys (and the sorting permutation inside them) between executions, so only
+    // the first time step pays for building them.
+    vtkm::filter::uncertainty::SubsampleUncertaintyUniform subsampleUniform;
+    vtkm::filter::uncertainty::ContourUncertainUniform contourUniform;
+    subsampleUniform.SetBlockSize(blocksize);
+    contourUniform.SetMinField(fieldName + subsampleUniform.GetMinSuffix());
+    contourUniform.SetMaxField(fieldName + subsampleUniform.GetMaxSuffix());
+    contourUniform.SetIsoValue(isovalue);
+
+    vtkm::filter::uncertainty::SubsampleUncertaintyIndependentGaussian subsampleGaussian;
+    vtkm::filter::uncertainty::ContourUncertainIndependentGaussian contourGaussian;
+    subsampleGaussian.SetBlockSize(blocksize);
+    contourGaussian.SetMeanField(fieldName + subsampleGaussian.GetMeanSuffix());
+    contourGaussian.SetStdevField(fieldName + subsampleGaussian.GetStdevSuffix());
+    contourGaussian.SetIsoValue(isovalue);
+
+    vtkm::filter::uncertainty::SubsampleUncertaintyEnsemble subsampleEnsemble;
+    vtkm::filter::uncertainty::ContourUncertainEnsemble contourEnsemble;
+    subsampleEnsemble.SetBlockSize(blocksize);
+    contourEnsemble.SetMeanField(fieldName + subsampleEnsemble.GetMeanSuffix());
+    contourEnsemble.SetEnsembleField(fieldName + subsampleEnsemble.GetEnsembleSuffix());
+    contourEnsemble.SetIsoValue(isovalue);
+
+    // the time steps are the members of an ensemble, the statistics of each point of the full
+    // grid are updated in place and the output of a step uses all the members read so far
+    vtkm::filter::uncertainty::EnsembleAccumulator accumulator;
+    vtkm::filter::uncertainty::ContourUncertainIndependentGaussian contourMembers;
+    contourMembers.SetMeanField(fieldName + accumulator.GetMeanSuffix());
+    contourMembers.SetStdevField(fieldName + accumulator.GetStdevSuffix());
+    contourMembers.SetIsoValue(isovalue);
+
+    // encode the output with 8 or 16 bits to make the files smaller, UCV_OUTPUT_BITS=8 or 16
+    char const *outputBits = getenv("UCV_OUTPUT_BITS");
+    vtkm::filter::uncertainty::QuantizeUncertainContour quantize;
+    if (outputBits != nullptr)
+    {
+        quantize.SetNumberOfBits(std::stoi(std::string(outputBits)));
+    }
+
+    // the grid of the first time step, the following time steps only contribute the field
+    vtkm::cont::UnknownCellSet cachedCellSet;
+    vtkm::cont::CoordinateSystem cachedCoordinates;
+    vtkm::Bounds cachedBounds;
+
+    // the members mode works on the full grid, the block size is not part of its name
+    std::string runName = outputPrefix + "_iso" + isostr + "_" + distribution;
+    if (distribution != "members")
+    {
+        runName = runName + "_block" + std::to_string(blocksize);
+    }
+
+    std::vector<std::string> outputFiles;
+    for (std::size_t step = 0; step < timeStepFiles.size(); step++)
+    {
+        std::cout << "time step " << step << " fileName: " << timeStepFiles[step] << std::endl;
+        // the legacy reader can not read one field, so every step is still parsed completely,
+        // only the field is kept and the cached grid is used instead of the one read
+        vtkm::io::VTKDataSetReader reader(timeStepFiles[step]);
+        vtkm::cont::DataSet stepData = reader.ReadDataSet();
+
+        vtkm::cont::DataSet dataset;
+        if (step == 0)
+        {
+            cachedCellSet = stepData.GetCellSet();
+            cachedCoordinates = stepData.GetCoordinateSystem();
+            cachedBounds = cachedCoordinates.GetBounds();
+        }
+        else if (getPointDimensions(stepData.GetCellSet()) != getPointDimensions(cachedCellSet) ||
+                 stepData.GetCoordinateSystem().GetBounds() != cachedBounds)
+        {
+            throw std::runtime_error("the grid changes at time step: " + timeStepFiles[step]);
+        }
+        dataset.SetCellSet(cachedCellSet);
+        dataset.AddCoordinateSystem(cachedCoordinates);
+        dataset.AddPointField(fieldName, stepData.GetField(fieldName).GetData());
+
+        // the reader fills the field on one thread, spread its pages over the NUMA nodes
+        // of the OpenMP threads (UCV_FIRST_TOUCH=0 to skip)
+        runtime.PlaceField(dataset, fieldName);
+
+        double subsampleTime = 0;
+        double contourTime = 0;
+        if (distribution == "uni")
+        {
+            timer.Start();
+            dataset = subsampleUniform.Execute(dataset);
+            timer.Stop();
+            subsampleTime = timer.GetElapsedTime();
+
+            timer.Start();
+            dataset = contourUniform.Execute(dataset);
+            timer.Stop();
+            contourTime = timer.GetElapsedTime();
+        }
+        else if (distribution == "ig")
+        {
+            timer.Start();
+            dataset = subsampleGaussian.Execute(dataset);
+            timer.Stop();
+            subsampleTime = timer.GetElapsedTime();
+
+            timer.Start();
+            dataset = contourGaussian.Execute(dataset);
+            timer.Stop();
+            contourTime = timer.GetElapsedTime();
+        }
+        else if (distribution == "members")
+        {
+            timer.Start();
+            accumulator.AddMember(dataset, fieldName);
+            accumulator.AddFields(dataset, fieldName);
+            timer.Stop();
+            subsampleTime = timer.GetElapsedTime();
+
+            // the stdev of one member is 0 everywhere, there is nothing to contour yet
+            if (accumulator.GetNumberOfMembers() < 2)
+            {
+                std::cout << "time step " << step << " is the first member, the contour starts from the second member" << std::endl;
+                continue;
+            }
+
+            timer.Start();
+            dataset = contourMembers.Execute(dataset);
+            timer.Stop();
+            contourTime = timer.GetElapsedTime();
+        }
+        else
+        {
+            timer.Start();
+            dataset = subsampleEnsemble.Execute(dataset);
+            timer.Stop();
+            subsampleTime = timer.GetElapsedTime();
+
+            timer.Start();
+            dataset = contourEnsemble.Execute(dataset);
+            timer.Stop();
+            contourTime = timer.GetElapsedTime();
+        }
+        std::cout << "time step " << step << " subsample time: " << subsampleTime << " contour time: " << contourTime << std::endl;
+
+        if (outputBits != nullptr)
+        {
+            dataset = quantize.Execute(dataset);
+        }
+
+        std::string outputFileName = runName + "_step" + std::to_string(step) + std::string("_Prob.vtk");
+        vtkm::io::VTKDataSetWriter write(outputFileName);
+        write.SetFileTypeToBinary();
+        write.WriteDataSet(dataset);
+        outputFiles.push_back(outputFileName);
+    }
+
+    writeCollection(runName, outputFiles);
+    if (outputBits != nullptr)
+    {
+        // the encoding is the same for all the time steps, the legacy vtk files do not keep it
+        quantize.WriteEncoding(runName + "_encoding.json");
+    }
+
+    return 0;
+}
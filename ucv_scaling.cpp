@@ -0,0 +1,661 @@
+#include <vtkm/cont/Initialize.h>
+#include <vtkm/io/VTKDataSetReader.h>
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleView.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/Timer.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include "ContourUncertainEnsemble.h"
+#include "ContourUncertainIndependentGaussian.h"
+#include "ContourUncertainUniform.h"
+#include "SubsampleUncertaintyEnsemble.h"
+#include "SubsampleUncertaintyIndependentGaussian.h"
+#include "SubsampleUncertaintyUniform.h"
+#include "UncertaintyRuntime.h"
+#include "ucv_command_line.h"
+
+#include <mpi.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// thread and rank scaling study on a single node
+// the driver runs itself once for each configuration of the sweep (with OMP_NUM_THREADS
+// set and, for more than one rank, through the mpi launcher), each run prints one result
+// line with the max time over the ranks of the pipeline and of each instrumented stage,
+// and the driver writes a json report with the speedup and the parallel efficiency
+//
+// the domain is split into slabs along z between the ranks, the slabs start on a block
+// boundary so the subsampling of each rank is the same as the one of the whole domain
+// (the cells between two reduced slabs are not computed), strong scaling keeps the
+// global size fixed and weak scaling keeps the size of each slab fixed
+
+const std::string RESULT_PREFIX = "UCV_SCALING_RESULT";
+
+// smooth field plus hashed noise computed from the global index,
+// so every rank and every thread count generates the same values
+struct GenerateSyntheticSlab : public vtkm::worklet::WorkletMapField
+{
+    GenerateSyntheticSlab(vtkm::Id3 globalDims, vtkm::Id zOffset, vtkm::Float64 noise)
+        : m_globalDims(globalDims), m_zOffset(zOffset), m_noise(noise){};
+
+    using ControlSignature = void(FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2);
+
+    VTKM_EXEC void operator()(const vtkm::Id &localIndex, vtkm::FloatDefault &value) const
+    {
+        vtkm::Id sliceSize = m_globalDims[0] * m_globalDims[1];
+        vtkm::Id x = localIndex % m_globalDims[0];
+        vtkm::Id y = (localIndex / m_globalDims[0]) % m_globalDims[1];
+        vtkm::Id z = localIndex / sliceSize + m_zOffset;
+
+        const vtkm::Float64 twoPi = 2.0 * vtkm::Pi();
+        vtkm::Float64 fx = vtkm::Sin(twoPi * 3.0 * x / m_globalDims[0]);
+        vtkm::Float64 fy = vtkm::Cos(twoPi * 2.0 * y / m_globalDims[1]);
+        vtkm::Float64 fz = vtkm::Sin(twoPi * 1.0 * z / m_globalDims[2]);
+
+        // splitmix64 of the global index, mapped to [-1, 1)
+        vtkm::UInt64 h = static_cast<vtkm::UInt64>(x + y * m_globalDims[0] + z * sliceSize) + 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        h = h ^ (h >> 31);
+        vtkm::Float64 noise = static_cast<vtkm::Float64>(h >> 11) / 4503599627370496.0 - 1.0;
+
+        value = static_cast<vtkm::FloatDefault>(fx * fy + 0.5 * fz + m_noise * noise);
+    }
+
+private:
+    vtkm::Id3 m_globalDims;
+    vtkm::Id m_zOffset;
+    vtkm::Float64 m_noise;
+};
+
+struct ScalingOptions
+{
+    std::vector<int> threads{1, 2, 4};
+    std::vector<int> ranks{1};
+    std::string mode = "strong";
+    vtkm::Id3 dims{128, 128, 128};
+    std::string input;
+    std::string fieldName = "synthetic";
+    std::string distribution = "ig";
+    int blocksize = 4;
+    double isovalue = 0.0;
+    double noise = 0.1;
+    int numSamples = 1000;
+    int repetitions = 3;
+    std::string device;
+    std::string launcher = "mpirun -np";
+    std::string output;
+};
+
+ScalingOptions options;
+
+// the slab of points of this rank, it starts and ends on a block boundary
+vtkm::Id2 slabRange(vtkm::Id globalZ, int rank, int numRanks)
+{
+    vtkm::Id numLayers = (globalZ + options.blocksize - 1) / options.blocksize;
+    vtkm::Id begin = (numLayers * rank) / numRanks * options.blocksize;
+    vtkm::Id end = std::min((numLayers * (rank + 1)) / numRanks * options.blocksize, globalZ);
+    return vtkm::Id2(begin, end);
+}
+
+vtkm::cont::DataSet loadSlab(int rank, int numRanks)
+{
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> globalField;
+    vtkm::Id3 globalDims = options.dims;
+    if (options.input.empty() && options.mode == "weak")
+    {
+        globalDims[2] = options.dims[2] * numRanks;
+    }
+
+    if (!options.input.empty())
+    {
+        vtkm::io::VTKDataSetReader reader(options.input);
+        vtkm::cont::DataSet dataset = reader.ReadDataSet();
+        vtkm::cont::CellSetStructured<3> cellSet;
+        dataset.GetCellSet().AsCellSet(cellSet);
+        globalDims = cellSet.GetPointDimensions();
+        vtkm::cont::ArrayCopyShallowIfPossible(dataset.GetField(options.fieldName).GetData(), globalField);
+    }
+
+    vtkm::Id2 range = slabRange(globalDims[2], rank, numRanks);
+    vtkm::Id3 slabDims(globalDims[0], globalDims[1], range[1] - range[0]);
+    if (slabDims[2] < 2)
+    {
+        throw std::runtime_error("the slab of rank " + std::to_string(rank) + " is too thin, use fewer ranks or a larger z");
+    }
+    vtkm::Id sliceSize = globalDims[0] * globalDims[1];
+    vtkm::Id numPoints = slabDims[0] * slabDims[1] * slabDims[2];
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> field;
+    if (!options.input.empty())
+    {
+        // the points of a z slab are contiguous since x varies fastest
+        vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleView(globalField, range[0] * sliceSize, numPoints), field);
+    }
+    else
+    {
+        vtkm::cont::Invoker invoke;
+        invoke(GenerateSyntheticSlab{globalDims, range[0], options.noise}, vtkm::cont::ArrayHandleIndex(numPoints), field);
+    }
+
+    vtkm::cont::DataSet slab = vtkm::cont::DataSetBuilderUniform::Create(slabDims);
+    slab.AddPointField(options.fieldName, field);
+    return slab;
+}
+
+void addStages(const vtkm::filter::uncertainty::FilterInstrumentation &instrumentation,
+               const std::string &prefix,
+               std::vector<std::string> &names,
+               std::vector<double> &times)
+{
+    for (const auto &stage : instrumentation.GetStages())
+    {
+        names.push_back(prefix + stage.Name);
+        times.push_back(stage.Seconds);
+    }
+}
+
+// runs the pipeline on the slab and returns (as the last values) the subsample,
+// contour and total time, the stage times of the filters come first, the timer
+// synchronizes with the device selected by the runtime
+std::vector<double> runPipeline(const vtkm::cont::DataSet &slab,
+                                vtkm::cont::DeviceAdapterId device,
+                                std::vector<std::string> &names)
+{
+    vtkm::cont::Timer timer{device};
+    std::vector<double> times;
+    double subsampleTime = 0;
+    double contourTime = 0;
+    vtkm::cont::DataSet dataset;
+
+    if (options.distribution == "uni")
+    {
+        vtkm::filter::uncertainty::SubsampleUncertaintyUniform subsample;
+        subsample.SetBlockSize(options.blocksize);
+        subsample.GetInstrumentation().SetEnabled(true);
+        timer.Start();
+        dataset = subsample.Execute(slab);
+        timer.Stop();
+        subsampleTime = timer.GetElapsedTime();
+
+        vtkm::filter::uncertainty::ContourUncertainUniform contour;
+        contour.SetMinField(options.fieldName + subsample.GetMinSuffix());
+        contour.SetMaxField(options.fieldName + subsample.GetMaxSuffix());
+        contour.SetIsoValue(options.isovalue);
+        contour.GetInstrumentation().SetEnabled(true);
+        timer.Start();
+        dataset = contour.Execute(dataset);
+        timer.Stop();
+        contourTime = timer.GetElapsedTime();
+
+        addStages(subsample.GetInstrumentation(), "subsample.", names, times);
+        addStages(contour.GetInstrumentation(), "contour.", names, times);
+    }
+    else if (options.distribution == "ig")
+    {
+        vtkm::filter::uncertainty::SubsampleUncertaintyIndependentGaussian subsample;
+        subsample.SetBlockSize(options.blocksize);
+        subsample.GetInstrumentation().SetEnabled(true);
+        timer.Start();
+        dataset = subsample.Execute(slab);
+        timer.Stop();
+        subsampleTime = timer.GetElapsedTime();
+
+        vtkm::filter::uncertainty::ContourUncertainIndependentGaussian contour;
+        contour.SetMeanField(options.fieldName + subsample.GetMeanSuffix());
+        contour.SetStdevField(options.fieldName + subsample.GetStdevSuffix());
+        contour.SetIsoValue(options.isovalue);
+        contour.GetInstrumentation().SetEnabled(true);
+        timer.Start();
+        dataset = contour.Execute(dataset);
+        timer.Stop();
+        contourTime = timer.GetElapsedTime();
+
+        addStages(subsample.GetInstrumentation(), "subsample.", names, times);
+        addStages(contour.GetInstrumentation(), "contour.", names, times);
+    }
+    else
+    {
+        vtkm::filter::uncertainty::SubsampleUncertaintyEnsemble subsample;
+        subsample.SetBlockSize(options.blocksize);
+        subsample.GetInstrumentation().SetEnabled(true);
+        timer.Start();
+        dataset = subsample.Execute(slab);
+        timer.Stop();
+        subsampleTime = timer.GetElapsedTime();
+
+        vtkm::filter::uncertainty::ContourUncertainEnsemble contour;
+        contour.SetMeanField(options.fieldName + subsample.GetMeanSuffix());
+        contour.SetEnsembleField(options.fieldName + subsample.GetEnsembleSuffix());
+        contour.SetIsoValue(options.isovalue);
+        contour.SetNumberOfSamples(options.numSamples);
+        contour.GetInstrumentation().SetEnabled(true);
+        timer.Start();
+        dataset = contour.Execute(dataset);
+        timer.Stop();
+        contourTime = timer.GetElapsedTime();
+
+        addStages(subsample.GetInstrumentation(), "subsample.", names, times);
+        addStages(contour.GetInstrumentation(), "contour.", names, times);
+    }
+
+    names.push_back("subsample");
+    times.push_back(subsampleTime);
+    names.push_back("contour");
+    times.push_back(contourTime);
+    names.push_back("total");
+    times.push_back(subsampleTime + contourTime);
+    return times;
+}
+
+// one configuration of the sweep, started by the driver
+int runWorker(int rank, int numRanks, vtkm::cont::DeviceAdapterId device)
+{
+    vtkm::cont::DataSet slab = loadSlab(rank, numRanks);
+
+    // warm up, this also moves the slab to the device
+    std::vector<std::string> names;
+    runPipeline(slab, device, names);
+
+    // the best time of the repetitions
+    std::vector<double> best;
+    for (int rep = 0; rep < options.repetitions; rep++)
+    {
+        names.clear();
+        std::vector<double> times = runPipeline(slab, device, names);
+        if (best.empty())
+        {
+            best = times;
+        }
+        for (std::size_t i = 0; i < times.size(); i++)
+        {
+            best[i] = std::min(best[i], times[i]);
+        }
+    }
+
+    // a configuration is as slow as its slowest rank,
+    // all the ranks run the same pipeline so they have the same stages
+    std::vector<double> slowest(best.size());
+    MPI_Reduce(best.data(), slowest.data(), static_cast<int>(best.size()), MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank == 0)
+    {
+        std::cout << RESULT_PREFIX;
+        for (std::size_t i = 0; i < names.size(); i++)
+        {
+            std::cout << " " << names[i] << "=" << slowest[i];
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
+
+struct RunResult
+{
+    int threads;
+    int ranks;
+    std::map<std::string, double> times;
+    std::vector<std::string> stageNames;
+};
+
+std::string shellQuote(const std::string &value)
+{
+    std::string quoted = "'";
+    for (char c : value)
+    {
+        if (c == '\'')
+        {
+            quoted += "'\\''";
+        }
+        else
+        {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
+
+std::string workerArguments()
+{
+    std::stringstream ss;
+    ss << " --worker"
+       << " --mode=" << options.mode
+       << " --dims=" << options.dims[0] << "," << options.dims[1] << "," << options.dims[2]
+       << " --field=" << shellQuote(options.fieldName)
+       << " --distribution=" << options.distribution
+       << " --blocksize=" << options.blocksize
+       << " --isovalue=" << options.isovalue
+       << " --noise=" << options.noise
+       << " --samples=" << options.numSamples
+       << " --repetitions=" << options.repetitions;
+    if (!options.input.empty())
+    {
+        ss << " --input=" << shellQuote(options.input);
+    }
+    if (!options.device.empty())
+    {
+        ss << " --vtkm-device=" << options.device;
+    }
+    return ss.str();
+}
+
+bool runConfiguration(const std::string &executable, int threads, int ranks, RunResult &result)
+{
+    std::string command = "OMP_NUM_THREADS=" + std::to_string(threads) + " ";
+    if (ranks > 1)
+    {
+        command += options.launcher + " " + std::to_string(ranks) + " ";
+    }
+    command += shellQuote(executable) + workerArguments() + " 2>&1";
+    std::cerr << "run: " << command << std::endl;
+
+    FILE *pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr)
+    {
+        return false;
+    }
+
+    bool found = false;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+    {
+        std::string line(buffer);
+        if (line.compare(0, RESULT_PREFIX.size(), RESULT_PREFIX) != 0)
+        {
+            continue;
+        }
+        found = true;
+        std::stringstream ss(line.substr(RESULT_PREFIX.size()));
+        std::string item;
+        while (ss >> item)
+        {
+            std::string name = item.substr(0, item.find('='));
+            result.times[name] = std::stod(item.substr(item.find('=') + 1));
+            if (name != "subsample" && name != "contour" && name != "total")
+            {
+                result.stageNames.push_back(name);
+            }
+        }
+    }
+    int status = pclose(pipe);
+    result.threads = threads;
+    result.ranks = ranks;
+    return found && status == 0;
+}
+
+void writeJson(std::ostream &out, const std::vector<RunResult> &runs)
+{
+    // the baseline is the first configuration (the fewest threads and ranks)
+    const RunResult &base = runs.front();
+    double baseWorkers = base.threads * base.ranks;
+    double baseTime = base.times.at("total");
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"mode\": \"" << options.mode << "\",\n";
+    out << "    \"distribution\": \"" << options.distribution << "\",\n";
+    out << "    \"input\": \"" << (options.input.empty() ? "synthetic" : options.input) << "\",\n";
+    out << "    \"dims\": \"" << options.dims[0] << "x" << options.dims[1] << "x" << options.dims[2] << "\",\n";
+    out << "    \"blocksize\": " << options.blocksize << ",\n";
+    out << "    \"samples\": " << options.numSamples << ",\n";
+    out << "    \"repetitions\": " << options.repetitions << ",\n";
+    out << "    \"device\": \"" << (options.device.empty() ? "default" : options.device) << "\"\n";
+    out << "  },\n";
+    out << "  \"runs\": [\n";
+    for (std::size_t i = 0; i < runs.size(); i++)
+    {
+        const RunResult &r = runs[i];
+        double workers = r.threads * r.ranks;
+        double total = r.times.at("total");
+        double speedup = baseTime / total;
+        double efficiency = speedup / (workers / baseWorkers);
+        if (options.mode == "weak")
+        {
+            // only the ranks add work, the threads share the fixed problem of their rank, so
+            // the thread axis is strong scaling and the rank axis is weak scaling: the speedup
+            // is scaled by the ranks and the efficiency compares with the same thread count
+            // on the fewest ranks
+            speedup = speedup * r.ranks / base.ranks;
+            efficiency = speedup / (workers / baseWorkers);
+            for (const RunResult &other : runs)
+            {
+                if (other.threads == r.threads && other.ranks == base.ranks)
+                {
+                    efficiency = other.times.at("total") / total;
+                    break;
+                }
+            }
+        }
+
+        out << "    {\n";
+        out << "      \"threads\": " << r.threads << ",\n";
+        out << "      \"ranks\": " << r.ranks << ",\n";
+        out << "      \"total_time\": " << total << ",\n";
+        out << "      \"subsample_time\": " << r.times.at("subsample") << ",\n";
+        out << "      \"contour_time\": " << r.times.at("contour") << ",\n";
+        out << "      \"speedup\": " << speedup << ",\n";
+        out << "      \"efficiency\": " << efficiency << ",\n";
+        out << "      \"stages\": {";
+        for (std::size_t s = 0; s < r.stageNames.size(); s++)
+        {
+            out << (s > 0 ? ", " : "") << "\"" << r.stageNames[s] << "\": " << r.times.at(r.stageNames[s]);
+        }
+        out << "}\n";
+        out << "    }" << (i + 1 < runs.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+const std::string usageOptions =
+    "  --threads=N[,N...]      OpenMP thread counts (default 1,2,4)\n"
+    "  --ranks=N[,N...]        MPI rank counts (default 1)\n"
+    "  --mode=M                strong (fixed global size) or weak (fixed size per rank, synthetic only)\n"
+    "  --dims=X,Y,Z            global grid size, or the size of each rank for weak scaling (default 128,128,128)\n"
+    "  --input=FILE            vtk file with a uniform grid instead of the synthetic field\n"
+    "  --field=NAME            field of the input file (default synthetic)\n"
+    "  --distribution=D        uni, ig or mg (default ig)\n"
+    "  --blocksize=N           block size of the subsampling (default 4)\n"
+    "  --isovalue=V            isovalue (default 0)\n"
+    "  --noise=S               noise amplitude of the synthetic field (default 0.1)\n"
+    "  --samples=N             samples of the multivariant gaussian (default 1000)\n"
+    "  --repetitions=N         timed runs of each configuration, the best is reported (default 3)\n"
+    "  --device=D              vtkm device of the runs (serial, openmp, cuda ...)\n"
+    "  --launcher=CMD          command that starts N ranks when followed by N (default \"mpirun -np\")\n"
+    "  --output=FILE           write the json report to FILE instead of stdout";
+
+bool parseArguments(int argc, char *argv[], bool &worker)
+{
+    bool parsed = parseCommandLine(argc, argv, usageOptions, [&](const std::string &key, const std::string &value)
+                                   {
+        if (key == "--worker")
+        {
+            worker = true;
+            return true;
+        }
+        if (key == "--threads")
+        {
+            return parseIntList(value, options.threads);
+        }
+        if (key == "--ranks")
+        {
+            return parseIntList(value, options.ranks);
+        }
+        if (key == "--mode")
+        {
+            options.mode = value;
+            return (value == "strong" || value == "weak");
+        }
+        if (key == "--dims")
+        {
+            return parseDims(value, options.dims);
+        }
+        if (key == "--input")
+        {
+            options.input = value;
+            return true;
+        }
+        if (key == "--field")
+        {
+            options.fieldName = value;
+            return true;
+        }
+        if (key == "--distribution")
+        {
+            options.distribution = value;
+            return (value == "uni" || value == "ig" || value == "mg");
+        }
+        if (key == "--blocksize")
+        {
+            options.blocksize = std::stoi(value);
+            return options.blocksize > 0;
+        }
+        if (key == "--isovalue")
+        {
+            options.isovalue = std::stod(value);
+            return true;
+        }
+        if (key == "--noise")
+        {
+            options.noise = std::stod(value);
+            return true;
+        }
+        if (key == "--samples")
+        {
+            options.numSamples = std::stoi(value);
+            return options.numSamples > 0;
+        }
+        if (key == "--repetitions")
+        {
+            options.repetitions = std::stoi(value);
+            return options.repetitions > 0;
+        }
+        if (key == "--device")
+        {
+            options.device = value;
+            return true;
+        }
+        if (key == "--launcher")
+        {
+            options.launcher = value;
+            return true;
+        }
+        if (key == "--output")
+        {
+            options.output = value;
+            return true;
+        }
+        return false; });
+    if (!parsed)
+    {
+        return false;
+    }
+
+    if (options.mode == "weak" && !options.input.empty())
+    {
+        std::cout << "weak scaling needs the synthetic field" << std::endl;
+        return false;
+    }
+    if (options.distribution == "mg" && options.blocksize != 4)
+    {
+        std::cout << "the multivariant gaussian only supports the block size 4" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    bool worker = false;
+    for (int i = 1; i < argc; i++)
+    {
+        worker = worker || (std::string(argv[i]) == "--worker");
+    }
+
+    if (worker)
+    {
+        MPI_Init(&argc, &argv);
+        int rank;
+        int numRanks;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+
+        vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+        if (rank == 0)
+        {
+            // the driver only parses the stdout of the workers
+            runtime.PrintSummary(std::cerr);
+        }
+
+        if (!parseArguments(argc, argv, worker))
+        {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        int rc = runWorker(rank, numRanks, runtime.GetDevice());
+        MPI_Finalize();
+        return rc;
+    }
+
+    if (!parseArguments(argc, argv, worker))
+    {
+        return 1;
+    }
+
+    // the workers are started from the same executable
+    char executable[4096];
+    ssize_t length = readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+    if (length <= 0)
+    {
+        std::cerr << "can not find the path of the executable" << std::endl;
+        return 1;
+    }
+    executable[length] = '\0';
+
+    std::sort(options.ranks.begin(), options.ranks.end());
+    std::sort(options.threads.begin(), options.threads.end());
+
+    std::vector<RunResult> runs;
+    for (int ranks : options.ranks)
+    {
+        for (int threads : options.threads)
+        {
+            RunResult result;
+            if (!runConfiguration(executable, threads, ranks, result))
+            {
+                std::cerr << "the run with " << threads << " threads and " << ranks << " ranks failed" << std::endl;
+                return 1;
+            }
+            std::cerr << threads << " threads " << ranks << " ranks total time " << result.times["total"] << std::endl;
+            runs.push_back(result);
+        }
+    }
+
+    if (options.output.empty())
+    {
+        writeJson(std::cout, runs);
+    }
+    else
+    {
+        std::ofstream out(options.output);
+        writeJson(out, runs);
+        std::cerr << "write the report to " << options.output << std::endl;
+    }
+
+    return 0;
+}
@@ -8,6 +8,8 @@
 #include <vtkm/worklet/WorkletMapTopology.h>
 #include <vtkm/worklet/DispatcherMapTopology.h>
 
+#include "UncertaintyRuntime.h"
+
 class ProbMCWorklet : public vtkm::worklet::WorkletVisitCellsWithPoints
 {
 public:
@@ -229,8 +231,9 @@ using SupportedTypes = vtkm::List<vtkm::Float32,
 // using the WorkletVisitCellsWithPoints
 int main(int argc, char *argv[])
 {
-    // init the vtkm (set the backend and log level here)
-    vtkm::cont::Initialize(argc, argv);
+    // init the vtkm (set the backend, threads and log level here)
+    vtkm::filter::uncertainty::UncertaintyRuntime runtime(argc, argv);
+    runtime.PrintSummary(std::cout);
 
     if (argc != 4)
     {
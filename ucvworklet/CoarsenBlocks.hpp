@@ -0,0 +1,147 @@
+#ifndef UCV_COARSEN_BLOCKS_h
+#define UCV_COARSEN_BLOCKS_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+// merge the blocks of a subsampled grid into blocks r times larger
+//
+// the fine grid uses the block size b, so the fine point i groups the raw points [i*b, (i+1)*b)
+// and the coarse point i groups the fine points [i*r, (i+1)*r), which are the raw points
+// [i*r*b, (i+1)*r*b). This gives the same blocks as subsampling the raw grid with the block
+// size r*b, without reading the raw points again
+
+// the min of the fine mins and the max of the fine maxes (exact)
+struct CoarsenMinMax : public vtkm::worklet::WorkletMapField
+{
+    CoarsenMinMax(vtkm::Id3 fineDims, vtkm::Id3 coarseDims, vtkm::Id ratio)
+        : m_fineDims(fineDims), m_coarseDims(coarseDims), m_ratio(ratio){};
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, WholeArrayIn, FieldOut, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    template <typename FinePortalType, typename OutType>
+    VTKM_EXEC void operator()(const vtkm::Id &coarseId,
+                              const FinePortalType &fineMin,
+                              const FinePortalType &fineMax,
+                              OutType &minValue,
+                              OutType &maxValue) const
+    {
+        vtkm::Id3 coarseIndex{coarseId % m_coarseDims[0],
+                              (coarseId / m_coarseDims[0]) % m_coarseDims[1],
+                              coarseId / m_coarseDims[0] / m_coarseDims[1]};
+
+        vtkm::Id3 begin, end;
+        for (vtkm::IdComponent d = 0; d < 3; d++)
+        {
+            begin[d] = coarseIndex[d] * m_ratio;
+            end[d] = vtkm::Min(begin[d] + m_ratio, m_fineDims[d]);
+        }
+
+        minValue = fineMin.Get(begin[0] + begin[1] * m_fineDims[0] + begin[2] * m_fineDims[0] * m_fineDims[1]);
+        maxValue = fineMax.Get(begin[0] + begin[1] * m_fineDims[0] + begin[2] * m_fineDims[0] * m_fineDims[1]);
+        for (vtkm::Id k = begin[2]; k < end[2]; k++)
+        {
+            for (vtkm::Id j = begin[1]; j < end[1]; j++)
+            {
+                for (vtkm::Id i = begin[0]; i < end[0]; i++)
+                {
+                    vtkm::Id fineId = i + j * m_fineDims[0] + k * m_fineDims[0] * m_fineDims[1];
+                    minValue = vtkm::Min(minValue, static_cast<OutType>(fineMin.Get(fineId)));
+                    maxValue = vtkm::Max(maxValue, static_cast<OutType>(fineMax.Get(fineId)));
+                }
+            }
+        }
+    }
+
+private:
+    vtkm::Id3 m_fineDims;
+    vtkm::Id3 m_coarseDims;
+    vtkm::Id m_ratio;
+};
+
+// the mean and the stdev of the union of the fine blocks, each fine block is weighted by its
+// number of raw points since the last blocks along each axis may be cut by the raw grid
+// (exact up to rounding, the variance is the mean of the fine variances plus the variance of
+// the fine means, with the same population normalization as ExtractingMeanStdev)
+struct CoarsenMeanStdev : public vtkm::worklet::WorkletMapField
+{
+    CoarsenMeanStdev(vtkm::Id3 rawDims, vtkm::Id3 fineDims, vtkm::Id3 coarseDims, vtkm::Id ratio, vtkm::Id blockSize)
+        : m_rawDims(rawDims), m_fineDims(fineDims), m_coarseDims(coarseDims), m_ratio(ratio), m_blockSize(blockSize){};
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, WholeArrayIn, FieldOut, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    template <typename FinePortalType, typename OutType>
+    VTKM_EXEC void operator()(const vtkm::Id &coarseId,
+                              const FinePortalType &fineMean,
+                              const FinePortalType &fineStdev,
+                              OutType &meanValue,
+                              OutType &stdevValue) const
+    {
+        vtkm::Id3 coarseIndex{coarseId % m_coarseDims[0],
+                              (coarseId / m_coarseDims[0]) % m_coarseDims[1],
+                              coarseId / m_coarseDims[0] / m_coarseDims[1]};
+
+        vtkm::Id3 begin, end;
+        for (vtkm::IdComponent d = 0; d < 3; d++)
+        {
+            begin[d] = coarseIndex[d] * m_ratio;
+            end[d] = vtkm::Min(begin[d] + m_ratio, m_fineDims[d]);
+        }
+
+        // two passes as in ExtractingMeanStdev, the mean and then the offsets to the mean
+        vtkm::Float64 count = 0;
+        vtkm::Float64 sum = 0;
+        for (vtkm::Id k = begin[2]; k < end[2]; k++)
+        {
+            for (vtkm::Id j = begin[1]; j < end[1]; j++)
+            {
+                for (vtkm::Id i = begin[0]; i < end[0]; i++)
+                {
+                    vtkm::Float64 n = static_cast<vtkm::Float64>(this->NumRawPoints(i, 0) * this->NumRawPoints(j, 1) *
+                                                                 this->NumRawPoints(k, 2));
+                    vtkm::Id fineId = i + j * m_fineDims[0] + k * m_fineDims[0] * m_fineDims[1];
+                    count += n;
+                    sum += n * static_cast<vtkm::Float64>(fineMean.Get(fineId));
+                }
+            }
+        }
+        vtkm::Float64 mean = sum / count;
+
+        vtkm::Float64 squares = 0;
+        for (vtkm::Id k = begin[2]; k < end[2]; k++)
+        {
+            for (vtkm::Id j = begin[1]; j < end[1]; j++)
+            {
+                for (vtkm::Id i = begin[0]; i < end[0]; i++)
+                {
+                    vtkm::Float64 n = static_cast<vtkm::Float64>(this->NumRawPoints(i, 0) * this->NumRawPoints(j, 1) *
+                                                                 this->NumRawPoints(k, 2));
+                    vtkm::Id fineId = i + j * m_fineDims[0] + k * m_fineDims[0] * m_fineDims[1];
+                    vtkm::Float64 stdev = static_cast<vtkm::Float64>(fineStdev.Get(fineId));
+                    vtkm::Float64 offset = static_cast<vtkm::Float64>(fineMean.Get(fineId)) - mean;
+                    squares += n * (stdev * stdev + offset * offset);
+                }
+            }
+        }
+
+        meanValue = static_cast<OutType>(mean);
+        stdevValue = static_cast<OutType>(vtkm::Sqrt(squares / count));
+    }
+
+private:
+    // the number of raw points of the fine block index along the axis
+    VTKM_EXEC vtkm::Id NumRawPoints(vtkm::Id index, vtkm::IdComponent axis) const
+    {
+        return vtkm::Min(m_blockSize, m_rawDims[axis] - index * m_blockSize);
+    }
+
+    vtkm::Id3 m_rawDims;
+    vtkm::Id3 m_fineDims;
+    vtkm::Id3 m_coarseDims;
+    vtkm::Id m_ratio;
+    vtkm::Id m_blockSize;
+};
+
+#endif // UCV_COARSEN_BLOCKS_h
@@ -0,0 +1,25 @@
+#ifndef UCV_COPY_CELL_POINT_IDS_h
+#define UCV_COPY_CELL_POINT_IDS_h
+
+#include <vtkm/worklet/WorkletMapTopology.h>
+
+// copy the point ids of each visited cell, it is used to turn a subset of
+// the cells of a structured cell set into a cell set with a single cell type
+// (the structured cells use the same point order as the vtk hexahedron and quad)
+template <vtkm::IdComponent NumPoints>
+struct CopyCellPointIds : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+    using ControlSignature = void(CellSetIn, FieldOutCell);
+    using ExecutionSignature = void(PointIndices, _2);
+
+    template <typename PointIdsType, typename OutPointIdsType>
+    VTKM_EXEC void operator()(const PointIdsType &pointIds, OutPointIdsType &outPointIds) const
+    {
+        for (vtkm::IdComponent i = 0; i < NumPoints; i++)
+        {
+            outPointIds[i] = pointIds[i];
+        }
+    }
+};
+
+#endif // UCV_COPY_CELL_POINT_IDS_h
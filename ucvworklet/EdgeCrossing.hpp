@@ -0,0 +1,186 @@
+#ifndef UCV_EDGE_CROSSING_h
+#define UCV_EDGE_CROSSING_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+// the uncertainty models of a point value, with two parameters per point
+// (min and max for the uniform model, mean and stdev for the gaussian model)
+struct UniformEdgeModel
+{
+    // Pr[X < isovalue]
+    VTKM_EXEC static vtkm::FloatDefault NegativeProb(vtkm::FloatDefault minV, vtkm::FloatDefault maxV, vtkm::FloatDefault isovalue)
+    {
+        if (isovalue <= minV)
+        {
+            return 0.0;
+        }
+        if (isovalue >= maxV)
+        {
+            return 1.0;
+        }
+        return (isovalue - minV) / (maxV - minV);
+    }
+
+    VTKM_EXEC static vtkm::FloatDefault Mean(vtkm::FloatDefault minV, vtkm::FloatDefault maxV)
+    {
+        return 0.5 * (minV + maxV);
+    }
+};
+
+struct IndependentGaussianEdgeModel
+{
+    // Pr[X < isovalue]
+    VTKM_EXEC static vtkm::FloatDefault NegativeProb(vtkm::FloatDefault mean, vtkm::FloatDefault stdev, vtkm::FloatDefault isovalue)
+    {
+        if (stdev <= 0)
+        {
+            return (mean < isovalue) ? 1.0 : 0.0;
+        }
+        return 0.5 * (1 + vtkm::ERF((isovalue - mean) / (vtkm::Sqrt(2.0) * stdev)));
+    }
+
+    VTKM_EXEC static vtkm::FloatDefault Mean(vtkm::FloatDefault mean, vtkm::FloatDefault)
+    {
+        return mean;
+    }
+};
+
+// the implicit indexing of the unique edges of a structured grid of points,
+// the edges along x come first, then the edges along y and then the edges along z,
+// each group follows the order of its first point (x varies fastest)
+// a 2D grid is a 3D grid with a z dimension of 1, so it has no edges along z
+struct StructuredEdgeIndexing
+{
+    VTKM_EXEC_CONT StructuredEdgeIndexing(vtkm::Id3 pointDims)
+        : m_pointDims(pointDims)
+    {
+        m_numEdges[0] = (pointDims[0] - 1) * pointDims[1] * pointDims[2];
+        m_numEdges[1] = pointDims[0] * (pointDims[1] - 1) * pointDims[2];
+        m_numEdges[2] = pointDims[0] * pointDims[1] * vtkm::Max(pointDims[2] - 1, vtkm::Id(0));
+    }
+
+    VTKM_EXEC_CONT vtkm::Id GetNumberOfEdges() const
+    {
+        return m_numEdges[0] + m_numEdges[1] + m_numEdges[2];
+    }
+
+    // the id of the edge that starts at the point (i, j, k) and goes along the direction
+    VTKM_EXEC_CONT vtkm::Id EdgeId(vtkm::Id i, vtkm::Id j, vtkm::Id k, vtkm::IdComponent direction) const
+    {
+        if (direction == 0)
+        {
+            return i + (m_pointDims[0] - 1) * (j + m_pointDims[1] * k);
+        }
+        if (direction == 1)
+        {
+            return m_numEdges[0] + i + m_pointDims[0] * (j + (m_pointDims[1] - 1) * k);
+        }
+        return m_numEdges[0] + m_numEdges[1] + i + m_pointDims[0] * (j + m_pointDims[1] * k);
+    }
+
+    // the ids of the two points of the edge
+    VTKM_EXEC_CONT vtkm::Id2 EdgePoints(vtkm::Id edgeId) const
+    {
+        vtkm::Id nx = m_pointDims[0];
+        vtkm::Id ny = m_pointDims[1];
+        if (edgeId < m_numEdges[0])
+        {
+            vtkm::Id i = edgeId % (nx - 1);
+            vtkm::Id jk = edgeId / (nx - 1);
+            vtkm::Id first = i + nx * jk;
+            return vtkm::Id2(first, first + 1);
+        }
+        edgeId -= m_numEdges[0];
+        if (edgeId < m_numEdges[1])
+        {
+            vtkm::Id i = edgeId % nx;
+            vtkm::Id j = (edgeId / nx) % (ny - 1);
+            vtkm::Id k = edgeId / (nx * (ny - 1));
+            vtkm::Id first = i + nx * (j + ny * k);
+            return vtkm::Id2(first, first + nx);
+        }
+        edgeId -= m_numEdges[1];
+        return vtkm::Id2(edgeId, edgeId + nx * ny);
+    }
+
+    vtkm::Id3 m_pointDims;
+    vtkm::Id3 m_numEdges;
+};
+
+// the probability that the contour crosses the edge and the expected crossing position,
+// the edge is crossed when one point is below and the other one above the isovalue, the
+// points are independent so Pr = Pr[a<iso]Pr[b>=iso] + Pr[a>=iso]Pr[b<iso]
+// the crossing position is the linear interpolation of the means of the points, which is
+// the expected position to the first order, written with the distances of the means to the
+// isovalue so it stays inside the edge when both means are on the same side (clamping it to
+// an end of the edge would collapse the triangles that use the edge onto a grid point)
+template <typename ModelType>
+VTKM_EXEC void ComputeEdgeCrossing(vtkm::FloatDefault a0, vtkm::FloatDefault a1,
+                                   vtkm::FloatDefault b0, vtkm::FloatDefault b1,
+                                   vtkm::FloatDefault isovalue,
+                                   vtkm::FloatDefault &crossProb,
+                                   vtkm::FloatDefault &crossPosition)
+{
+    vtkm::FloatDefault negativeA = ModelType::NegativeProb(a0, a1, isovalue);
+    vtkm::FloatDefault negativeB = ModelType::NegativeProb(b0, b1, isovalue);
+    crossProb = negativeA * (1 - negativeB) + (1 - negativeA) * negativeB;
+
+    vtkm::FloatDefault meanA = ModelType::Mean(a0, a1);
+    vtkm::FloatDefault meanB = ModelType::Mean(b0, b1);
+    vtkm::FloatDefault distanceA = vtkm::Abs(isovalue - meanA);
+    vtkm::FloatDefault distanceB = vtkm::Abs(isovalue - meanB);
+    if (distanceA + distanceB == 0)
+    {
+        crossPosition = 0.5;
+    }
+    else
+    {
+        crossPosition = distanceA / (distanceA + distanceB);
+    }
+}
+
+// compute the crossing of each unique edge of a structured grid once,
+// instead of once for each of the (up to 4) cells that share it
+template <typename ModelType>
+struct EdgeCrossingStructured : public vtkm::worklet::WorkletMapField
+{
+    EdgeCrossingStructured(vtkm::Id3 pointDims, double isovalue)
+        : m_indexing(pointDims), m_isovalue(isovalue){};
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, WholeArrayIn, WholeArrayIn, FieldOut, FieldOut, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+    template <typename FieldPortalType0, typename FieldPortalType1, typename CoordsPortalType, typename OutPointIdsType, typename OutProbType>
+    VTKM_EXEC void operator()(const vtkm::Id &edgeId,
+                              const FieldPortalType0 &field0,
+                              const FieldPortalType1 &field1,
+                              const CoordsPortalType &coords,
+                              OutPointIdsType &outPointIds,
+                              OutProbType &crossProb,
+                              vtkm::Vec3f &crossPoint) const
+    {
+        vtkm::Id2 pointIds = m_indexing.EdgePoints(edgeId);
+        outPointIds[0] = pointIds[0];
+        outPointIds[1] = pointIds[1];
+        vtkm::FloatDefault prob;
+        vtkm::FloatDefault t;
+        ComputeEdgeCrossing<ModelType>(static_cast<vtkm::FloatDefault>(field0.Get(pointIds[0])),
+                                       static_cast<vtkm::FloatDefault>(field1.Get(pointIds[0])),
+                                       static_cast<vtkm::FloatDefault>(field0.Get(pointIds[1])),
+                                       static_cast<vtkm::FloatDefault>(field1.Get(pointIds[1])),
+                                       static_cast<vtkm::FloatDefault>(m_isovalue),
+                                       prob,
+                                       t);
+        crossProb = static_cast<OutProbType>(prob);
+        vtkm::Vec3f p0 = coords.Get(pointIds[0]);
+        vtkm::Vec3f p1 = coords.Get(pointIds[1]);
+        crossPoint = p0 + t * (p1 - p0);
+    }
+
+private:
+    StructuredEdgeIndexing m_indexing;
+    double m_isovalue;
+};
+
+#endif // UCV_EDGE_CROSSING_h
@@ -0,0 +1,127 @@
+#ifndef UCV_ENTROPY_FROM_POINT_PROBABILITY_h
+#define UCV_ENTROPY_FROM_POINT_PROBABILITY_h
+
+#include <vtkm/worklet/WorkletMapTopology.h>
+#include <vtkm/worklet/MaskSelect.h>
+
+// the point probabilities can be stored as FloatDefault or quantized to 8 bits, where
+// code 0 is the probability 0 and code 255 the probability 1, the probabilities 0 and 1
+// (the points that are certainly on one side of the isovalue) are exact
+template <typename T>
+VTKM_EXEC inline void EncodePointProbability(vtkm::FloatDefault prob, T &out)
+{
+    out = static_cast<T>(prob);
+}
+
+VTKM_EXEC inline void EncodePointProbability(vtkm::FloatDefault prob, vtkm::UInt8 &out)
+{
+    out = static_cast<vtkm::UInt8>(prob * 255 + 0.5);
+}
+
+template <typename T>
+VTKM_EXEC inline vtkm::FloatDefault DecodePointProbability(const T &value)
+{
+    return static_cast<vtkm::FloatDefault>(value);
+}
+
+VTKM_EXEC inline vtkm::FloatDefault DecodePointProbability(vtkm::UInt8 code)
+{
+    return static_cast<vtkm::FloatDefault>(code) / 255;
+}
+
+// compute the entropy and other assocaited uncertainty values *per cell* from the probability
+// Pr[X<=iso] of each point, which is computed once per point by a point pass (such as
+// GaussianPointProbability), instead of once for each of the 8 cells sharing the point
+// the results are the same as EntropyIndependentGaussian and EntropyUniform
+class EntropyFromPointProbability : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+    EntropyFromPointProbability(){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldOutCell,
+                                  FieldOutCell,
+                                  FieldOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5);
+
+    using InputDomain = _1;
+
+    template <typename InPointFieldProbType, typename OutCellFieldType1, typename OutCellFieldType2, typename OutCellFieldType3>
+    VTKM_EXEC void operator()(
+        const InPointFieldProbType &inPointFieldVecNegativeProb,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy) const
+    {
+        vtkm::IdComponent numPoints = inPointFieldVecNegativeProb.GetNumberOfComponents();
+        if (numPoints != 8)
+        {
+            printf("this is the 3d version for 8 vertecies\n");
+            return;
+        }
+
+        vtkm::FloatDefault allPositiveProb = 1.0;
+        vtkm::FloatDefault allNegativeProb = 1.0;
+
+        // position 0 is negative
+        // position 1 is positive
+        vtkm::Vec<vtkm::Vec2f, 8> ProbList;
+        for (vtkm::IdComponent pointIndex = 0; pointIndex < numPoints; ++pointIndex)
+        {
+            vtkm::FloatDefault negativeProb = DecodePointProbability(inPointFieldVecNegativeProb[pointIndex]);
+            vtkm::FloatDefault positiveProb = 1.0 - negativeProb;
+
+            allNegativeProb *= negativeProb;
+            allPositiveProb *= positiveProb;
+
+            ProbList[pointIndex][0] = negativeProb;
+            ProbList[pointIndex][1] = positiveProb;
+        }
+
+        outCellFieldCProb = 1 - allPositiveProb - allNegativeProb;
+
+        // the probability of each of the 256 cases, 1 is positive 0 is negative
+        vtkm::FloatDefault entropyValue = 0;
+        vtkm::Id nonzeroCases = 0;
+        for (vtkm::UInt32 i = 0; i < 256; i++)
+        {
+            vtkm::FloatDefault currProb = 1.0;
+            for (vtkm::UInt32 j = 0; j < 8; j++)
+            {
+                currProb = currProb * ProbList[j][(i >> j) & 1];
+            }
+            if (currProb > 0.00001)
+            {
+                nonzeroCases++;
+                entropyValue = entropyValue - currProb * vtkm::Log2(currProb);
+            }
+        }
+
+        outCellFieldNumNonzeroProb = nonzeroCases;
+        outCellFieldEntropy = entropyValue;
+    }
+};
+
+// same computation as EntropyFromPointProbability but only for the cells selected by the mask,
+// see EntropyIndependentGaussianMasked
+class EntropyFromPointProbabilityMasked : public EntropyFromPointProbability
+{
+public:
+    EntropyFromPointProbabilityMasked(){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInOutCell,
+                                  FieldInOutCell,
+                                  FieldInOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5);
+
+    using InputDomain = _1;
+
+    using MaskType = vtkm::worklet::MaskSelect;
+};
+
+#endif // UCV_ENTROPY_FROM_POINT_PROBABILITY_h
@@ -2,6 +2,7 @@
 #define UCV_ENTROPY_INDEPEDENT_GAUSSIAN_h
 
 #include <vtkm/worklet/WorkletMapTopology.h>
+#include <vtkm/worklet/MaskSelect.h>
 #include <cmath>
 // compute the entropy and other assocaited uncertainty values *per cell*
 class EntropyIndependentGaussian : public vtkm::worklet::WorkletVisitCellsWithPoints
@@ -170,4 +171,29 @@ private:
     double m_isovalue;
 };
 
-#endif // UCV_ENTROPY_INDEPEDENT_GAUSSIAN_h
\ No newline at end of file
+// same computation as EntropyIndependentGaussian but only for the cells selected by the mask,
+// this is used by the progressive refinement, where only the cells whose coarse
+// parent may contain the contour are recomputed. The output arrays are in/out so
+// that the values of the cells not selected are kept (they are expected to be
+// initialized by the caller)
+class EntropyIndependentGaussianMasked : public EntropyIndependentGaussian
+{
+public:
+    EntropyIndependentGaussianMasked(double isovalue)
+        : EntropyIndependentGaussian(isovalue){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldInOutCell,
+                                  FieldInOutCell,
+                                  FieldInOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5, _6);
+
+    using InputDomain = _1;
+
+    using MaskType = vtkm::worklet::MaskSelect;
+};
+
+#endif // UCV_ENTROPY_INDEPEDENT_GAUSSIAN_h
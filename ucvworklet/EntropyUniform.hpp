@@ -2,6 +2,7 @@
 #define UCV_ENTROPY_UNIFORM_h
 
 #include <vtkm/worklet/WorkletMapTopology.h>
+#include <vtkm/worklet/MaskSelect.h>
 class EntropyUniform : public vtkm::worklet::WorkletVisitCellsWithPoints
 {
 public:
@@ -197,4 +198,29 @@ private:
     double m_isovalue;
 };
 
-#endif // UCV_ENTROPY_UNIFORM_h
\ No newline at end of file
+// same computation as EntropyUniform but only for the cells selected by the mask,
+// this is used by the progressive refinement, where only the cells whose coarse
+// parent may contain the contour are recomputed. The output arrays are in/out so
+// that the values of the cells not selected are kept (they are expected to be
+// initialized by the caller)
+class EntropyUniformMasked : public EntropyUniform
+{
+public:
+    EntropyUniformMasked(double isovalue)
+        : EntropyUniform(isovalue){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldInOutCell,
+                                  FieldInOutCell,
+                                  FieldInOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5, _6);
+
+    using InputDomain = _1;
+
+    using MaskType = vtkm::worklet::MaskSelect;
+};
+
+#endif // UCV_ENTROPY_UNIFORM_h
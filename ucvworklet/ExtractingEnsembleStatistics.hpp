@@ -0,0 +1,72 @@
+#ifndef UCV_EXTRACTING_ENSEMBLE_STATISTICS_h
+#define UCV_EXTRACTING_ENSEMBLE_STATISTICS_h
+
+#include <vtkm/VecTraits.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <type_traits>
+
+// the min, max, mean and stdev of the members of the ensemble of each point, the ensemble is a
+// Vec (or the recombined components of a SoA array), the stdev divides by the number of members
+// like ExtractingMeanStdev and uses two passes
+struct ExtractingEnsembleStatistics : public vtkm::worklet::WorkletMapField
+{
+    using ControlSignature = void(FieldIn, FieldOut, FieldOut, FieldOut, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    template <typename EnsembleType>
+    VTKM_EXEC void operator()(const EnsembleType &ensemble,
+                              vtkm::FloatDefault &minValue,
+                              vtkm::FloatDefault &maxValue,
+                              vtkm::FloatDefault &meanValue,
+                              vtkm::FloatDefault &stdevValue) const
+    {
+        using Traits = vtkm::VecTraits<EnsembleType>;
+        vtkm::IdComponent numMembers = Traits::GetNumberOfComponents(ensemble);
+
+        vtkm::FloatDefault sum = 0;
+        minValue = static_cast<vtkm::FloatDefault>(Traits::GetComponent(ensemble, 0));
+        maxValue = minValue;
+        for (vtkm::IdComponent i = 0; i < numMembers; i++)
+        {
+            vtkm::FloatDefault v = static_cast<vtkm::FloatDefault>(Traits::GetComponent(ensemble, i));
+            minValue = vtkm::Min(minValue, v);
+            maxValue = vtkm::Max(maxValue, v);
+            sum += v;
+        }
+        meanValue = sum / numMembers;
+
+        vtkm::FloatDefault squares = 0;
+        for (vtkm::IdComponent i = 0; i < numMembers; i++)
+        {
+            vtkm::FloatDefault offset = static_cast<vtkm::FloatDefault>(Traits::GetComponent(ensemble, i)) - meanValue;
+            squares += offset * offset;
+        }
+        stdevValue = vtkm::Sqrt(squares / numMembers);
+    }
+};
+
+// the members minus the mean of their point, so the covariance of two points is the dot
+// product of their centered members divided by the number of members minus 1
+struct ExtractingEnsembleCentered : public vtkm::worklet::WorkletMapField
+{
+    using ControlSignature = void(FieldIn, FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename EnsembleType, typename CenteredType>
+    VTKM_EXEC void operator()(const EnsembleType &ensemble,
+                              const vtkm::FloatDefault &meanValue,
+                              CenteredType &centered) const
+    {
+        using InTraits = vtkm::VecTraits<EnsembleType>;
+        using OutTraits = vtkm::VecTraits<CenteredType>;
+        using OutComponentType = typename OutTraits::ComponentType;
+        for (vtkm::IdComponent i = 0; i < InTraits::GetNumberOfComponents(ensemble); i++)
+        {
+            OutTraits::SetComponent(
+                centered, i, static_cast<OutComponentType>(static_cast<vtkm::FloatDefault>(InTraits::GetComponent(ensemble, i)) - meanValue));
+        }
+    }
+};
+
+#endif // UCV_EXTRACTING_ENSEMBLE_STATISTICS_h
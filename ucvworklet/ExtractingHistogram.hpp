@@ -0,0 +1,50 @@
+#ifndef UCV_EXTRACTING_HISTOGRAM_h
+#define UCV_EXTRACTING_HISTOGRAM_h
+
+#include <vtkm/worklet/WorkletReduceByKey.h>
+
+// the min, the max and a histogram with a fixed number of bins of the values of each block,
+// the bins split [min, max] evenly and the max goes to the last bin
+// the histogram is a Vec of counts, its size is the number of bins
+struct ExtractingHistogram : public vtkm::worklet::WorkletReduceByKey
+{
+    using ControlSignature = void(KeysIn, ValuesIn, ReducedValuesOut, ReducedValuesOut, ReducedValuesOut);
+    using ExecutionSignature = void(_2, _3, _4, _5);
+    using InputDomain = _1;
+    template <typename OriginalValuesType, typename OutputType, typename HistogramType>
+    VTKM_EXEC void operator()(
+        const OriginalValuesType &originalValues, OutputType &minValue, OutputType &maxValue, HistogramType &histogram) const
+    {
+        using CountType = typename HistogramType::ComponentType;
+        constexpr vtkm::IdComponent numBins = HistogramType::NUM_COMPONENTS;
+
+        minValue = originalValues[0];
+        maxValue = originalValues[0];
+        vtkm::IdComponent numValues = originalValues.GetNumberOfComponents();
+        for (vtkm::IdComponent index = 1; index < numValues; index++)
+        {
+            minValue = (originalValues[index] < minValue) ? originalValues[index] : minValue;
+            maxValue = (originalValues[index] > maxValue) ? originalValues[index] : maxValue;
+        }
+
+        for (vtkm::IdComponent bin = 0; bin < numBins; bin++)
+        {
+            histogram[bin] = CountType(0);
+        }
+
+        vtkm::FloatDefault range = static_cast<vtkm::FloatDefault>(maxValue) - static_cast<vtkm::FloatDefault>(minValue);
+        for (vtkm::IdComponent index = 0; index < numValues; index++)
+        {
+            vtkm::IdComponent bin = 0;
+            if (range > 0)
+            {
+                vtkm::FloatDefault offset = static_cast<vtkm::FloatDefault>(originalValues[index]) - static_cast<vtkm::FloatDefault>(minValue);
+                bin = static_cast<vtkm::IdComponent>(offset / range * numBins);
+                bin = (bin < numBins) ? bin : numBins - 1;
+            }
+            histogram[bin] = histogram[bin] + CountType(1);
+        }
+    }
+};
+
+#endif // UCV_EXTRACTING_HISTOGRAM_h
@@ -1,8 +1,10 @@
 #ifndef UCV_EXTRACTING_MEAD_STD_h
 #define UCV_EXTRACTING_MEAD_STD_h
 
+#include <vtkm/VecTraits.h>
 #include <vtkm/worklet/WorkletReduceByKey.h>
 #include <cmath>
+#include <type_traits>
 
 struct ExtractingMeanStdev : public vtkm::worklet::WorkletReduceByKey
 {
@@ -13,21 +15,36 @@ struct ExtractingMeanStdev : public vtkm::worklet::WorkletReduceByKey
     VTKM_EXEC void operator()(
         const OriginalValuesType &originalValues, OutputType &meanValue, OutputType &stdevValue) const
     {
-        vtkm::IdComponent NumComponents = originalValues.GetNumberOfComponents();
+        using InTraits = vtkm::VecTraits<std::decay_t<decltype(originalValues[0])>>;
+        using OutTraits = vtkm::VecTraits<OutputType>;
 
-        // refer to https://www.strchr.com/standard_deviation_in_one_pass
-        meanValue = originalValues[0];
-        stdevValue = originalValues[0] * originalValues[0];
-        for (vtkm::IdComponent index = 1; index < NumComponents; index++)
+        vtkm::IdComponent NumValues = originalValues.GetNumberOfComponents();
+
+        // two passes, the mean and then the squared offsets to the mean, the one pass
+        // E[x^2] - E[x]^2 loses most of its precision when the stdev is small against the mean
+        // (it can even be negative), the values of a block are read twice but stay in cache
+        // the sums are kept in double so large blocks of float values do not lose precision
+        for (vtkm::IdComponent cIndex = 0; cIndex < OutTraits::GetNumberOfComponents(meanValue); ++cIndex)
         {
-            meanValue += originalValues[index];
-            stdevValue += originalValues[index] * originalValues[index];
-        }
+            vtkm::Float64 sum = 0;
+            for (vtkm::IdComponent index = 0; index < NumValues; index++)
+            {
+                sum += static_cast<vtkm::Float64>(InTraits::GetComponent(originalValues[index], cIndex));
+            }
+            vtkm::Float64 mean = sum / NumValues;
 
-        meanValue *= 1.0 / NumComponents;
-        stdevValue *= 1.0 / NumComponents;
-        stdevValue -= meanValue * meanValue;
-        stdevValue = vtkm::Sqrt(stdevValue);
+            vtkm::Float64 squares = 0;
+            for (vtkm::IdComponent index = 0; index < NumValues; index++)
+            {
+                vtkm::Float64 offset =
+                    static_cast<vtkm::Float64>(InTraits::GetComponent(originalValues[index], cIndex)) - mean;
+                squares += offset * offset;
+            }
+
+            using OutComponentType = typename OutTraits::ComponentType;
+            OutTraits::SetComponent(meanValue, cIndex, static_cast<OutComponentType>(mean));
+            OutTraits::SetComponent(stdevValue, cIndex, static_cast<OutComponentType>(vtkm::Sqrt(squares / NumValues)));
+        }
     }
 };
 
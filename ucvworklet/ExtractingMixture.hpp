@@ -0,0 +1,156 @@
+#ifndef UCV_EXTRACTING_MIXTURE_h
+#define UCV_EXTRACTING_MIXTURE_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletReduceByKey.h>
+
+// fit a gaussian mixture model with K components to the values of each block with the
+// expectation maximization algorithm, the output is a Vec of 3*K values:
+// the weights [0, K), the means [K, 2K) and the standard deviations [2K, 3K)
+// the responsibilities are not stored, each iteration goes over the values once and
+// accumulates the sums of the M step, so the worklet does not need memory per value
+struct ExtractingMixture : public vtkm::worklet::WorkletReduceByKey
+{
+    ExtractingMixture(vtkm::IdComponent maxIterations, vtkm::FloatDefault tolerance)
+        : m_maxIterations(maxIterations), m_tolerance(tolerance){};
+
+    using ControlSignature = void(KeysIn, ValuesIn, ReducedValuesOut);
+    using ExecutionSignature = void(_2, _3);
+    using InputDomain = _1;
+    template <typename OriginalValuesType, typename MixtureType>
+    VTKM_EXEC void operator()(const OriginalValuesType &originalValues, MixtureType &mixture) const
+    {
+        constexpr vtkm::IdComponent K = MixtureType::NUM_COMPONENTS / 3;
+        vtkm::IdComponent numValues = originalValues.GetNumberOfComponents();
+
+        vtkm::FloatDefault minV = static_cast<vtkm::FloatDefault>(originalValues[0]);
+        vtkm::FloatDefault maxV = minV;
+        for (vtkm::IdComponent index = 1; index < numValues; index++)
+        {
+            vtkm::FloatDefault v = static_cast<vtkm::FloatDefault>(originalValues[index]);
+            minV = vtkm::Min(minV, v);
+            maxV = vtkm::Max(maxV, v);
+        }
+        vtkm::FloatDefault range = maxV - minV;
+
+        vtkm::Vec<vtkm::FloatDefault, K> weight;
+        vtkm::Vec<vtkm::FloatDefault, K> mean;
+        vtkm::Vec<vtkm::FloatDefault, K> stdev;
+
+        if (range <= 0)
+        {
+            // all the values are the same, a single component without variance
+            for (vtkm::IdComponent k = 0; k < K; k++)
+            {
+                weight[k] = (k == 0) ? 1.0 : 0.0;
+                mean[k] = minV;
+                stdev[k] = 0.0;
+            }
+            this->Store(weight, mean, stdev, mixture);
+            return;
+        }
+
+        // the means start evenly spaced in [min, max] and the components are not allowed to
+        // be narrower than a small part of the range, so a component can not collapse on a value
+        vtkm::FloatDefault minStdev = range * vtkm::FloatDefault(1e-3);
+        for (vtkm::IdComponent k = 0; k < K; k++)
+        {
+            weight[k] = vtkm::FloatDefault(1) / K;
+            mean[k] = minV + range * (k + vtkm::FloatDefault(0.5)) / K;
+            stdev[k] = range / (2 * K);
+        }
+
+        const vtkm::FloatDefault invSqrt2Pi = 0.3989422804014327;
+        vtkm::FloatDefault prevLogLikelihood = vtkm::NegativeInfinity<vtkm::FloatDefault>();
+        for (vtkm::IdComponent iter = 0; iter < this->m_maxIterations; iter++)
+        {
+            // sums of the responsibilities, and of the responsibilities times the offsets to the
+            // current mean (and squared), the offsets keep the variance accurate
+            vtkm::Vec<vtkm::FloatDefault, K> sumR(0);
+            vtkm::Vec<vtkm::FloatDefault, K> sumRX(0);
+            vtkm::Vec<vtkm::FloatDefault, K> sumRXX(0);
+            vtkm::FloatDefault logLikelihood = 0;
+
+            for (vtkm::IdComponent index = 0; index < numValues; index++)
+            {
+                vtkm::FloatDefault v = static_cast<vtkm::FloatDefault>(originalValues[index]);
+
+                // E step
+                vtkm::Vec<vtkm::FloatDefault, K> resp;
+                vtkm::FloatDefault total = 0;
+                for (vtkm::IdComponent k = 0; k < K; k++)
+                {
+                    vtkm::FloatDefault z = (v - mean[k]) / stdev[k];
+                    resp[k] = weight[k] * invSqrt2Pi / stdev[k] * vtkm::Exp(-0.5 * z * z);
+                    total += resp[k];
+                }
+                if (total <= 0)
+                {
+                    // the value is far from all the components, share it evenly
+                    for (vtkm::IdComponent k = 0; k < K; k++)
+                    {
+                        resp[k] = vtkm::FloatDefault(1) / K;
+                    }
+                }
+                else
+                {
+                    logLikelihood += vtkm::Log(total);
+                    for (vtkm::IdComponent k = 0; k < K; k++)
+                    {
+                        resp[k] /= total;
+                    }
+                }
+
+                for (vtkm::IdComponent k = 0; k < K; k++)
+                {
+                    vtkm::FloatDefault offset = v - mean[k];
+                    sumR[k] += resp[k];
+                    sumRX[k] += resp[k] * offset;
+                    sumRXX[k] += resp[k] * offset * offset;
+                }
+            }
+
+            // M step, a component without values keeps its mean and stdev
+            for (vtkm::IdComponent k = 0; k < K; k++)
+            {
+                weight[k] = sumR[k] / numValues;
+                if (sumR[k] > 0)
+                {
+                    vtkm::FloatDefault shift = sumRX[k] / sumR[k];
+                    vtkm::FloatDefault variance = sumRXX[k] / sumR[k] - shift * shift;
+                    mean[k] += shift;
+                    stdev[k] = vtkm::Max(vtkm::Sqrt(vtkm::Max(variance, vtkm::FloatDefault(0))), minStdev);
+                }
+            }
+
+            if (vtkm::Abs(logLikelihood - prevLogLikelihood) <= this->m_tolerance * vtkm::Abs(logLikelihood))
+            {
+                break;
+            }
+            prevLogLikelihood = logLikelihood;
+        }
+
+        this->Store(weight, mean, stdev, mixture);
+    }
+
+private:
+    template <typename ParametersType, typename MixtureType>
+    VTKM_EXEC void Store(const ParametersType &weight,
+                         const ParametersType &mean,
+                         const ParametersType &stdev,
+                         MixtureType &mixture) const
+    {
+        constexpr vtkm::IdComponent K = MixtureType::NUM_COMPONENTS / 3;
+        for (vtkm::IdComponent k = 0; k < K; k++)
+        {
+            mixture[k] = weight[k];
+            mixture[K + k] = mean[k];
+            mixture[2 * K + k] = stdev[k];
+        }
+    }
+
+    vtkm::IdComponent m_maxIterations;
+    vtkm::FloatDefault m_tolerance;
+};
+
+#endif // UCV_EXTRACTING_MIXTURE_h
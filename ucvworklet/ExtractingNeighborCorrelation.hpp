@@ -0,0 +1,112 @@
+#ifndef UCV_EXTRACTING_NEIGHBOR_CORRELATION_h
+#define UCV_EXTRACTING_NEIGHBOR_CORRELATION_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+// the correlation between each block and its next block along x, y and z
+// the values of the two blocks are paired by their position in the block, like the ensembles
+// of the multivariant gaussian model (a value and the value blocksize points further)
+// the component d is 0 for the blocks without a next block along d
+struct ExtractingNeighborCorrelation : public vtkm::worklet::WorkletMapField
+{
+    VTKM_CONT ExtractingNeighborCorrelation(vtkm::Id3 rawDim, vtkm::Id3 numBlocks, vtkm::Id blocksize)
+        : m_rawDim(rawDim), m_numBlocks(numBlocks), m_blocksize(blocksize)
+    {
+    }
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename InPortalType>
+    VTKM_EXEC void operator()(const vtkm::Id &blockId, const InPortalType &inPortal, vtkm::Vec3f &correlation) const
+    {
+        vtkm::Id3 block(blockId % m_numBlocks[0],
+                        (blockId / m_numBlocks[0]) % m_numBlocks[1],
+                        blockId / (m_numBlocks[0] * m_numBlocks[1]));
+        vtkm::Id3 base = block * m_blocksize;
+
+        for (vtkm::IdComponent d = 0; d < 3; d++)
+        {
+            correlation[d] = 0;
+            if (block[d] + 1 >= m_numBlocks[d])
+            {
+                continue;
+            }
+            vtkm::Id3 shift(0);
+            shift[d] = m_blocksize;
+
+            // two passes, the means and then the (co)variances
+            vtkm::FloatDefault meanA = 0;
+            vtkm::FloatDefault meanB = 0;
+            vtkm::Id count = 0;
+            for (vtkm::Id c = 0; c < m_blocksize; c++)
+            {
+                for (vtkm::Id b = 0; b < m_blocksize; b++)
+                {
+                    for (vtkm::Id a = 0; a < m_blocksize; a++)
+                    {
+                        vtkm::Id3 pa = base + vtkm::Id3(a, b, c);
+                        vtkm::Id3 pb = pa + shift;
+                        if (this->Inside(pa) && this->Inside(pb))
+                        {
+                            meanA += static_cast<vtkm::FloatDefault>(inPortal.Get(this->PointId(pa)));
+                            meanB += static_cast<vtkm::FloatDefault>(inPortal.Get(this->PointId(pb)));
+                            count++;
+                        }
+                    }
+                }
+            }
+            if (count < 2)
+            {
+                continue;
+            }
+            meanA /= count;
+            meanB /= count;
+
+            vtkm::FloatDefault varA = 0;
+            vtkm::FloatDefault varB = 0;
+            vtkm::FloatDefault cov = 0;
+            for (vtkm::Id c = 0; c < m_blocksize; c++)
+            {
+                for (vtkm::Id b = 0; b < m_blocksize; b++)
+                {
+                    for (vtkm::Id a = 0; a < m_blocksize; a++)
+                    {
+                        vtkm::Id3 pa = base + vtkm::Id3(a, b, c);
+                        vtkm::Id3 pb = pa + shift;
+                        if (this->Inside(pa) && this->Inside(pb))
+                        {
+                            vtkm::FloatDefault va = static_cast<vtkm::FloatDefault>(inPortal.Get(this->PointId(pa))) - meanA;
+                            vtkm::FloatDefault vb = static_cast<vtkm::FloatDefault>(inPortal.Get(this->PointId(pb))) - meanB;
+                            varA += va * va;
+                            varB += vb * vb;
+                            cov += va * vb;
+                        }
+                    }
+                }
+            }
+            if (varA > 0 && varB > 0)
+            {
+                correlation[d] = cov / vtkm::Sqrt(varA * varB);
+            }
+        }
+    }
+
+private:
+    VTKM_EXEC bool Inside(const vtkm::Id3 &p) const
+    {
+        return p[0] < m_rawDim[0] && p[1] < m_rawDim[1] && p[2] < m_rawDim[2];
+    }
+
+    VTKM_EXEC vtkm::Id PointId(const vtkm::Id3 &p) const
+    {
+        return p[0] + m_rawDim[0] * (p[1] + m_rawDim[1] * p[2]);
+    }
+
+    vtkm::Id3 m_rawDim;
+    vtkm::Id3 m_numBlocks;
+    vtkm::Id m_blocksize;
+};
+
+#endif // UCV_EXTRACTING_NEIGHBOR_CORRELATION_h
@@ -0,0 +1,69 @@
+#ifndef UCV_HISTOGRAM_POINT_PROBABILITY_h
+#define UCV_HISTOGRAM_POINT_PROBABILITY_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include "EntropyFromPointProbability.hpp"
+
+// compute Pr[X<=iso] for each point from the histogram of its values (see ExtractingHistogram),
+// once per point, the cells gather them with EntropyFromPointProbability
+// the values are assumed to be uniform in each bin, so the cdf is the prefix sum of the
+// counts of the bins below the isovalue plus the part of the bin containing it
+struct HistogramPointProbability : public vtkm::worklet::WorkletMapField
+{
+    HistogramPointProbability(double isovalue)
+        : m_isovalue(isovalue){};
+
+    using ControlSignature = void(FieldIn, FieldIn, FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3, _4);
+
+    template <typename MinType, typename MaxType, typename HistogramType, typename OutProbType>
+    VTKM_EXEC void operator()(const MinType &minValue,
+                              const MaxType &maxValue,
+                              const HistogramType &histogram,
+                              OutProbType &negativeProb) const
+    {
+        vtkm::IdComponent numBins = histogram.GetNumberOfComponents();
+        vtkm::FloatDefault minV = static_cast<vtkm::FloatDefault>(minValue);
+        vtkm::FloatDefault maxV = static_cast<vtkm::FloatDefault>(maxValue);
+
+        if (this->m_isovalue < minV)
+        {
+            EncodePointProbability(vtkm::FloatDefault(0), negativeProb);
+            return;
+        }
+        if (this->m_isovalue >= maxV)
+        {
+            EncodePointProbability(vtkm::FloatDefault(1), negativeProb);
+            return;
+        }
+
+        // the bin containing the isovalue and the position in this bin
+        vtkm::FloatDefault position = (static_cast<vtkm::FloatDefault>(this->m_isovalue) - minV) / (maxV - minV) * numBins;
+        vtkm::IdComponent isoBin = static_cast<vtkm::IdComponent>(position);
+        isoBin = (isoBin < numBins) ? isoBin : numBins - 1;
+
+        vtkm::FloatDefault total = 0;
+        vtkm::FloatDefault below = 0;
+        for (vtkm::IdComponent bin = 0; bin < numBins; bin++)
+        {
+            vtkm::FloatDefault count = static_cast<vtkm::FloatDefault>(histogram[bin]);
+            total += count;
+            if (bin < isoBin)
+            {
+                below += count;
+            }
+            else if (bin == isoBin)
+            {
+                below += count * (position - isoBin);
+            }
+        }
+
+        EncodePointProbability(below / total, negativeProb);
+    }
+
+private:
+    double m_isovalue;
+};
+
+#endif // UCV_HISTOGRAM_POINT_PROBABILITY_h
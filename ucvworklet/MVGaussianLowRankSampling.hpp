@@ -0,0 +1,136 @@
+#ifndef UCV_MULTIVARIANT_GAUSSIAN_LOW_RANK_SAMPLING_h
+#define UCV_MULTIVARIANT_GAUSSIAN_LOW_RANK_SAMPLING_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapTopology.h>
+
+#ifdef VTKM_CUDA
+#include <thrust/random/linear_congruential_engine.h>
+#include <thrust/random/normal_distribution.h>
+#else
+// using the std library
+#include <random>
+#endif // VTKM_CUDA
+
+// the multivariant gaussian of a cell when the ensemble is given by its principal components
+// (see ProjectingEnsemble), the covariance of the points of the cell is U U^T + D, where the row
+// i of U is the coefficients of the point i and D is the diagonal of the residuals
+// a sample is mean + U z + sqrt(D) e with z of size Rank and e of size numVertices, so the
+// covariance matrix is never built and no cholesky or eigen decomposition is needed
+// it works for the quads of 2d grids and the hexahedra of 3d grids, the outputs are the same
+// as MVGaussianWithEnsemble3DSampling
+template <vtkm::IdComponent Rank>
+class MVGaussianLowRankSampling : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+    MVGaussianLowRankSampling(double isovalue, int numSamples)
+        : m_isovalue(isovalue), m_numSamples(numSamples){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldOutCell,
+                                  FieldOutCell,
+                                  FieldOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5, _6, _7);
+
+    using InputDomain = _1;
+
+    template <typename InPointFieldMeanType,
+              typename InPointFieldCoefficientsType,
+              typename InPointFieldResidualType,
+              typename OutCellFieldType1,
+              typename OutCellFieldType2,
+              typename OutCellFieldType3>
+    VTKM_EXEC void operator()(
+        const InPointFieldMeanType &inPointFieldVecMean,
+        const InPointFieldCoefficientsType &inPointFieldVecCoefficients,
+        const InPointFieldResidualType &inPointFieldVecResidual,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy) const
+    {
+        const vtkm::IdComponent numVertices = inPointFieldVecMean.GetNumberOfComponents();
+        if (numVertices != 4 && numVertices != 8)
+        {
+            printf("MVGaussianLowRankSampling expects 4 or 8 vertecies\n");
+            return;
+        }
+        const vtkm::IdComponent numCases = 1 << numVertices;
+
+        vtkm::Vec<vtkm::FloatDefault, 8> mean;
+        vtkm::Vec<vtkm::FloatDefault, 8> residualStdev;
+        vtkm::Vec<vtkm::Vec<vtkm::FloatDefault, Rank>, 8> factor;
+        for (vtkm::IdComponent i = 0; i < numVertices; i++)
+        {
+            mean[i] = static_cast<vtkm::FloatDefault>(inPointFieldVecMean[i]);
+            residualStdev[i] = vtkm::Sqrt(static_cast<vtkm::FloatDefault>(inPointFieldVecResidual[i]));
+            for (vtkm::IdComponent r = 0; r < Rank; r++)
+            {
+                factor[i][r] = static_cast<vtkm::FloatDefault>(inPointFieldVecCoefficients[i][r]);
+            }
+        }
+
+#ifdef VTKM_CUDA
+        thrust::minstd_rand rng;
+        thrust::random::normal_distribution<double> norm;
+#else
+        std::mt19937 rng;
+        rng.seed(std::mt19937::default_seed);
+        std::normal_distribution<double> norm;
+#endif // VTKM_CUDA
+
+        vtkm::Vec<vtkm::FloatDefault, 256> probHistogram(0);
+        vtkm::Vec<vtkm::FloatDefault, Rank> z;
+        for (vtkm::Id n = 0; n < this->m_numSamples; ++n)
+        {
+            for (vtkm::IdComponent r = 0; r < Rank; r++)
+            {
+                z[r] = static_cast<vtkm::FloatDefault>(norm(rng));
+            }
+
+            // setting associated position to 1 if iso larger then specific cases
+            vtkm::UInt32 caseValue = 0;
+            for (vtkm::IdComponent i = 0; i < numVertices; i++)
+            {
+                vtkm::FloatDefault sample =
+                    mean[i] + vtkm::Dot(factor[i], z) + residualStdev[i] * static_cast<vtkm::FloatDefault>(norm(rng));
+                if (m_isovalue >= sample)
+                {
+                    caseValue = (1 << i) | caseValue;
+                }
+            }
+            probHistogram[caseValue] = probHistogram[caseValue] + 1.0;
+        }
+
+        for (int i = 0; i < numCases; i++)
+        {
+            probHistogram[i] = (probHistogram[i] / (1.0 * this->m_numSamples));
+        }
+
+        // cross probability
+        outCellFieldCProb = 1.0 - (probHistogram[0] + probHistogram[numCases - 1]);
+
+        vtkm::Id nonzeroCases = 0;
+        vtkm::FloatDefault entropyValue = 0;
+        for (int i = 0; i < numCases; i++)
+        {
+            if (probHistogram[i] > 0.0001)
+            {
+                nonzeroCases++;
+                entropyValue = entropyValue - probHistogram[i] * vtkm::Log2(probHistogram[i]);
+            }
+        }
+
+        outCellFieldNumNonzeroProb = nonzeroCases;
+        outCellFieldEntropy = entropyValue;
+    }
+
+private:
+    double m_isovalue;
+    int m_numSamples;
+};
+
+#endif // UCV_MULTIVARIANT_GAUSSIAN_LOW_RANK_SAMPLING_h
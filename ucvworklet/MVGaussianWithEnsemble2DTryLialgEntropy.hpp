@@ -58,6 +58,23 @@ public:
         meanArray[2] = find_mean<VecType>(inPointFieldVecEnsemble[updateIndex4(2)]);
         meanArray[3] = find_mean<VecType>(inPointFieldVecEnsemble[updateIndex4(3)]);
 
+        this->ComputeWithMean(inPointFieldVecEnsemble, meanArray, outCellFieldCProb, outCellFieldNumNonzeroProb, outCellFieldEntropy);
+    }
+
+    // the sampling and the classification once the means of the 4 vertexies are known,
+    // the means are in the order of updateIndex4
+    template <typename InPointFieldVecEnsemble,
+              typename OutCellFieldType1,
+              typename OutCellFieldType2,
+              typename OutCellFieldType3>
+    VTKM_EXEC void ComputeWithMean(
+        const InPointFieldVecEnsemble &inPointFieldVecEnsemble,
+        const vtkm::Vec4f_64 &meanArray,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy) const
+    {
+        using VecType = decltype(inPointFieldVecEnsemble[0]);
 
         // set the trim options to filter the 0 values
         if (fabs(meanArray[0]) < 0.000001 && fabs(meanArray[1]) < 0.000001 && fabs(meanArray[2]) < 0.000001 && fabs(meanArray[3]) < 0.000001)
@@ -245,7 +262,7 @@ public:
     }
     template <typename VecType>
     VTKM_EXEC double find_covariance(const VecType &arr1, const VecType &arr2,
-                                     double &mean1, double &mean2) const
+                                     const double &mean1, const double &mean2) const
     {
         if (arr1.GetNumberOfComponents() != arr2.GetNumberOfComponents())
         {
@@ -265,4 +282,52 @@ private:
     int m_num_sample = 1000;
 };
 
+// the same computation when the mean of each point is given as a point field (for example
+// by the EnsembleStatistics filter), the mean of a point is computed once instead of once
+// for each of the 4 cells that share it
+class MVGaussianWithEnsemble2DTryLialgEntropyWithMean : public MVGaussianWithEnsemble2DTryLialgEntropy
+{
+public:
+    MVGaussianWithEnsemble2DTryLialgEntropyWithMean(double isovalue, int num_sample)
+        : MVGaussianWithEnsemble2DTryLialgEntropy(isovalue, num_sample){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldOutCell,
+                                  FieldOutCell,
+                                  FieldOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5, _6);
+
+    using InputDomain = _1;
+
+    template <typename InPointFieldVecEnsemble,
+              typename InPointFieldVecMean,
+              typename OutCellFieldType1,
+              typename OutCellFieldType2,
+              typename OutCellFieldType3>
+    VTKM_EXEC void operator()(
+        const InPointFieldVecEnsemble &inPointFieldVecEnsemble,
+        const InPointFieldVecMean &inPointFieldVecMean,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy) const
+    {
+        if (inPointFieldVecEnsemble.GetNumberOfComponents() != 4)
+        {
+            printf("the MVGaussianWithEnsemble2DTryLialg only support cell with 4 vertexies");
+            return;
+        }
+
+        vtkm::Vec4f_64 meanArray;
+        for (int i = 0; i < 4; i++)
+        {
+            meanArray[i] = static_cast<vtkm::Float64>(inPointFieldVecMean[this->updateIndex4(i)]);
+        }
+
+        this->ComputeWithMean(inPointFieldVecEnsemble, meanArray, outCellFieldCProb, outCellFieldNumNonzeroProb, outCellFieldEntropy);
+    }
+};
+
 #endif // UCV_MULTIVARIANT_GAUSSIAN2D_h
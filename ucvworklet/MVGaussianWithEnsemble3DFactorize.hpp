@@ -0,0 +1,98 @@
+#ifndef UCV_MULTIVARIANT_GAUSSIAN3D_FACTORIZE_h
+#define UCV_MULTIVARIANT_GAUSSIAN3D_FACTORIZE_h
+
+#include <vtkm/worklet/WorkletMapTopology.h>
+#include <cmath>
+#include "./linalg/ucv_matrix_static_8by8.h"
+
+// first stage of the MVGaussianWithEnsemble3DTryLialg
+// it computes the mean vector and the factor A (A*A^t = cov) for each cell
+// these only depend on the data and not on the isovalue, so they can be
+// kept and reused by MVGaussianWithEnsemble3DSampling when only the isovalue changes
+class MVGaussianWithEnsemble3DFactorize : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+    MVGaussianWithEnsemble3DFactorize(){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldOutCell,
+                                  FieldOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5);
+
+    // the first parameter is binded with the worklet
+    using InputDomain = _1;
+    // InPointFieldType should be a vector
+    template <typename InPointFieldVecEnsemble,
+              typename InPointFieldVecMean>
+    VTKM_EXEC void operator()(
+        const InPointFieldVecEnsemble &inPointFieldVecEnsemble,
+        const InPointFieldVecMean &inMeanArray,
+        vtkm::Vec<vtkm::Float64, 8> &outCellMean,
+        vtkm::Vec<vtkm::Float64, 64> &outCellFactor) const
+    {
+        vtkm::IdComponent numVertexies = inPointFieldVecEnsemble.GetNumberOfComponents();
+        const uint8_t numVertex3d = 8;
+        if (numVertexies != numVertex3d)
+        {
+            printf("MVGaussianWithEnsemble3DFactorize expects 8 vertecies\n");
+            return;
+        }
+
+        if (inMeanArray.GetNumberOfComponents() != numVertex3d)
+        {
+            printf("inMeanArray in MVGaussianWithEnsemble3DFactorize expects 8 vertecies\n");
+            return;
+        }
+
+        if (inPointFieldVecEnsemble[0].GetNumberOfComponents() != numVertex3d * numVertex3d)
+        {
+            printf("only support ensemble size 64 for blockSize equals to 4\n");
+            return;
+        }
+
+        // generate mean and cov matrix
+        UCVMATH::mat_t ucvcov8by8;
+        for (int p = 0; p < numVertex3d; ++p)
+        {
+            outCellMean[p] = inMeanArray[p];
+            for (int q = p; q < numVertex3d; ++q)
+            {
+                // use the elements at the top half
+                // keep the float precision used by MVGaussianWithEnsemble3DTryLialg so results match
+                float cov = find_covariance(inPointFieldVecEnsemble[p], inPointFieldVecEnsemble[q], inMeanArray[p], inMeanArray[q]);
+                ucvcov8by8.v[p][q] = cov;
+                if (p != q)
+                {
+                    // assign value to another helf
+                    ucvcov8by8.v[q][p] = ucvcov8by8.v[p][q];
+                }
+            }
+        }
+
+        UCVMATH::mat_t A = UCVMATH::eigen_vector_decomposition(&ucvcov8by8);
+
+        for (int p = 0; p < numVertex3d; ++p)
+        {
+            for (int q = 0; q < numVertex3d; ++q)
+            {
+                outCellFactor[p * numVertex3d + q] = A.v[p][q];
+            }
+        }
+    }
+
+    template <typename T>
+    VTKM_EXEC inline vtkm::FloatDefault find_covariance(const vtkm::Vec<T, 64> &arr1, const vtkm::Vec<T, 64> &arr2,
+                                                        const T &mean1, const T &mean2) const
+    {
+        vtkm::Id arraySize = arr1.GetNumberOfComponents();
+        vtkm::FloatDefault sum = 0;
+        for (int i = 0; i < arraySize; i++)
+            sum = sum + (arr1[i] - mean1) * (arr2[i] - mean2);
+        return sum / (vtkm::FloatDefault)(arraySize - 1);
+    }
+};
+
+#endif // UCV_MULTIVARIANT_GAUSSIAN3D_FACTORIZE_h
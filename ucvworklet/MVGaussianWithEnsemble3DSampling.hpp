@@ -0,0 +1,212 @@
+#ifndef UCV_MULTIVARIANT_GAUSSIAN3D_SAMPLING_h
+#define UCV_MULTIVARIANT_GAUSSIAN3D_SAMPLING_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+#include <cmath>
+#include "./linalg/ucv_matrix_static_8by8.h"
+
+// the probability of each case of a cell from the samples of its multivariant gaussian,
+// the bit i of the case is set when the point i is below or at the isovalue
+// a seed of 0 keeps the default seed of the generator, which the other samplers use
+VTKM_EXEC inline void MVGaussianWithEnsemble3DCaseHistogram(
+    const vtkm::Vec<vtkm::Float64, 8> &inCellMean,
+    const vtkm::Vec<vtkm::Float64, 64> &inCellFactor,
+    double isovalue,
+    int numSamples,
+    vtkm::UInt32 seed,
+    vtkm::Vec<vtkm::FloatDefault, 256> &probHistogram)
+{
+    const uint8_t numVertex3d = 8;
+
+    UCVMATH::vec_t ucvmeanv;
+    UCVMATH::mat_t A;
+    for (int p = 0; p < numVertex3d; ++p)
+    {
+        ucvmeanv.v[p] = inCellMean[p];
+        for (int q = 0; q < numVertex3d; ++q)
+        {
+            A.v[p][q] = inCellFactor[p * numVertex3d + q];
+        }
+    }
+
+    UCVMATH::vec_t sample_v;
+    UCVMATH::vec_t AUM;
+
+#ifdef VTKM_CUDA
+    thrust::minstd_rand rng;
+    thrust::random::normal_distribution<double> norm;
+#else
+    std::mt19937 rng;
+    rng.seed(std::mt19937::default_seed);
+    std::normal_distribution<double> norm;
+#endif // VTKM_CUDA
+    if (seed != 0)
+    {
+        rng.seed(seed);
+    }
+
+    // init to 0
+    for (int i = 0; i < 256; i++)
+    {
+        probHistogram[i] = 0.0;
+    }
+
+    for (vtkm::Id n = 0; n < numSamples; ++n)
+    {
+        for (int i = 0; i < numVertex3d; i++)
+        {
+            sample_v.v[i] = norm(rng);
+        }
+
+        AUM = UCVMATH::matrix_mul_vec_add_vec(&A, &sample_v, &ucvmeanv);
+
+        // go through 8 cases
+        uint caseValue = 0;
+        for (uint i = 0; i < 8; i++)
+        {
+            // setting associated position to 1 if iso larger then specific cases
+            if (isovalue >= AUM.v[i])
+            {
+                caseValue = (1 << i) | caseValue;
+            }
+        }
+
+        // the associated pos is 0 otherwise
+        probHistogram[caseValue] = probHistogram[caseValue] + 1.0;
+    }
+
+    // go through probHistogram and compute pro
+    for (int i = 0; i < 256; i++)
+    {
+        probHistogram[i] = (probHistogram[i] / (1.0 * numSamples));
+    }
+}
+
+// second stage of the MVGaussianWithEnsemble3DTryLialg
+// it takes the mean vector and the factor A computed by the MVGaussianWithEnsemble3DFactorize
+// and only does the sampling and the classification for the isovalue
+// the samples are the same with the MVGaussianWithEnsemble3DTryLialg, so the results match
+// a nonzero seed gives a random sequence independent of the other samplers (e.g. for a reference)
+class MVGaussianWithEnsemble3DSampling : public vtkm::worklet::WorkletMapField
+{
+public:
+    MVGaussianWithEnsemble3DSampling(double isovalue, int numSamples, vtkm::UInt32 seed = 0)
+        : m_isovalue(isovalue), m_numSamples(numSamples), m_seed(seed){};
+
+    using ControlSignature = void(FieldIn,
+                                  FieldIn,
+                                  FieldOut,
+                                  FieldOut,
+                                  FieldOut);
+
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    template <typename OutCellFieldType1,
+              typename OutCellFieldType2,
+              typename OutCellFieldType3>
+    VTKM_EXEC void operator()(
+        const vtkm::Vec<vtkm::Float64, 8> &inCellMean,
+        const vtkm::Vec<vtkm::Float64, 64> &inCellFactor,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy) const
+    {
+        vtkm::Vec<vtkm::FloatDefault, 256> probHistogram;
+        MVGaussianWithEnsemble3DCaseHistogram(inCellMean, inCellFactor, m_isovalue, m_numSamples, m_seed, probHistogram);
+        SummarizeHistogram(probHistogram, outCellFieldCProb, outCellFieldNumNonzeroProb, outCellFieldEntropy);
+    }
+
+    // the cross probability, the number of nonzero cases and the entropy of the case histogram
+    template <typename OutCellFieldType1,
+              typename OutCellFieldType2,
+              typename OutCellFieldType3>
+    VTKM_EXEC static void SummarizeHistogram(
+        const vtkm::Vec<vtkm::FloatDefault, 256> &probHistogram,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy)
+    {
+        // cross probability
+        outCellFieldCProb = 1.0 - (probHistogram[0] + probHistogram[255]);
+
+        vtkm::Id nonzeroCases = 0;
+        vtkm::FloatDefault entropyValue = 0;
+        vtkm::FloatDefault templog = 0;
+        // compute number of nonzero cases
+        // compute entropy
+        for (int i = 0; i < 256; i++)
+        {
+            if (probHistogram[i] > 0.0001)
+            {
+                nonzeroCases++;
+                templog = vtkm::Log2(probHistogram[i]);
+            }
+            // do not update entropy if the pro is zero
+            entropyValue = entropyValue + (-probHistogram[i]) * templog;
+        }
+
+        outCellFieldNumNonzeroProb = nonzeroCases;
+        outCellFieldEntropy = entropyValue;
+    }
+
+private:
+    double m_isovalue;
+    int m_numSamples;
+    vtkm::UInt32 m_seed;
+};
+
+// same as MVGaussianWithEnsemble3DSampling, and also writes the most frequent case of the
+// samples and its probability, so the most probable contour geometry does not sample again
+// the case follows the marching cells tables of vtkm (the bit i is set when the point i is
+// above the isovalue), which is the complement of the histogram index
+class MVGaussianWithEnsemble3DSamplingWithCase : public vtkm::worklet::WorkletMapField
+{
+public:
+    MVGaussianWithEnsemble3DSamplingWithCase(double isovalue, int numSamples)
+        : m_isovalue(isovalue), m_numSamples(numSamples){};
+
+    using ControlSignature = void(FieldIn,
+                                  FieldIn,
+                                  FieldOut,
+                                  FieldOut,
+                                  FieldOut,
+                                  FieldOut,
+                                  FieldOut);
+
+    using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7);
+
+    template <typename OutCellFieldType1,
+              typename OutCellFieldType2,
+              typename OutCellFieldType3>
+    VTKM_EXEC void operator()(
+        const vtkm::Vec<vtkm::Float64, 8> &inCellMean,
+        const vtkm::Vec<vtkm::Float64, 64> &inCellFactor,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy,
+        vtkm::UInt8 &caseNumber,
+        vtkm::FloatDefault &caseProb) const
+    {
+        vtkm::Vec<vtkm::FloatDefault, 256> probHistogram;
+        MVGaussianWithEnsemble3DCaseHistogram(inCellMean, inCellFactor, m_isovalue, m_numSamples, 0, probHistogram);
+        MVGaussianWithEnsemble3DSampling::SummarizeHistogram(
+            probHistogram, outCellFieldCProb, outCellFieldNumNonzeroProb, outCellFieldEntropy);
+
+        int maxIndex = 0;
+        for (int i = 1; i < 256; i++)
+        {
+            if (probHistogram[i] > probHistogram[maxIndex])
+            {
+                maxIndex = i;
+            }
+        }
+        caseNumber = static_cast<vtkm::UInt8>(255 - maxIndex);
+        caseProb = probHistogram[maxIndex];
+    }
+
+private:
+    double m_isovalue;
+    int m_numSamples;
+};
+
+#endif // UCV_MULTIVARIANT_GAUSSIAN3D_SAMPLING_h
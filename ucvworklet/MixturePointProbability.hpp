@@ -0,0 +1,50 @@
+#ifndef UCV_MIXTURE_POINT_PROBABILITY_h
+#define UCV_MIXTURE_POINT_PROBABILITY_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include "EntropyFromPointProbability.hpp"
+
+// compute Pr[X<=iso] for each point with the gaussian mixture fitted by ExtractingMixture,
+// the cdf of the mixture is the weighted sum of the cdf of its components, so it is computed
+// in closed form once per point, the cells gather them with EntropyFromPointProbability
+struct MixturePointProbability : public vtkm::worklet::WorkletMapField
+{
+    MixturePointProbability(double isovalue)
+        : m_isovalue(isovalue){};
+
+    using ControlSignature = void(FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2);
+
+    template <typename MixtureType, typename OutProbType>
+    VTKM_EXEC void operator()(const MixtureType &mixture, OutProbType &negativeProb) const
+    {
+        constexpr vtkm::IdComponent K = MixtureType::NUM_COMPONENTS / 3;
+        vtkm::FloatDefault iso = static_cast<vtkm::FloatDefault>(this->m_isovalue);
+
+        vtkm::FloatDefault prob = 0;
+        for (vtkm::IdComponent k = 0; k < K; k++)
+        {
+            vtkm::FloatDefault weight = static_cast<vtkm::FloatDefault>(mixture[k]);
+            vtkm::FloatDefault mean = static_cast<vtkm::FloatDefault>(mixture[K + k]);
+            vtkm::FloatDefault stdev = static_cast<vtkm::FloatDefault>(mixture[2 * K + k]);
+            if (stdev <= 0)
+            {
+                // a component without variance is a step at its mean
+                prob += (iso >= mean) ? weight : vtkm::FloatDefault(0);
+            }
+            else
+            {
+                prob += weight * 0.5 * (1 + vtkm::ERF((iso - mean) / (vtkm::Sqrt(vtkm::FloatDefault(2)) * stdev)));
+            }
+        }
+
+        EncodePointProbability(vtkm::Min(vtkm::Max(prob, vtkm::FloatDefault(0)), vtkm::FloatDefault(1)), negativeProb);
+    }
+
+private:
+    double m_isovalue;
+};
+
+#endif // UCV_MIXTURE_POINT_PROBABILITY_h
@@ -0,0 +1,251 @@
+#ifndef UCV_MOST_PROBABLE_CASE_h
+#define UCV_MOST_PROBABLE_CASE_h
+
+#include <vtkm/CellShape.h>
+#include <vtkm/filter/contour/worklet/contour/MarchingCellTables.h>
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/ScatterCounting.h>
+#include <vtkm/worklet/WorkletMapTopology.h>
+#include "./EdgeCrossing.hpp"
+#include "./linalg/ucv_matrix_static_8by8.h"
+
+// the cases follow the marching cells tables of vtkm,
+// the bit i of the case is set when the point i is above the isovalue
+
+// the crossing positions of the multivariant gaussian model only use the mean of the points,
+// the mean field is given as both parameters of EdgeCrossingStructured
+// the most probable case comes from the samples, so a point can be on the other side of the
+// isovalue than its mean and the means of a crossed edge can be on the same side, the
+// position is then still inside the edge (see ComputeEdgeCrossing)
+struct EnsembleMeanEdgeModel
+{
+    VTKM_EXEC static vtkm::FloatDefault NegativeProb(vtkm::FloatDefault mean, vtkm::FloatDefault, vtkm::FloatDefault isovalue)
+    {
+        return (mean < isovalue) ? 1.0 : 0.0;
+    }
+
+    VTKM_EXEC static vtkm::FloatDefault Mean(vtkm::FloatDefault mean, vtkm::FloatDefault)
+    {
+        return mean;
+    }
+};
+
+// the most probable case of a hexahedron with independent points,
+// the probability of a case is the product of the probabilities of its points,
+// so the most probable case takes the most probable side of each point and
+// the 256 entries of the case histogram do not need to be built
+template <typename ModelType>
+class MostProbableCaseIndependent : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+    MostProbableCaseIndependent(double isovalue)
+        : m_isovalue(isovalue){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldOutCell,
+                                  FieldOutCell,
+                                  FieldOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5, _6);
+
+    using InputDomain = _1;
+
+    template <typename InPointFieldType0, typename InPointFieldType1>
+    VTKM_EXEC void operator()(const InPointFieldType0 &inPointField0,
+                              const InPointFieldType1 &inPointField1,
+                              vtkm::UInt8 &caseNumber,
+                              vtkm::FloatDefault &caseProb,
+                              vtkm::IdComponent &numTriangles) const
+    {
+        caseNumber = 0;
+        caseProb = 1.0;
+        for (vtkm::IdComponent i = 0; i < 8; i++)
+        {
+            vtkm::FloatDefault negativeProb = ModelType::NegativeProb(
+                static_cast<vtkm::FloatDefault>(inPointField0[i]),
+                static_cast<vtkm::FloatDefault>(inPointField1[i]),
+                static_cast<vtkm::FloatDefault>(m_isovalue));
+            if (negativeProb < 0.5)
+            {
+                caseNumber = static_cast<vtkm::UInt8>(caseNumber | (1 << i));
+                caseProb *= (1 - negativeProb);
+            }
+            else
+            {
+                caseProb *= negativeProb;
+            }
+        }
+        numTriangles = vtkm::worklet::marching_cells::GetNumTrianglesPerCase(vtkm::CELL_SHAPE_HEXAHEDRON, caseNumber);
+    }
+
+private:
+    double m_isovalue;
+};
+
+// the most probable case of a hexahedron from the case histogram of the samples of the
+// multivariant gaussian distribution, it takes the mean vector and the factor A computed by
+// MVGaussianWithEnsemble3DFactorize and draws the same samples as MVGaussianWithEnsemble3DSampling
+class MVGaussianWithEnsemble3DMostProbableCase : public vtkm::worklet::WorkletMapField
+{
+public:
+    MVGaussianWithEnsemble3DMostProbableCase(double isovalue, int numSamples)
+        : m_isovalue(isovalue), m_numSamples(numSamples){};
+
+    using ControlSignature = void(FieldIn,
+                                  FieldIn,
+                                  FieldOut,
+                                  FieldOut,
+                                  FieldOut);
+
+    using ExecutionSignature = void(_1, _2, _3, _4, _5);
+
+    VTKM_EXEC void operator()(
+        const vtkm::Vec<vtkm::Float64, 8> &inCellMean,
+        const vtkm::Vec<vtkm::Float64, 64> &inCellFactor,
+        vtkm::UInt8 &caseNumber,
+        vtkm::FloatDefault &caseProb,
+        vtkm::IdComponent &numTriangles) const
+    {
+        const uint8_t numVertex3d = 8;
+
+        UCVMATH::vec_t ucvmeanv;
+        UCVMATH::mat_t A;
+        for (int p = 0; p < numVertex3d; ++p)
+        {
+            ucvmeanv.v[p] = inCellMean[p];
+            for (int q = 0; q < numVertex3d; ++q)
+            {
+                A.v[p][q] = inCellFactor[p * numVertex3d + q];
+            }
+        }
+
+        UCVMATH::vec_t sample_v;
+        UCVMATH::vec_t AUM;
+
+#ifdef VTKM_CUDA
+        thrust::minstd_rand rng;
+        thrust::random::normal_distribution<double> norm;
+#else
+        std::mt19937 rng;
+        rng.seed(std::mt19937::default_seed);
+        std::normal_distribution<double> norm;
+#endif // VTKM_CUDA
+
+        vtkm::Vec<vtkm::Id, 256> caseHistogram;
+        for (int i = 0; i < 256; i++)
+        {
+            caseHistogram[i] = 0;
+        }
+
+        for (vtkm::Id n = 0; n < this->m_numSamples; ++n)
+        {
+            for (int i = 0; i < numVertex3d; i++)
+            {
+                sample_v.v[i] = norm(rng);
+            }
+
+            AUM = UCVMATH::matrix_mul_vec_add_vec(&A, &sample_v, &ucvmeanv);
+
+            vtkm::UInt8 sampleCase = 0;
+            for (int i = 0; i < numVertex3d; i++)
+            {
+                if (AUM.v[i] > m_isovalue)
+                {
+                    sampleCase = static_cast<vtkm::UInt8>(sampleCase | (1 << i));
+                }
+            }
+            caseHistogram[sampleCase]++;
+        }
+
+        vtkm::Id maxCount = -1;
+        for (int i = 0; i < 256; i++)
+        {
+            if (caseHistogram[i] > maxCount)
+            {
+                maxCount = caseHistogram[i];
+                caseNumber = static_cast<vtkm::UInt8>(i);
+            }
+        }
+        caseProb = static_cast<vtkm::FloatDefault>(maxCount) / static_cast<vtkm::FloatDefault>(this->m_numSamples);
+        numTriangles = vtkm::worklet::marching_cells::GetNumTrianglesPerCase(vtkm::CELL_SHAPE_HEXAHEDRON, caseNumber);
+    }
+
+private:
+    double m_isovalue;
+    int m_numSamples;
+};
+
+// the number of triangles of cases that are already known, e.g. the most probable cases
+// written by ContourUncertainEnsemble
+struct NumTrianglesOfCase : public vtkm::worklet::WorkletMapField
+{
+    using ControlSignature = void(FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2);
+
+    VTKM_EXEC void operator()(const vtkm::UInt8 &caseNumber, vtkm::IdComponent &numTriangles) const
+    {
+        numTriangles = vtkm::worklet::marching_cells::GetNumTrianglesPerCase(vtkm::CELL_SHAPE_HEXAHEDRON, caseNumber);
+    }
+};
+
+// the second pass, it is scheduled with a ScatterCounting on the number of triangles of each
+// cell and writes the three edges of a triangle, as ids of StructuredEdgeIndexing so the
+// triangles of neighboring cells share their vertices
+class GenerateProbableTriangles : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+    GenerateProbableTriangles(vtkm::Id3 pointDims)
+        : m_indexing(pointDims), m_pointDims(pointDims){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInCell,
+                                  FieldInCell,
+                                  FieldOutCell,
+                                  FieldOutCell);
+
+    using ExecutionSignature = void(InputIndex, VisitIndex, _2, _3, _4, _5);
+
+    using InputDomain = _1;
+    using ScatterType = vtkm::worklet::ScatterCounting;
+
+    template <typename OutEdgeIdsType, typename OutProbType>
+    VTKM_EXEC void operator()(const vtkm::Id &cellId,
+                              const vtkm::IdComponent &triangleIndex,
+                              const vtkm::UInt8 &caseNumber,
+                              const vtkm::FloatDefault &caseProb,
+                              OutEdgeIdsType &outEdgeIds,
+                              OutProbType &outTriangleProb) const
+    {
+        // the offsets of the points of a hexahedron (vtk order)
+        const vtkm::IdComponent offsets[8][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 1, 0, 1 }, { 1, 1, 1 }, { 0, 1, 1 } };
+
+        vtkm::Id cellDimX = m_pointDims[0] - 1;
+        vtkm::Id cellDimY = m_pointDims[1] - 1;
+        vtkm::Id i = cellId % cellDimX;
+        vtkm::Id j = (cellId / cellDimX) % cellDimY;
+        vtkm::Id k = cellId / (cellDimX * cellDimY);
+
+        const auto &triangleEdges = vtkm::worklet::marching_cells::GetTriangleEdges(vtkm::CELL_SHAPE_HEXAHEDRON, caseNumber, triangleIndex);
+        for (vtkm::IdComponent v = 0; v < 3; v++)
+        {
+            const auto &edgeVertices = vtkm::worklet::marching_cells::GetEdgeVertices(vtkm::CELL_SHAPE_HEXAHEDRON, triangleEdges[v]);
+            const vtkm::IdComponent *a = offsets[edgeVertices[0]];
+            const vtkm::IdComponent *b = offsets[edgeVertices[1]];
+            // the two points differ along one direction, the edge starts at the smaller one
+            vtkm::IdComponent direction = (a[0] != b[0]) ? 0 : ((a[1] != b[1]) ? 1 : 2);
+            outEdgeIds[v] = m_indexing.EdgeId(i + vtkm::Min(a[0], b[0]),
+                                              j + vtkm::Min(a[1], b[1]),
+                                              k + vtkm::Min(a[2], b[2]),
+                                              direction);
+        }
+        outTriangleProb = caseProb;
+    }
+
+private:
+    StructuredEdgeIndexing m_indexing;
+    vtkm::Id3 m_pointDims;
+};
+
+#endif // UCV_MOST_PROBABLE_CASE_h
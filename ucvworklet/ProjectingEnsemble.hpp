@@ -0,0 +1,108 @@
+#ifndef UCV_PROJECTING_ENSEMBLE_h
+#define UCV_PROJECTING_ENSEMBLE_h
+
+#include <vtkm/VecTraits.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+// a partial sum of the gram matrix of the centered members, each work item sums the
+// product of the members a and b of one pair (the upper triangle, a <= b, row by row) over one
+// chunk of the points, the index is pair * numChunks + chunk, so the partial sums of a pair are
+// contiguous and are added with one reduce by key (see GramPairOfPartialSum)
+struct EnsembleGramPartialSum : public vtkm::worklet::WorkletMapField
+{
+    EnsembleGramPartialSum(vtkm::IdComponent numMembers, vtkm::Id numPoints, vtkm::Id numChunks)
+        : m_numMembers(numMembers), m_numPoints(numPoints), m_numChunks(numChunks){};
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename CenteredPortalType>
+    VTKM_EXEC void operator()(const vtkm::Id &index,
+                              const CenteredPortalType &centered,
+                              vtkm::Float64 &partialSum) const
+    {
+        vtkm::Id pair = index / this->m_numChunks;
+        vtkm::Id chunk = index % this->m_numChunks;
+
+        // the row a of the upper triangle has numMembers - a pairs
+        vtkm::IdComponent a = 0;
+        while (pair >= this->m_numMembers - a)
+        {
+            pair -= this->m_numMembers - a;
+            a++;
+        }
+        vtkm::IdComponent b = a + static_cast<vtkm::IdComponent>(pair);
+
+        vtkm::Id chunkSize = (this->m_numPoints + this->m_numChunks - 1) / this->m_numChunks;
+        vtkm::Id begin = chunk * chunkSize;
+        vtkm::Id end = vtkm::Min(begin + chunkSize, this->m_numPoints);
+
+        using Traits = vtkm::VecTraits<typename CenteredPortalType::ValueType>;
+        partialSum = 0;
+        for (vtkm::Id p = begin; p < end; p++)
+        {
+            auto members = centered.Get(p);
+            partialSum += static_cast<vtkm::Float64>(Traits::GetComponent(members, a)) *
+                          static_cast<vtkm::Float64>(Traits::GetComponent(members, b));
+        }
+    }
+
+private:
+    vtkm::IdComponent m_numMembers;
+    vtkm::Id m_numPoints;
+    vtkm::Id m_numChunks;
+};
+
+// the pair of a partial sum of EnsembleGramPartialSum, the key of the reduction
+struct GramPairOfPartialSum
+{
+    vtkm::Id NumChunks;
+
+    VTKM_EXEC_CONT vtkm::Id operator()(vtkm::Id index) const { return index / this->NumChunks; }
+};
+
+// the coordinates of the centered members of a point in the first Rank principal directions of
+// the ensemble, the basis is stored member by member (Rank values per member) and already
+// divided by sqrt(numMembers - 1), so the covariance of two points is approximated by the dot
+// product of their coefficients, the residual is the variance of the point that is not captured
+// by the coefficients, it is kept as an independent noise for each point
+template <vtkm::IdComponent Rank>
+struct ProjectingEnsemble : public vtkm::worklet::WorkletMapField
+{
+    using ControlSignature = void(FieldIn, WholeArrayIn, FieldOut, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3, _4);
+
+    template <typename CenteredType, typename BasisPortalType>
+    VTKM_EXEC void operator()(const CenteredType &centered,
+                              const BasisPortalType &basis,
+                              vtkm::Vec<vtkm::FloatDefault, Rank> &coefficients,
+                              vtkm::FloatDefault &residual) const
+    {
+        using Traits = vtkm::VecTraits<CenteredType>;
+        vtkm::IdComponent numMembers = Traits::GetNumberOfComponents(centered);
+
+        vtkm::Vec<vtkm::Float64, Rank> projection(0);
+        vtkm::Float64 variance = 0;
+        for (vtkm::IdComponent m = 0; m < numMembers; m++)
+        {
+            vtkm::Float64 value = static_cast<vtkm::Float64>(Traits::GetComponent(centered, m));
+            variance += value * value;
+            for (vtkm::IdComponent r = 0; r < Rank; r++)
+            {
+                projection[r] += value * basis.Get(m * Rank + r);
+            }
+        }
+        variance = variance / (numMembers - 1);
+
+        vtkm::Float64 captured = 0;
+        for (vtkm::IdComponent r = 0; r < Rank; r++)
+        {
+            coefficients[r] = static_cast<vtkm::FloatDefault>(projection[r]);
+            captured += projection[r] * projection[r];
+        }
+        // the projection can not capture more than the variance, up to rounding
+        residual = static_cast<vtkm::FloatDefault>(vtkm::Max(variance - captured, vtkm::Float64(0)));
+    }
+};
+
+#endif // UCV_PROJECTING_ENSEMBLE_h
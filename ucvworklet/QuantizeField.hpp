@@ -0,0 +1,31 @@
+#ifndef UCV_QUANTIZE_FIELD_h
+#define UCV_QUANTIZE_FIELD_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+// encode a value as the nearest of the levels offset + i * scale, i = 0 ... maxLevel,
+// the values out of the range are clamped to the first or the last level
+// the value is decoded as offset + code * scale
+struct QuantizeField : public vtkm::worklet::WorkletMapField
+{
+    QuantizeField(double offset, double scale, double maxLevel)
+        : m_offset(offset), m_scale(scale), m_maxLevel(maxLevel){};
+
+    using ControlSignature = void(FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2);
+
+    template <typename InType, typename OutType>
+    VTKM_EXEC void operator()(const InType &value, OutType &code) const
+    {
+        double level = (static_cast<double>(value) - m_offset) / m_scale;
+        level = vtkm::Max(0.0, vtkm::Min(m_maxLevel, level));
+        code = static_cast<OutType>(level + 0.5);
+    }
+
+private:
+    double m_offset;
+    double m_scale;
+    double m_maxLevel;
+};
+
+#endif // UCV_QUANTIZE_FIELD_h
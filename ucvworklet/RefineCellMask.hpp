@@ -0,0 +1,58 @@
+#ifndef UCV_REFINE_CELL_MASK_h
+#define UCV_REFINE_CELL_MASK_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+// decide which cells of a fine subsampled grid need to be computed, given the
+// cross probability of the coarser subsampled grid of the previous refinement level
+//
+// the fine grid uses the block size b and the coarse grid uses the block size r*b,
+// so the fine point i groups the raw points [i*b, (i+1)*b) and the fine cell i covers the
+// raw points [i*b, (i+2)*b). The coarse cell floor(i/r) covers all of them, since the min/max
+// of the coarse blocks bounds the min/max of the fine blocks, a fine cell can only contain
+// the contour if its coarse parent has a nonzero cross probability (for the gaussian model
+// this is an approximation, which is controlled by the threshold)
+struct RefineCellMask : public vtkm::worklet::WorkletMapField
+{
+    RefineCellMask(vtkm::Id3 fineCellDims, vtkm::Id3 coarseCellDims, vtkm::Id ratio, double threshold)
+        : m_fineCellDims(fineCellDims), m_coarseCellDims(coarseCellDims), m_ratio(ratio), m_threshold(threshold){};
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename CoarseProbPortalType>
+    VTKM_EXEC void operator()(const vtkm::Id &fineCellId,
+                              const CoarseProbPortalType &coarseCrossProb,
+                              vtkm::UInt8 &active) const
+    {
+        vtkm::Id fineIdx = fineCellId % m_fineCellDims[0];
+        vtkm::Id fineIdy = (fineCellId / m_fineCellDims[0]) % m_fineCellDims[1];
+        vtkm::Id fineIdz = fineCellId / m_fineCellDims[0] / m_fineCellDims[1];
+
+        // the last fine cells may go over the last coarse cell when the
+        // dimension is not divisible, the last coarse cell covers them
+        vtkm::Id coarseIdx = vtkm::Min(fineIdx / m_ratio, m_coarseCellDims[0] - 1);
+        vtkm::Id coarseIdy = vtkm::Min(fineIdy / m_ratio, m_coarseCellDims[1] - 1);
+        vtkm::Id coarseIdz = vtkm::Min(fineIdz / m_ratio, m_coarseCellDims[2] - 1);
+
+        vtkm::Id coarseCellId = coarseIdx + coarseIdy * m_coarseCellDims[0] +
+                                coarseIdz * m_coarseCellDims[0] * m_coarseCellDims[1];
+
+        if (static_cast<vtkm::Float64>(coarseCrossProb.Get(coarseCellId)) > m_threshold)
+        {
+            active = 1;
+        }
+        else
+        {
+            active = 0;
+        }
+    }
+
+private:
+    vtkm::Id3 m_fineCellDims;
+    vtkm::Id3 m_coarseCellDims;
+    vtkm::Id m_ratio;
+    double m_threshold;
+};
+
+#endif // UCV_REFINE_CELL_MASK_h
@@ -0,0 +1,165 @@
+#ifndef UCV_SEPARABLE_GAUSSIAN_SAMPLING_h
+#define UCV_SEPARABLE_GAUSSIAN_SAMPLING_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapTopology.h>
+
+#ifdef VTKM_CUDA
+#include <thrust/random/linear_congruential_engine.h>
+#include <thrust/random/normal_distribution.h>
+#else
+// using the std library
+#include <random>
+#endif // VTKM_CUDA
+
+// a cheaper alternative to MVGaussianWithEnsemble3DTryLialg, the points of a cell have the
+// gaussian marginals given by their mean and stdev, and the correlation between two points is
+// rhoX^|dx| * rhoY^|dy| * rhoZ^|dz|, where rhoX is the mean correlation of the 4 edges of the
+// cell along x (see ExtractingNeighborCorrelation), and so on
+// the correlation matrix is the kronecker product Cz (x) Cy (x) Cx of 2 by 2 matrices, so its
+// cholesky factor is the kronecker product of their 2 by 2 factors and is applied axis by axis,
+// no 8 by 8 matrix is built or factorized
+// the cases and the outputs are the same as MVGaussianWithEnsemble3DSampling
+class SeparableGaussianSampling : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+    SeparableGaussianSampling(double isovalue, int numSamples)
+        : m_isovalue(isovalue), m_numSamples(numSamples){};
+
+    using ControlSignature = void(CellSetIn,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldInPoint,
+                                  FieldOutCell,
+                                  FieldOutCell,
+                                  FieldOutCell);
+
+    using ExecutionSignature = void(_2, _3, _4, _5, _6, _7);
+
+    using InputDomain = _1;
+
+    template <typename InPointFieldMeanType,
+              typename InPointFieldStdevType,
+              typename InPointFieldCorrelationType,
+              typename OutCellFieldType1,
+              typename OutCellFieldType2,
+              typename OutCellFieldType3>
+    VTKM_EXEC void operator()(
+        const InPointFieldMeanType &inPointFieldVecMean,
+        const InPointFieldStdevType &inPointFieldVecStdev,
+        const InPointFieldCorrelationType &inPointFieldVecCorrelation,
+        OutCellFieldType1 &outCellFieldCProb,
+        OutCellFieldType2 &outCellFieldNumNonzeroProb,
+        OutCellFieldType3 &outCellFieldEntropy) const
+    {
+        const vtkm::IdComponent numVertex3d = 8;
+        if (inPointFieldVecMean.GetNumberOfComponents() != numVertex3d)
+        {
+            printf("SeparableGaussianSampling expects 8 vertecies\n");
+            return;
+        }
+
+        // the 4 edges of the hexahedron along each axis, as the point at their lower end
+        // (the correlation of a point is with its next point along the axis)
+        const vtkm::IdComponent lowerX[4] = {0, 3, 4, 7};
+        const vtkm::IdComponent lowerY[4] = {0, 1, 4, 5};
+        const vtkm::IdComponent lowerZ[4] = {0, 1, 2, 3};
+        vtkm::Vec3f rho(0);
+        for (vtkm::IdComponent e = 0; e < 4; e++)
+        {
+            rho[0] += static_cast<vtkm::FloatDefault>(inPointFieldVecCorrelation[lowerX[e]][0]);
+            rho[1] += static_cast<vtkm::FloatDefault>(inPointFieldVecCorrelation[lowerY[e]][1]);
+            rho[2] += static_cast<vtkm::FloatDefault>(inPointFieldVecCorrelation[lowerZ[e]][2]);
+        }
+        // the matrix is not positive definite for a correlation of 1
+        vtkm::Vec3f rhoComplement;
+        for (vtkm::IdComponent d = 0; d < 3; d++)
+        {
+            rho[d] = vtkm::Max(vtkm::Min(rho[d] / 4, vtkm::FloatDefault(0.999)), vtkm::FloatDefault(-0.999));
+            rhoComplement[d] = vtkm::Sqrt(1 - rho[d] * rho[d]);
+        }
+
+        // the pairs of points along each axis, the points 0 to 7 of the vtkm hexahedron are at
+        // (0,0,0) (1,0,0) (1,1,0) (0,1,0) (0,0,1) (1,0,1) (1,1,1) (0,1,1)
+        const vtkm::IdComponent pairs[3][4][2] = {{{0, 1}, {3, 2}, {4, 5}, {7, 6}},
+                                                  {{0, 3}, {1, 2}, {4, 7}, {5, 6}},
+                                                  {{0, 4}, {1, 5}, {2, 6}, {3, 7}}};
+
+        vtkm::Vec<vtkm::FloatDefault, 8> mean;
+        vtkm::Vec<vtkm::FloatDefault, 8> stdev;
+        for (vtkm::IdComponent i = 0; i < numVertex3d; i++)
+        {
+            mean[i] = static_cast<vtkm::FloatDefault>(inPointFieldVecMean[i]);
+            stdev[i] = static_cast<vtkm::FloatDefault>(inPointFieldVecStdev[i]);
+        }
+
+#ifdef VTKM_CUDA
+        thrust::minstd_rand rng;
+        thrust::random::normal_distribution<double> norm;
+#else
+        std::mt19937 rng;
+        rng.seed(std::mt19937::default_seed);
+        std::normal_distribution<double> norm;
+#endif // VTKM_CUDA
+
+        vtkm::Vec<vtkm::FloatDefault, 256> probHistogram(0);
+        vtkm::Vec<vtkm::FloatDefault, 8> sample;
+        for (vtkm::Id n = 0; n < this->m_numSamples; ++n)
+        {
+            for (vtkm::IdComponent i = 0; i < numVertex3d; i++)
+            {
+                sample[i] = static_cast<vtkm::FloatDefault>(norm(rng));
+            }
+
+            // multiply by the 2 by 2 factor [[1, 0], [rho, sqrt(1 - rho^2)]] along each axis
+            for (vtkm::IdComponent d = 0; d < 3; d++)
+            {
+                for (vtkm::IdComponent e = 0; e < 4; e++)
+                {
+                    vtkm::IdComponent lower = pairs[d][e][0];
+                    vtkm::IdComponent upper = pairs[d][e][1];
+                    sample[upper] = rho[d] * sample[lower] + rhoComplement[d] * sample[upper];
+                }
+            }
+
+            // setting associated position to 1 if iso larger then specific cases
+            vtkm::UInt32 caseValue = 0;
+            for (vtkm::IdComponent i = 0; i < numVertex3d; i++)
+            {
+                if (m_isovalue >= mean[i] + stdev[i] * sample[i])
+                {
+                    caseValue = (1 << i) | caseValue;
+                }
+            }
+            probHistogram[caseValue] = probHistogram[caseValue] + 1.0;
+        }
+
+        for (int i = 0; i < 256; i++)
+        {
+            probHistogram[i] = (probHistogram[i] / (1.0 * this->m_numSamples));
+        }
+
+        // cross probability
+        outCellFieldCProb = 1.0 - (probHistogram[0] + probHistogram[255]);
+
+        vtkm::Id nonzeroCases = 0;
+        vtkm::FloatDefault entropyValue = 0;
+        for (int i = 0; i < 256; i++)
+        {
+            if (probHistogram[i] > 0.0001)
+            {
+                nonzeroCases++;
+                entropyValue = entropyValue - probHistogram[i] * vtkm::Log2(probHistogram[i]);
+            }
+        }
+
+        outCellFieldNumNonzeroProb = nonzeroCases;
+        outCellFieldEntropy = entropyValue;
+    }
+
+private:
+    double m_isovalue;
+    int m_numSamples;
+};
+
+#endif // UCV_SEPARABLE_GAUSSIAN_SAMPLING_h
@@ -0,0 +1,62 @@
+#ifndef UCV_UNCERTAIN_POINT_COST_h
+#define UCV_UNCERTAIN_POINT_COST_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+// cheap per point estimation of how expensive the uncertainty worklets are
+// for a given ensemble, this is used to balance the work between ranks
+// before running the expensive multivariant gaussian sampling
+//
+// the cost is 0 for the points that are trimmed by the worklet (all members are 0),
+// 1 for other points and 1 + m_uncertainWeight for the points whose mean is within
+// m_numStdev standard deviations of the isovalue, since the cells around them are
+// the ones that have nonzero cross probability
+struct UncertainPointCost : public vtkm::worklet::WorkletMapField
+{
+    UncertainPointCost(double isovalue, double numStdev, double uncertainWeight)
+        : m_isovalue(isovalue), m_numStdev(numStdev), m_uncertainWeight(uncertainWeight){};
+
+    using ControlSignature = void(FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2);
+
+    template <typename EnsembleType>
+    VTKM_EXEC void operator()(const EnsembleType &ensemble, vtkm::FloatDefault &cost) const
+    {
+        vtkm::IdComponent numMembers = ensemble.GetNumberOfComponents();
+
+        vtkm::Float64 mean = 0;
+        for (vtkm::IdComponent i = 0; i < numMembers; i++)
+        {
+            mean = mean + static_cast<vtkm::Float64>(ensemble[i]);
+        }
+        mean = mean / numMembers;
+
+        // use the same trim condition with the MVGaussianWithEnsemble2DTryLialgEntropy
+        if (vtkm::Abs(mean) < 0.000001)
+        {
+            cost = 0;
+            return;
+        }
+
+        vtkm::Float64 var = 0;
+        for (vtkm::IdComponent i = 0; i < numMembers; i++)
+        {
+            vtkm::Float64 diff = static_cast<vtkm::Float64>(ensemble[i]) - mean;
+            var = var + diff * diff;
+        }
+        vtkm::Float64 stdev = vtkm::Sqrt(var / numMembers);
+
+        cost = 1.0;
+        if (vtkm::Abs(m_isovalue - mean) < m_numStdev * stdev)
+        {
+            cost = cost + m_uncertainWeight;
+        }
+    }
+
+private:
+    double m_isovalue;
+    double m_numStdev;
+    double m_uncertainWeight;
+};
+
+#endif // UCV_UNCERTAIN_POINT_COST_h
@@ -0,0 +1,45 @@
+#ifndef UCV_UNIFORM_POINT_PROBABILITY_h
+#define UCV_UNIFORM_POINT_PROBABILITY_h
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include "EntropyFromPointProbability.hpp"
+
+// compute Pr[X<=iso] for each point with the uniform distribution between its min and max,
+// once per point, the cells gather them with EntropyFromPointProbability
+// the output can be a FloatDefault array or a UInt8 array (see EncodePointProbability)
+struct UniformPointProbability : public vtkm::worklet::WorkletMapField
+{
+    UniformPointProbability(double isovalue)
+        : m_isovalue(isovalue){};
+
+    using ControlSignature = void(FieldIn, FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename MinType, typename MaxType, typename OutProbType>
+    VTKM_EXEC void operator()(const MinType &minValue, const MaxType &maxValue, OutProbType &negativeProb) const
+    {
+        // the same cases as EntropyUniform
+        vtkm::FloatDefault minV = static_cast<vtkm::FloatDefault>(minValue);
+        vtkm::FloatDefault maxV = static_cast<vtkm::FloatDefault>(maxValue);
+        vtkm::FloatDefault prob;
+        if (this->m_isovalue <= minV)
+        {
+            prob = 0.0;
+        }
+        else if (this->m_isovalue >= maxV)
+        {
+            prob = 1.0;
+        }
+        else
+        {
+            prob = 1.0 - (maxV - this->m_isovalue) / (maxV - minV);
+        }
+        EncodePointProbability(prob, negativeProb);
+    }
+
+private:
+    double m_isovalue;
+};
+
+#endif // UCV_UNIFORM_POINT_PROBABILITY_h
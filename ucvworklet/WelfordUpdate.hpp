@@ -0,0 +1,128 @@
+#ifndef UCV_WELFORD_UPDATE_h
+#define UCV_WELFORD_UPDATE_h
+
+#include <vtkm/Math.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+// the worklets of EnsembleAccumulator, the ensemble members are added one at a time and each
+// point keeps the mean and the sum of the squared offsets to the mean (M2) of its values,
+// see Welford 1962, the count is the same for all the points and is given to the worklets
+
+// add one member, count is the number of members including this one
+struct WelfordUpdate : public vtkm::worklet::WorkletMapField
+{
+    WelfordUpdate(vtkm::Id count)
+        : m_count(count){};
+
+    using ControlSignature = void(FieldIn, FieldInOut, FieldInOut);
+    using ExecutionSignature = void(_1, _2, _3);
+
+    template <typename ValueType>
+    VTKM_EXEC void operator()(const ValueType &value, vtkm::FloatDefault &mean, vtkm::FloatDefault &m2) const
+    {
+        vtkm::FloatDefault x = static_cast<vtkm::FloatDefault>(value);
+        vtkm::FloatDefault delta = x - mean;
+        mean += delta / this->m_count;
+        m2 += delta * (x - mean);
+    }
+
+private:
+    vtkm::Id m_count;
+};
+
+// the co-moments of each point with its next point along x, y and z, it must run before
+// WelfordUpdate because it uses the means of the previous members
+// C += (n - 1) / n * (x - mean_x) * (y - mean_y)
+struct WelfordCoMomentUpdate : public vtkm::worklet::WorkletMapField
+{
+    WelfordCoMomentUpdate(vtkm::Id3 pointDims, vtkm::Id count)
+        : m_pointDims(pointDims), m_count(count){};
+
+    using ControlSignature = void(FieldIn, WholeArrayIn, WholeArrayIn, FieldInOut);
+    using ExecutionSignature = void(_1, _2, _3, _4);
+
+    template <typename ValuesPortalType, typename MeanPortalType>
+    VTKM_EXEC void operator()(const vtkm::Id &pointId,
+                              const ValuesPortalType &values,
+                              const MeanPortalType &mean,
+                              vtkm::Vec3f &coMoment) const
+    {
+        vtkm::Id3 ijk(pointId % m_pointDims[0],
+                      (pointId / m_pointDims[0]) % m_pointDims[1],
+                      pointId / (m_pointDims[0] * m_pointDims[1]));
+        vtkm::Id3 stride(1, m_pointDims[0], m_pointDims[0] * m_pointDims[1]);
+        vtkm::FloatDefault scale = static_cast<vtkm::FloatDefault>(this->m_count - 1) / this->m_count;
+        vtkm::FloatDefault offset = static_cast<vtkm::FloatDefault>(values.Get(pointId)) - mean.Get(pointId);
+        for (vtkm::IdComponent d = 0; d < 3; d++)
+        {
+            if (ijk[d] + 1 < m_pointDims[d])
+            {
+                vtkm::Id next = pointId + stride[d];
+                vtkm::FloatDefault nextOffset = static_cast<vtkm::FloatDefault>(values.Get(next)) - mean.Get(next);
+                coMoment[d] += scale * offset * nextOffset;
+            }
+        }
+    }
+
+private:
+    vtkm::Id3 m_pointDims;
+    vtkm::Id m_count;
+};
+
+// the standard deviation of the members, like ExtractingMeanStdev it divides by the count
+struct WelfordStdev : public vtkm::worklet::WorkletMapField
+{
+    WelfordStdev(vtkm::Id count)
+        : m_count(count){};
+
+    using ControlSignature = void(FieldIn, FieldOut);
+    using ExecutionSignature = void(_1, _2);
+
+    VTKM_EXEC void operator()(const vtkm::FloatDefault &m2, vtkm::FloatDefault &stdev) const
+    {
+        stdev = vtkm::Sqrt(m2 / this->m_count);
+    }
+
+private:
+    vtkm::Id m_count;
+};
+
+// the correlation of each point with its next point along x, y and z from the co-moments,
+// like ExtractingNeighborCorrelation it is 0 without a next point or without variance
+struct WelfordCorrelation : public vtkm::worklet::WorkletMapField
+{
+    WelfordCorrelation(vtkm::Id3 pointDims)
+        : m_pointDims(pointDims){};
+
+    using ControlSignature = void(FieldIn, FieldIn, WholeArrayIn, FieldOut);
+    using ExecutionSignature = void(_1, _2, _3, _4);
+
+    template <typename M2PortalType>
+    VTKM_EXEC void operator()(const vtkm::Id &pointId,
+                              const vtkm::Vec3f &coMoment,
+                              const M2PortalType &m2,
+                              vtkm::Vec3f &correlation) const
+    {
+        vtkm::Id3 ijk(pointId % m_pointDims[0],
+                      (pointId / m_pointDims[0]) % m_pointDims[1],
+                      pointId / (m_pointDims[0] * m_pointDims[1]));
+        vtkm::Id3 stride(1, m_pointDims[0], m_pointDims[0] * m_pointDims[1]);
+        for (vtkm::IdComponent d = 0; d < 3; d++)
+        {
+            correlation[d] = 0;
+            if (ijk[d] + 1 < m_pointDims[d])
+            {
+                vtkm::FloatDefault variances = m2.Get(pointId) * m2.Get(pointId + stride[d]);
+                if (variances > 0)
+                {
+                    correlation[d] = coMoment[d] / vtkm::Sqrt(variances);
+                }
+            }
+        }
+    }
+
+private:
+    vtkm::Id3 m_pointDims;
+};
+
+#endif // UCV_WELFORD_UPDATE_h
@@ -0,0 +1,97 @@
+#ifndef UCV_SYMMETRIC_EIGEN_h
+#define UCV_SYMMETRIC_EIGEN_h
+
+#include <vtkm/Types.h>
+
+#include <cmath>
+#include <vector>
+
+namespace UCVMATH
+{
+    // Eigenvalues and eigenvectors of a symmetric matrix (row major) with the cyclic Jacobi
+    // method, on the host. EnsemblePCA solves the gram matrix of the members with it, which is
+    // only as large as the number of members.
+    // The eigenvector of the eigenvalue i is the column i of the vectors.
+    inline void SymmetricEigen(std::vector<vtkm::Float64> matrix,
+                               vtkm::IdComponent size,
+                               std::vector<vtkm::Float64> &values,
+                               std::vector<vtkm::Float64> &vectors)
+    {
+        auto at = [size](std::vector<vtkm::Float64>& m, vtkm::IdComponent row, vtkm::IdComponent col)
+            -> vtkm::Float64& { return m[row * size + col]; };
+
+        vectors.assign(size * size, 0.0);
+        for (vtkm::IdComponent i = 0; i < size; i++)
+        {
+            at(vectors, i, i) = 1.0;
+        }
+
+        vtkm::Float64 norm = 0;
+        for (vtkm::Float64 value : matrix)
+        {
+            norm += value * value;
+        }
+
+        for (int sweep = 0; sweep < 100; sweep++)
+        {
+            vtkm::Float64 offDiagonal = 0;
+            for (vtkm::IdComponent p = 0; p < size; p++)
+            {
+                for (vtkm::IdComponent q = p + 1; q < size; q++)
+                {
+                    offDiagonal += at(matrix, p, q) * at(matrix, p, q);
+                }
+            }
+            if (offDiagonal <= 1e-24 * norm)
+            {
+                break;
+            }
+
+            for (vtkm::IdComponent p = 0; p < size; p++)
+            {
+                for (vtkm::IdComponent q = p + 1; q < size; q++)
+                {
+                    vtkm::Float64 apq = at(matrix, p, q);
+                    if (apq == 0)
+                    {
+                        continue;
+                    }
+                    // The rotation that zeroes the entry (p, q).
+                    vtkm::Float64 theta = (at(matrix, q, q) - at(matrix, p, p)) / (2 * apq);
+                    vtkm::Float64 t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                    vtkm::Float64 c = 1 / std::sqrt(t * t + 1);
+                    vtkm::Float64 s = t * c;
+                    for (vtkm::IdComponent k = 0; k < size; k++)
+                    {
+                        vtkm::Float64 akp = at(matrix, k, p);
+                        vtkm::Float64 akq = at(matrix, k, q);
+                        at(matrix, k, p) = c * akp - s * akq;
+                        at(matrix, k, q) = s * akp + c * akq;
+                    }
+                    for (vtkm::IdComponent k = 0; k < size; k++)
+                    {
+                        vtkm::Float64 apk = at(matrix, p, k);
+                        vtkm::Float64 aqk = at(matrix, q, k);
+                        at(matrix, p, k) = c * apk - s * aqk;
+                        at(matrix, q, k) = s * apk + c * aqk;
+                    }
+                    for (vtkm::IdComponent k = 0; k < size; k++)
+                    {
+                        vtkm::Float64 vkp = at(vectors, k, p);
+                        vtkm::Float64 vkq = at(vectors, k, q);
+                        at(vectors, k, p) = c * vkp - s * vkq;
+                        at(vectors, k, q) = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+
+        values.resize(size);
+        for (vtkm::IdComponent i = 0; i < size; i++)
+        {
+            values[i] = at(matrix, i, i);
+        }
+    }
+} // namespace UCVMATH
+
+#endif // UCV_SYMMETRIC_EIGEN_h
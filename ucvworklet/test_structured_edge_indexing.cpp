@@ -0,0 +1,81 @@
+#include "./EdgeCrossing.hpp"
+#include <assert.h>
+#include <stdio.h>
+#include <vector>
+
+// checks that EdgeId and EdgePoints of StructuredEdgeIndexing are exact inverses:
+// every edge of the grid gets a distinct id in [0, GetNumberOfEdges()), the points of that id
+// are the two ends of the edge, and every id maps back to itself
+
+void test_edge_indexing(vtkm::Id3 pointDims)
+{
+    printf("--test_edge_indexing %lld %lld %lld\n",
+           static_cast<long long>(pointDims[0]),
+           static_cast<long long>(pointDims[1]),
+           static_cast<long long>(pointDims[2]));
+
+    StructuredEdgeIndexing indexing(pointDims);
+    vtkm::Id numEdges = indexing.GetNumberOfEdges();
+    vtkm::Id expected = (pointDims[0] - 1) * pointDims[1] * pointDims[2] +
+                        pointDims[0] * (pointDims[1] - 1) * pointDims[2] +
+                        pointDims[0] * pointDims[1] * (pointDims[2] - 1);
+    assert(numEdges == expected);
+
+    vtkm::Id3 strides{1, pointDims[0], pointDims[0] * pointDims[1]};
+    std::vector<int> visited(numEdges, 0);
+
+    // point and direction -> id -> points
+    for (vtkm::Id k = 0; k < pointDims[2]; k++)
+    {
+        for (vtkm::Id j = 0; j < pointDims[1]; j++)
+        {
+            for (vtkm::Id i = 0; i < pointDims[0]; i++)
+            {
+                vtkm::Id3 ijk{i, j, k};
+                vtkm::Id point = i + j * strides[1] + k * strides[2];
+                for (vtkm::IdComponent direction = 0; direction < 3; direction++)
+                {
+                    if (ijk[direction] + 1 >= pointDims[direction])
+                    {
+                        continue;
+                    }
+                    vtkm::Id edgeId = indexing.EdgeId(i, j, k, direction);
+                    assert(edgeId >= 0 && edgeId < numEdges);
+                    assert(visited[edgeId] == 0);
+                    visited[edgeId] = 1;
+
+                    vtkm::Id2 points = indexing.EdgePoints(edgeId);
+                    assert(points[0] == point);
+                    assert(points[1] == point + strides[direction]);
+                }
+            }
+        }
+    }
+
+    // id -> points -> point and direction -> id
+    for (vtkm::Id edgeId = 0; edgeId < numEdges; edgeId++)
+    {
+        assert(visited[edgeId] == 1);
+
+        vtkm::Id2 points = indexing.EdgePoints(edgeId);
+        vtkm::Id step = points[1] - points[0];
+        vtkm::IdComponent direction = step == strides[0] ? 0 : (step == strides[1] ? 1 : 2);
+        assert(step == strides[direction]);
+
+        vtkm::Id i = points[0] % pointDims[0];
+        vtkm::Id j = (points[0] / pointDims[0]) % pointDims[1];
+        vtkm::Id k = points[0] / (pointDims[0] * pointDims[1]);
+        assert(indexing.EdgeId(i, j, k, direction) == edgeId);
+    }
+}
+
+int main()
+{
+    // 2D grids have no edges along z
+    test_edge_indexing(vtkm::Id3(5, 4, 1));
+    test_edge_indexing(vtkm::Id3(2, 7, 1));
+    // 3D grids, with unequal dimensions so a swapped axis shows up
+    test_edge_indexing(vtkm::Id3(4, 3, 5));
+    test_edge_indexing(vtkm::Id3(2, 2, 2));
+    return 0;
+}